@@ -0,0 +1,53 @@
+# FSMConfigCodegen.cmake
+# Generate statically dispatched state machines from YAML configurations
+#
+# fsmconfig_generate(<target> <config.yaml>
+#                    [NAMESPACE <namespace>]
+#                    [HEADER <file name>])
+#
+# Runs fsmconfig_codegen at build time and adds the generated header to <target>.
+# The header is written to ${CMAKE_CURRENT_BINARY_DIR}/fsmconfig_generated, which is
+# added to the target's include directories. By default the namespace is the config
+# file name without extension and the header is named <name>_fsm.hpp.
+
+function(fsmconfig_generate target config)
+    cmake_parse_arguments(ARG "" "NAMESPACE;HEADER" "" ${ARGN})
+
+    get_filename_component(config_path "${config}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+    get_filename_component(config_name "${config}" NAME_WE)
+
+    if(NOT ARG_NAMESPACE)
+        set(ARG_NAMESPACE "${config_name}")
+    endif()
+    if(NOT ARG_HEADER)
+        set(ARG_HEADER "${config_name}_fsm.hpp")
+    endif()
+
+    if(TARGET fsmconfig::fsmconfig_codegen)
+        set(codegen fsmconfig::fsmconfig_codegen)
+    elseif(TARGET fsmconfig_codegen)
+        set(codegen fsmconfig_codegen)
+    else()
+        # Packages installed with BUILD_TOOLS=OFF: use a tool found on the search path
+        find_program(FSMCONFIG_CODEGEN_EXECUTABLE fsmconfig_codegen)
+        if(NOT FSMCONFIG_CODEGEN_EXECUTABLE)
+            message(FATAL_ERROR "fsmconfig_generate: fsmconfig_codegen tool is not available")
+        endif()
+        set(codegen "${FSMCONFIG_CODEGEN_EXECUTABLE}")
+    endif()
+
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/fsmconfig_generated")
+    set(output "${output_dir}/${ARG_HEADER}")
+
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+        COMMAND ${codegen} "${config_path}" "${output}" --namespace "${ARG_NAMESPACE}"
+        DEPENDS "${config_path}" ${codegen}
+        COMMENT "Generating ${ARG_HEADER} from ${config}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${output}")
+    target_include_directories(${target} PRIVATE "${output_dir}")
+endfunction()
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <cstddef>
-#include <functional>
+#include <cstdint>
 #include <memory>
 #include <string>
 
+#include "delegate.hpp"
 #include "types.hpp"
 
 namespace fsmconfig {
@@ -17,22 +18,22 @@ namespace fsmconfig {
 /**
  * @brief State callback type (on_enter, on_exit)
  */
-using StateCallback = std::function<void()>;
+using StateCallback = Delegate<void()>;
 
 /**
  * @brief Transition callback type
  */
-using TransitionCallback = std::function<void(const TransitionEvent&)>;
+using TransitionCallback = Delegate<void(const TransitionEvent&)>;
 
 /**
  * @brief Guard callback type (returns bool)
  */
-using GuardCallback = std::function<bool()>;
+using GuardCallback = Delegate<bool()>;
 
 /**
  * @brief Action callback type
  */
-using ActionCallback = std::function<void()>;
+using ActionCallback = Delegate<void()>;
 
 /**
  * @class CallbackRegistry
@@ -172,6 +173,56 @@ class CallbackRegistry {
    */
   [[nodiscard]] bool hasAction(const std::string& action_name) const;
 
+  // Resolution for repeated invocation without lookups. A resolved callback
+  // stays valid after it is re-registered or the registry is cleared;
+  // getGeneration() tells when it may be outdated.
+
+  /**
+   * @brief Resolve state callback
+   * @param state_name State name
+   * @param callback_type Callback type
+   * @return Registered callback or nullptr if none is registered
+   */
+  [[nodiscard]] std::shared_ptr<const StateCallback> resolveStateCallback(const std::string& state_name,
+                                                                          const std::string& callback_type) const;
+
+  /**
+   * @brief Resolve transition callback
+   * @param from_state Source state
+   * @param to_state Target state
+   * @return Registered callback or nullptr if none is registered
+   */
+  [[nodiscard]] std::shared_ptr<const TransitionCallback> resolveTransitionCallback(const std::string& from_state,
+                                                                                    const std::string& to_state) const;
+
+  /**
+   * @brief Resolve guard callback
+   * @param from_state Source state
+   * @param to_state Target state
+   * @param event_name Event name
+   * @return Registered callback or nullptr if none is registered
+   */
+  [[nodiscard]] std::shared_ptr<const GuardCallback> resolveGuard(const std::string& from_state,
+                                                                  const std::string& to_state,
+                                                                  const std::string& event_name) const;
+
+  /**
+   * @brief Resolve action callback
+   * @param action_name Action name
+   * @return Registered callback or nullptr if the action is not registered
+   */
+  [[nodiscard]] std::shared_ptr<const ActionCallback> resolveAction(const std::string& action_name) const;
+
+  /**
+   * @brief Get registration generation
+   *
+   * The value changes whenever a callback is registered or the registry is
+   * cleared, so callbacks resolved earlier can be cached until it moves.
+   *
+   * @return Current generation
+   */
+  [[nodiscard]] uint64_t getGeneration() const;
+
   /**
    * @brief Clear all callbacks
    */
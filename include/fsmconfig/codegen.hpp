@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+
+#include "types.hpp"
+
+namespace fsmconfig {
+
+class ConfigParser;
+
+/**
+ * @file codegen.hpp
+ * @brief Generation of compile-time C++ state machines from YAML configuration
+ */
+
+/**
+ * @brief Options for static state machine generation
+ */
+struct CodegenOptions {
+  std::string namespace_name = "fsm";  ///< Namespace of generated code (nested namespaces with "::")
+  std::string source_name;             ///< Configuration name recorded in the header comment
+};
+
+/**
+ * @brief Generate a header with a statically dispatched state machine
+ *
+ * The generated header contains:
+ * - `enum class State` and `enum class Event`
+ * - `constexpr` state/event name tables and transition table
+ * - `Machine<Handler>` whose `dispatch()` is a switch over state and event that
+ *   calls guard, on_exit, action, on_transition and on_enter hooks as plain member
+ *   functions of Handler, in the same order as StateMachine
+ * - a `constexpr` `timeouts` table of the `after` transitions with their duration,
+ *   taken with `Machine::expire(index)` by whatever timer the application runs;
+ *   those that also declare `event` are dispatched by that event as well
+ *
+ * Guards are `bool name()`, all other hooks are `void name()`. A hook referenced in
+ * the configuration but missing from Handler is a compile error.
+ *
+ * @param parser Parser with loaded configuration
+ * @param options Generation options
+ * @return Header source code
+ * @throws ConfigException if configuration has no states, or names cannot be mapped
+ *         to unique C++ identifiers
+ */
+[[nodiscard]] std::string generateStaticMachine(const ConfigParser& parser, const CodegenOptions& options);
+
+}  // namespace fsmconfig
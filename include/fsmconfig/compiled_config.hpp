@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "types.hpp"
+
+namespace fsmconfig {
+
+/**
+ * @file compiled_config.hpp
+ * @brief Compact, arena-backed representation of a parsed configuration
+ */
+
+/// Index into the interned string table of a CompiledConfig
+using StringId = uint32_t;
+
+/// Index of a state in CompiledConfig::states()
+using StateId = uint32_t;
+
+/// Index of an event in CompiledConfig (events are numbered in order of first use)
+using EventId = uint32_t;
+
+/// Marker for an absent string, state or event
+inline constexpr uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Variable stored in a compiled configuration
+ *
+ * Trivially destructible counterpart of VariableValue: string values are
+ * interned, so the record lives in the arena without owning memory.
+ */
+struct CompiledVariable {
+  StringId name = INVALID_ID;             ///< Variable name
+  VariableType type = VariableType::INT;  ///< Value type
+  union {
+    int int_value = 0;      ///< Value for INT
+    float float_value;      ///< Value for FLOAT
+    bool bool_value;        ///< Value for BOOL
+    StringId string_value;  ///< Interned value for STRING
+  };
+};
+
+/**
+ * @brief State record of a compiled configuration
+ */
+struct CompiledState {
+  StringId name = INVALID_ID;                   ///< State name
+  StringId on_enter = INVALID_ID;               ///< On-enter callback (INVALID_ID if none)
+  StringId on_exit = INVALID_ID;                ///< On-exit callback (INVALID_ID if none)
+  std::span<const StringId> actions;            ///< Action names in declaration order
+  std::span<const CompiledVariable> variables;  ///< State variables sorted by name
+};
+
+/**
+ * @brief Transition record of a compiled configuration
+ */
+struct CompiledTransition {
+  StateId from = INVALID_ID;            ///< Source state
+  StateId to = INVALID_ID;              ///< Target state
+  EventId event = INVALID_ID;           ///< Event
+  StringId guard = INVALID_ID;          ///< Guard callback (INVALID_ID if none)
+  StringId on_transition = INVALID_ID;  ///< Transition callback (INVALID_ID if none)
+  uint64_t after_ms = 0;                ///< Timeout in milliseconds after entering 'from' (0 if none)
+  std::span<const StringId> actions;    ///< Action names in declaration order
+};
+
+/**
+ * @brief Coalescing rule of an event (`events` section)
+ */
+struct CompiledCoalescing {
+  StringId event = INVALID_ID;  ///< Event name
+  StringId key = INVALID_ID;    ///< Event data field telling pending instances apart (INVALID_ID if name only)
+};
+
+/**
+ * @class CompiledConfig
+ * @brief Immutable configuration model stored in a single monotonic arena
+ *
+ * CompiledConfig provides:
+ * - One string table holding every name exactly once; records refer to it by StringId
+ * - Dense state and event numbering for table-driven lookups
+ * - Transition lookup by (StateId, EventId) through a per-state sorted index
+ * - Name lookup by binary search, without allocating
+ *
+ * All records are trivially destructible and allocated from one arena sized
+ * exactly at the end of loading, so a configuration costs a handful of
+ * allocations regardless of its size. Instances are built by ConfigParser and
+ * never change afterwards, so they can be read concurrently.
+ */
+class CompiledConfig {
+ public:
+  class Builder;
+
+  /**
+   * @brief Constructor of an empty configuration
+   */
+  CompiledConfig();
+
+  /**
+   * @brief Destructor
+   */
+  ~CompiledConfig();
+
+  // Copy and move prohibition (records point into the owned arena)
+  CompiledConfig(const CompiledConfig&) = delete;
+  CompiledConfig& operator=(const CompiledConfig&) = delete;
+  CompiledConfig(CompiledConfig&&) = delete;
+  CompiledConfig& operator=(CompiledConfig&&) = delete;
+
+  // String table
+
+  /**
+   * @brief Get interned string
+   * @param id String identifier
+   * @return View into the string table (empty for INVALID_ID)
+   */
+  [[nodiscard]] std::string_view str(StringId id) const;
+
+  /**
+   * @brief Get number of interned strings
+   * @return String count
+   */
+  [[nodiscard]] size_t stringCount() const;
+
+  // States
+
+  /**
+   * @brief Get all states in declaration order
+   * @return Span of state records indexed by StateId
+   */
+  [[nodiscard]] std::span<const CompiledState> states() const;
+
+  /**
+   * @brief Get state name
+   * @param state State identifier
+   * @return State name
+   */
+  [[nodiscard]] std::string_view stateName(StateId state) const;
+
+  /**
+   * @brief Find state by name
+   * @param name State name
+   * @return State identifier or INVALID_ID
+   */
+  [[nodiscard]] StateId findState(std::string_view name) const;
+
+  /**
+   * @brief Get initial state
+   * @return Initial state identifier, INVALID_ID if unset or not a declared state
+   */
+  [[nodiscard]] StateId initialState() const;
+
+  /**
+   * @brief Get initial state name
+   * @return Explicit `initial_state`, else the first declared state, else empty
+   */
+  [[nodiscard]] std::string_view initialStateName() const;
+
+  // Events
+
+  /**
+   * @brief Get number of distinct events
+   * @return Event count
+   */
+  [[nodiscard]] size_t eventCount() const;
+
+  /**
+   * @brief Get event name
+   * @param event Event identifier
+   * @return Event name
+   */
+  [[nodiscard]] std::string_view eventName(EventId event) const;
+
+  /**
+   * @brief Find event by name
+   * @param name Event name
+   * @return Event identifier or INVALID_ID
+   */
+  [[nodiscard]] EventId findEvent(std::string_view name) const;
+
+  /**
+   * @brief Get events declared with `coalesce: true`
+   * @return Coalescing rules in declaration order
+   */
+  [[nodiscard]] std::span<const CompiledCoalescing> coalescedEvents() const;
+
+  // Transitions
+
+  /**
+   * @brief Get all transitions in declaration order
+   * @return Span of transition records
+   */
+  [[nodiscard]] std::span<const CompiledTransition> transitions() const;
+
+  /**
+   * @brief Get indices of transitions leaving a state
+   * @param state Source state identifier
+   * @return Indices into transitions(), ordered by event
+   */
+  [[nodiscard]] std::span<const uint32_t> transitionsFrom(StateId state) const;
+
+  /**
+   * @brief Find transition by source state and event
+   * @param from Source state identifier
+   * @param event Event identifier
+   * @return Pointer to the first declared matching transition or nullptr
+   */
+  [[nodiscard]] const CompiledTransition* findTransition(StateId from, EventId event) const;
+
+  // Variables
+
+  /**
+   * @brief Get global variables
+   * @return Span of global variables sorted by name
+   */
+  [[nodiscard]] std::span<const CompiledVariable> globalVariables() const;
+
+  /**
+   * @brief Convert compiled variable to VariableValue
+   * @param variable Compiled variable of this configuration
+   * @return Variable value
+   */
+  [[nodiscard]] VariableValue value(const CompiledVariable& variable) const;
+
+  // Memory
+
+  /**
+   * @brief Get bytes allocated from the arena
+   * @return Arena usage in bytes
+   */
+  [[nodiscard]] size_t arenaBytes() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fsmconfig
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "compiled_config.hpp"
 #include "types.hpp"
 
 // Forward declaration for yaml-cpp
@@ -28,6 +31,14 @@ namespace fsmconfig {
  * - Parsing state and transition configurations
  * - Validation of configuration structure
  * - Access to loaded data through a convenient interface
+ *
+ * Loaded data is stored as a CompiledConfig (see getCompiledConfig()). The
+ * std::map/std::vector views returned by getStates(), getTransitions() and
+ * getGlobalVariables() are built from it on first use.
+ *
+ * With a cache directory set (see setCacheDirectory()), compiled configurations
+ * are stored there as binary images keyed by the YAML content hash and library
+ * version, and later loads of the same content skip YAML parsing.
  */
 class ConfigParser {
  public:
@@ -51,6 +62,10 @@ class ConfigParser {
 
   /**
    * @brief Load configuration from file
+   *
+   * The file is read into a buffer that is reused by later loads, so a file
+   * rewritten while it is loaded yields a parse error rather than a fault.
+   *
    * @param file_path Path to YAML configuration file
    * @throws ConfigException on load or parse errors
    */
@@ -63,6 +78,42 @@ class ConfigParser {
    */
   void loadFromString(const std::string& yaml_content);
 
+  /**
+   * @brief Load configuration from memory
+   *
+   * The buffer is parsed in place and only needs to stay valid during the
+   * call, so configurations embedded in the binary or held in shared memory
+   * load without copies.
+   *
+   * @param yaml_content YAML content
+   * @throws ConfigException on parse errors
+   */
+  void loadFromBuffer(std::string_view yaml_content);
+
+  /**
+   * @brief Set directory for cached compiled configurations
+   *
+   * A load whose YAML content has a valid image in the directory uses it instead
+   * of parsing. Otherwise the YAML is parsed and, once validated, an image is
+   * written atomically for the next load. The directory is created on demand;
+   * failures to read or write images only disable the cache for that load.
+   *
+   * @param directory Cache directory (empty string disables caching)
+   */
+  void setCacheDirectory(const std::string& directory);
+
+  /**
+   * @brief Get cache directory
+   * @return Cache directory or empty string if caching is disabled
+   */
+  [[nodiscard]] std::string getCacheDirectory() const;
+
+  /**
+   * @brief Get compiled configuration
+   * @return Reference to the arena-backed configuration model
+   */
+  [[nodiscard]] const CompiledConfig& getCompiledConfig() const;
+
   /**
    * @brief Get global variables
    * @return Reference to global variables map
@@ -129,14 +180,18 @@ class ConfigParser {
 
   // Helper methods for parsing
   [[nodiscard]] VariableValue parseVariable(const YAML::Node& node) const;
-  [[nodiscard]] StateInfo parseState(const std::string& name, const YAML::Node& node) const;
-  [[nodiscard]] TransitionInfo parseTransition(const YAML::Node& node) const;
-  void validateConfig() const;
+  void parseState(CompiledConfig::Builder& builder, const std::string& name, const YAML::Node& node) const;
+  void parseTransition(CompiledConfig::Builder& builder, const YAML::Node& node) const;
+  void parseEvent(CompiledConfig::Builder& builder, const std::string& name, const YAML::Node& node) const;
 
   // Private methods for parsing sections
-  void parseGlobalVariables(const YAML::Node& node);
-  void parseStates(const YAML::Node& node);
-  void parseTransitions(const YAML::Node& node);
+  void loadDocument(const YAML::Node& root);
+  void loadStream(std::istream& input);
+  void loadThroughCache(std::string_view yaml_content);
+  void parseGlobalVariables(CompiledConfig::Builder& builder, const YAML::Node& node);
+  void parseStates(CompiledConfig::Builder& builder, const YAML::Node& node);
+  void parseTransitions(CompiledConfig::Builder& builder, const YAML::Node& node);
+  void parseEvents(CompiledConfig::Builder& builder, const YAML::Node& node);
 };
 
 }  // namespace fsmconfig
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "types.hpp"
+
+namespace fsmconfig {
+
+// Forward declarations
+class MachineDefinition;
+class StateMachine;
+
+/**
+ * @file config_watcher.hpp
+ * @brief Background watcher reloading a configuration file on change
+ */
+
+/**
+ * @brief Handler receiving each successfully loaded definition
+ *
+ * Called on the watcher thread.
+ */
+using DefinitionHandler = std::function<void(std::shared_ptr<const MachineDefinition>)>;
+
+/**
+ * @brief ConfigWatcher settings
+ */
+struct ConfigWatcherOptions {
+  /// Quiet period after the last change before the file is reloaded
+  std::chrono::milliseconds debounce{100};
+
+  /// Check interval for platforms without inotify
+  std::chrono::milliseconds poll_interval{500};
+};
+
+/**
+ * @class ConfigWatcher
+ * @brief Opt-in automatic reload of a YAML configuration file
+ *
+ * ConfigWatcher provides:
+ * - Change detection with inotify on Linux (modification time polling elsewhere)
+ * - Debouncing of write bursts, including editors that save by rename
+ * - Loading and validation on a dedicated background thread
+ * - Delivery of valid definitions to a handler or to StateMachine::scheduleDefinition()
+ *
+ * The directory containing the file is watched, so the file may be replaced or
+ * recreated. Rejected reloads (I/O, parse or validation errors) are reported
+ * through the error handler and the previous definition stays in use. No work
+ * is done on the threads processing events.
+ */
+class ConfigWatcher {
+ public:
+  /**
+   * @brief Constructor with definition handler
+   * @param config_path Path to YAML configuration file
+   * @param on_reload Handler called on the watcher thread with each valid definition
+   * @param options Watcher settings
+   */
+  ConfigWatcher(std::string config_path, DefinitionHandler on_reload, ConfigWatcherOptions options = {});
+
+  /**
+   * @brief Constructor reloading a state machine
+   *
+   * Valid definitions are passed to StateMachine::scheduleDefinition(), so they
+   * take effect at the machine's next event.
+   *
+   * @param config_path Path to YAML configuration file
+   * @param machine Machine to reload; must outlive the watcher
+   * @param options Watcher settings
+   */
+  ConfigWatcher(std::string config_path, StateMachine& machine, ConfigWatcherOptions options = {});
+
+  /**
+   * @brief Destructor, stops the watcher thread
+   */
+  ~ConfigWatcher();
+
+  // Copy and move prohibition (owns a running thread)
+  ConfigWatcher(const ConfigWatcher&) = delete;
+  ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+  ConfigWatcher(ConfigWatcher&&) = delete;
+  ConfigWatcher& operator=(ConfigWatcher&&) = delete;
+
+  /**
+   * @brief Start watching
+   * @throws ConfigException if the watch cannot be set up or watcher is already running
+   */
+  void start();
+
+  /**
+   * @brief Stop watching and join the watcher thread
+   *
+   * A reload in progress is completed first. Does nothing if not running.
+   */
+  void stop();
+
+  /**
+   * @brief Check if watcher is running
+   * @return true if started
+   */
+  [[nodiscard]] bool isRunning() const;
+
+  /**
+   * @brief Set handler for rejected reloads
+   *
+   * Called on the watcher thread. Set it before start().
+   *
+   * @param handler Error handler function
+   */
+  void setErrorHandler(ErrorHandler handler);
+
+  /**
+   * @brief Get number of successful reloads
+   * @return Reload count
+   */
+  [[nodiscard]] uint64_t getReloadCount() const;
+
+  /**
+   * @brief Get number of rejected reloads
+   * @return Rejected reload count
+   */
+  [[nodiscard]] uint64_t getRejectedCount() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fsmconfig
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <coroutine>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+namespace fsmconfig {
+
+// Forward declarations
+class StateMachine;
+
+/**
+ * @file coroutine.hpp
+ * @brief C++20 awaitables for waiting on states and events of a StateMachine
+ *
+ * The awaitables work with any coroutine type; the library does not impose a
+ * task type. A suspended coroutine costs one pointer in the machine until it
+ * is resumed, so many flows can wait without blocking a thread each.
+ *
+ * Coroutines are resumed on the thread processing the machine's events, after
+ * the event that satisfies them has been fully processed. In strand mode
+ * (StateMachine::setStrandMode()) awaiting is thread-safe: registration goes
+ * through the strand like triggerEvent(). Coroutines still suspended when the
+ * machine is destroyed are never resumed.
+ */
+
+/**
+ * @class StateAwaitable
+ * @brief Awaitable completing once the machine is in one of the given states
+ *
+ * Returned by StateMachine::untilState(). Completes immediately if the started
+ * machine is already in one of the states. co_await yields the state name.
+ */
+class StateAwaitable {
+ public:
+  /**
+   * @brief Constructor
+   * @param machine Machine to watch
+   * @param state_names States to wait for
+   */
+  StateAwaitable(StateMachine& machine, std::vector<std::string> state_names);
+
+  /**
+   * @brief Always false, the current state is checked on suspension
+   */
+  [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+  /**
+   * @brief Register the coroutine with the machine
+   * @return false if the machine is already in one of the states
+   */
+  bool await_suspend(std::coroutine_handle<> handle);
+
+  /**
+   * @brief Get the state that completed the wait
+   */
+  [[nodiscard]] std::string await_resume() { return std::move(entered_); }
+
+ private:
+  friend class StateMachine;
+
+  StateMachine* machine_;
+  std::vector<std::string> state_names_;
+  std::string entered_;
+  std::coroutine_handle<> handle_;
+};
+
+/**
+ * @class EventAwaitable
+ * @brief Awaitable triggering an event and completing once it has been processed
+ *
+ * Returned by StateMachine::postEvent(). Outside strand mode the event is
+ * processed synchronously and its exceptions propagate to the coroutine. In
+ * strand mode a busy machine queues the event and the coroutine is resumed by
+ * the thread that processes it; errors go to the error handler. co_await
+ * yields the current state after the event.
+ */
+class EventAwaitable {
+ public:
+  /**
+   * @brief Constructor
+   * @param machine Machine to post to
+   * @param event_name Event name
+   * @param data Event data
+   */
+  EventAwaitable(StateMachine& machine, std::string event_name, std::map<std::string, VariableValue> data);
+
+  /**
+   * @brief Always false, the event is triggered on suspension
+   */
+  [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+  /**
+   * @brief Trigger the event
+   * @return false if the event was processed in place
+   */
+  bool await_suspend(std::coroutine_handle<> handle);
+
+  /**
+   * @brief Get the state after the event was processed
+   */
+  [[nodiscard]] std::string await_resume() { return std::move(state_); }
+
+ private:
+  friend class StateMachine;
+
+  StateMachine* machine_;
+  std::string event_name_;
+  std::map<std::string, VariableValue> data_;
+  std::string state_;
+  std::coroutine_handle<> handle_;
+};
+
+}  // namespace fsmconfig
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+namespace fsmconfig {
+
+// Forward declarations
+class MachineDefinition;
+
+/**
+ * @file definition_cache.hpp
+ * @brief Shared cache of machine definitions loaded in parallel
+ */
+
+/**
+ * @class DefinitionCache
+ * @brief Loads many configuration files in parallel and shares identical definitions
+ *
+ * DefinitionCache provides:
+ * - Parallel reading, parsing and validation of configuration files on a thread pool
+ * - Deduplication by file content: identical files share one MachineDefinition
+ * - Lookup of already loaded definitions by path
+ *
+ * Files are identified by a 64-bit content hash together with their size.
+ * All methods are thread-safe.
+ */
+class DefinitionCache {
+ public:
+  /**
+   * @brief Constructor
+   */
+  DefinitionCache();
+
+  /**
+   * @brief Destructor
+   */
+  ~DefinitionCache();
+
+  // Copy and move prohibition
+  DefinitionCache(const DefinitionCache&) = delete;
+  DefinitionCache& operator=(const DefinitionCache&) = delete;
+  DefinitionCache(DefinitionCache&&) = delete;
+  DefinitionCache& operator=(DefinitionCache&&) = delete;
+
+  /**
+   * @brief Load configuration files in parallel
+   *
+   * Every file is read and hashed; each distinct content that is not cached yet
+   * is parsed and validated once. Files that load successfully are cached even
+   * if others fail.
+   *
+   * @param paths Paths to YAML configuration files
+   * @param threads Number of worker threads (0 = hardware concurrency)
+   * @return Definitions in the order of paths
+   * @throws ConfigException listing every file that could not be loaded
+   */
+  std::vector<std::shared_ptr<const MachineDefinition>> loadAll(const std::vector<std::string>& paths,
+                                                                size_t threads = 0);
+
+  /**
+   * @brief Load a single configuration file through the cache
+   * @param path Path to YAML configuration file
+   * @return Shared definition
+   * @throws ConfigException on load, parse or validation errors
+   */
+  std::shared_ptr<const MachineDefinition> load(const std::string& path);
+
+  /**
+   * @brief Get definition loaded from path
+   * @param path Path as passed to loadAll() or load()
+   * @return Shared definition or nullptr if path was not loaded
+   */
+  [[nodiscard]] std::shared_ptr<const MachineDefinition> get(const std::string& path) const;
+
+  /**
+   * @brief Get number of distinct definitions
+   * @return Definition count
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief Drop all cached definitions
+   *
+   * Definitions already handed out stay valid.
+   */
+  void clear();
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fsmconfig
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace fsmconfig {
+
+/**
+ * @file delegate.hpp
+ * @brief Non-allocating callable wrapper for registered callbacks
+ */
+
+template <typename Signature>
+class Delegate;
+
+/**
+ * @class Delegate
+ * @brief Move-only callable wrapper that stores small callables inline
+ *
+ * A Delegate is a trampoline function pointer plus a small inline buffer.
+ * Member function bindings (object pointer plus method) and lambdas that
+ * capture a few pointers or references are stored in the buffer, so
+ * registering them does not allocate and calling them is one indirect call.
+ *
+ * Callables that do not fit, or are not trivially copyable (for example a
+ * lambda capturing a std::string, a std::function or a
+ * std::move_only_function), are moved to the heap once at construction.
+ * Empty std::function objects and null function pointers produce an empty
+ * Delegate.
+ *
+ * @tparam R Return type
+ * @tparam Args Argument types
+ */
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+ public:
+  /// Size of the inline buffer: a member function pointer plus an object pointer
+  static constexpr size_t INLINE_SIZE = 3 * sizeof(void*);
+
+  /// True if F is stored in the inline buffer
+  template <typename F>
+  static constexpr bool STORED_INLINE = sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(void*) &&
+                                        std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>;
+
+  /**
+   * @brief Construct empty delegate
+   */
+  Delegate() noexcept = default;
+
+  /**
+   * @brief Construct empty delegate
+   */
+  Delegate(std::nullptr_t) noexcept {}  // NOLINT(google-explicit-constructor) - mirrors std::function
+
+  /**
+   * @brief Bind member function and object
+   * @param method Member function pointer
+   * @param instance Object the method is called on (must outlive the delegate)
+   */
+  template <typename T>
+  Delegate(R (T::*method)(Args...), T* instance) noexcept
+      : Delegate([method, instance](Args... args) -> R { return (instance->*method)(std::forward<Args>(args)...); }) {}
+
+  /**
+   * @brief Bind const member function and object
+   * @param method Member function pointer
+   * @param instance Object the method is called on (must outlive the delegate)
+   */
+  template <typename T>
+  Delegate(R (T::*method)(Args...) const, const T* instance) noexcept
+      : Delegate([method, instance](Args... args) -> R { return (instance->*method)(std::forward<Args>(args)...); }) {}
+
+  /**
+   * @brief Wrap callable
+   * @param callable Function pointer, lambda or other function object
+   */
+  template <typename F>
+    requires(!std::is_same_v<std::remove_cvref_t<F>, Delegate> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+  Delegate(F&& callable) {  // NOLINT(google-explicit-constructor) - mirrors std::function
+    using Callable = std::decay_t<F>;
+    if constexpr (std::is_constructible_v<bool, Callable&>) {
+      if (!static_cast<bool>(callable)) {
+        return;
+      }
+    }
+
+    if constexpr (STORED_INLINE<Callable>) {
+      ::new (static_cast<void*>(storage_)) Callable(std::forward<F>(callable));
+      invoke_ = [](void* storage, Args... args) -> R {
+        return (*std::launder(static_cast<Callable*>(storage)))(std::forward<Args>(args)...);
+      };
+    } else {
+      ::new (static_cast<void*>(storage_)) Callable*(new Callable(std::forward<F>(callable)));
+      invoke_ = [](void* storage, Args... args) -> R {
+        return (**std::launder(static_cast<Callable**>(storage)))(std::forward<Args>(args)...);
+      };
+      destroy_ = [](void* storage) { delete *std::launder(static_cast<Callable**>(storage)); };
+    }
+  }
+
+  /**
+   * @brief Bind member function known at compile time
+   *
+   * Only the object pointer is stored; the call is resolved statically.
+   *
+   * @tparam Method Member function pointer
+   * @param instance Object the method is called on (must outlive the delegate)
+   * @return Delegate calling instance->*Method
+   */
+  template <auto Method, typename T>
+  [[nodiscard]] static Delegate bind(T* instance) noexcept {
+    return Delegate([instance](Args... args) -> R { return (instance->*Method)(std::forward<Args>(args)...); });
+  }
+
+  ~Delegate() { reset(); }
+
+  // Copy prohibition (heap-stored callables may be move-only)
+  Delegate(const Delegate&) = delete;
+  Delegate& operator=(const Delegate&) = delete;
+
+  Delegate(Delegate&& other) noexcept { moveFrom(other); }
+
+  Delegate& operator=(Delegate&& other) noexcept {
+    if (this != &other) {
+      reset();
+      moveFrom(other);
+    }
+    return *this;
+  }
+
+  Delegate& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  /**
+   * @brief Call the wrapped callable
+   * @pre The delegate is not empty
+   */
+  R operator()(Args... args) const { return invoke_(const_cast<std::byte*>(storage_), std::forward<Args>(args)...); }
+
+  /**
+   * @brief Check whether a callable is bound
+   */
+  explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+  /**
+   * @brief Check whether the callable lives in the inline buffer
+   * @return true for bound delegates that did not allocate
+   */
+  [[nodiscard]] bool isInline() const noexcept { return invoke_ != nullptr && destroy_ == nullptr; }
+
+ private:
+  void reset() noexcept {
+    if (destroy_ != nullptr) {
+      destroy_(storage_);
+    }
+    invoke_ = nullptr;
+    destroy_ = nullptr;
+  }
+
+  void moveFrom(Delegate& other) noexcept {
+    // Inline payloads are trivially copyable and heap payloads are a pointer,
+    // so both move as raw bytes
+    std::memcpy(storage_, other.storage_, INLINE_SIZE);
+    invoke_ = other.invoke_;
+    destroy_ = other.destroy_;
+    other.invoke_ = nullptr;
+    other.destroy_ = nullptr;
+  }
+
+  alignas(void*) std::byte storage_[INLINE_SIZE]{};
+  R (*invoke_)(void*, Args...) = nullptr;
+  void (*destroy_)(void*) = nullptr;
+};
+
+}  // namespace fsmconfig
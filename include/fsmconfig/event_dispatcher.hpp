@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -9,10 +12,71 @@
 
 namespace fsmconfig {
 
+class CompiledConfig;
+
 /// Event handler function type
 using EventHandler = std::function<void(const std::string& event_name, const TransitionEvent& event)>;
 
+/// Priority lane of a dispatched event, most urgent first
+enum class EventPriority : uint8_t {
+  CRITICAL,  ///< Expedited lane (e.g. connection loss)
+  HIGH,      ///< Ahead of regular traffic
+  NORMAL,    ///< Default lane
+  LOW,       ///< Bulk traffic (e.g. telemetry)
+};
+
+/// Number of priority lanes
+inline constexpr size_t EVENT_PRIORITY_COUNT = 4;
+
+/// Order in which the consumer drains the priority lanes
+enum class DrainPolicy : uint8_t {
+  STRICT,    ///< Always the most urgent non-empty lane; lower lanes may starve
+  WEIGHTED,  ///< Up to the lane weight in a row from each non-empty lane, most urgent first
+};
+
+/// Events taken from each lane per round under DrainPolicy::WEIGHTED
+using LaneWeights = std::array<uint32_t, EVENT_PRIORITY_COUNT>;
+
+/// What dispatchEvent() does when the queue is at capacity
+enum class OverflowPolicy : uint8_t {
+  BLOCK,        ///< Wait for free space, up to the block timeout
+  REJECT,       ///< Refuse the new event
+  DROP_OLDEST,  ///< Discard the oldest event of the least urgent lane not more urgent than the new one
+  COALESCE,     ///< Replace the payload of a pending event with the same name, else refuse
+};
+
+/// Outcome of dispatchEvent()
+enum class DispatchResult : uint8_t {
+  ENQUEUED,        ///< Queued normally
+  DROPPED_OLDEST,  ///< Queued after discarding an older event
+  COALESCED,       ///< Merged into a pending event with the same name
+  REJECTED,        ///< Not queued, the queue is full
+  TIMED_OUT,       ///< Not queued, no space freed within the block timeout
+};
+
+/// Per-outcome counters of dispatchEvent() calls
+struct DispatchStats {
+  uint64_t enqueued = 0;   ///< ENQUEUED and DROPPED_OLDEST results
+  uint64_t dropped = 0;    ///< Events discarded by OverflowPolicy::DROP_OLDEST
+  uint64_t coalesced = 0;  ///< COALESCED results
+  uint64_t rejected = 0;   ///< REJECTED results
+  uint64_t timed_out = 0;  ///< TIMED_OUT results
+};
+
 /// Event dispatcher for finite state machine
+///
+/// Events are queued in one lane per EventPriority. Enqueueing is lock-free
+/// (any thread); processing is serialized and picks the next lane according
+/// to the DrainPolicy. Events of one lane are processed in dispatch order.
+///
+/// The queue is unbounded by default. With setCapacity() the total number of
+/// queued events is limited and the OverflowPolicy decides what happens to
+/// events dispatched while it is full; getDispatchStats() counts the outcomes.
+///
+/// Events registered with setCoalescing() keep at most one pending instance
+/// per key: dispatching one while an instance with the same key is queued
+/// replaces that instance's payload in place (it keeps its queue position and
+/// lane) instead of queueing another.
 class EventDispatcher {
  public:
   EventDispatcher();
@@ -26,8 +90,10 @@ class EventDispatcher {
   EventDispatcher(EventDispatcher&& other) noexcept;
   EventDispatcher& operator=(EventDispatcher&& other) noexcept;
 
-  /// Dispatch event for processing
-  void dispatchEvent(const std::string& event_name, const TransitionEvent& event);
+  /// Dispatch event for processing (thread-safe; lock-free while below capacity)
+  /// @return Whether the event was queued, merged or refused
+  DispatchResult dispatchEvent(const std::string& event_name, const TransitionEvent& event,
+                               EventPriority priority = EventPriority::NORMAL);
 
   /// Process all events in queue (synchronously)
   void processEvents();
@@ -38,12 +104,68 @@ class EventDispatcher {
   /// Get number of events in queue
   [[nodiscard]] size_t getEventQueueSize() const;
 
+  /// Get number of events in one priority lane
+  [[nodiscard]] size_t getEventQueueSize(EventPriority priority) const;
+
   /// Clear event queue
   void clearEventQueue();
 
   /// Check if there are events in queue
   [[nodiscard]] bool hasPendingEvents() const;
 
+  /// Check if there are events in one priority lane
+  [[nodiscard]] bool hasPendingEvents(EventPriority priority) const;
+
+  /// Set lane drain order (default DrainPolicy::STRICT)
+  void setDrainPolicy(DrainPolicy policy);
+
+  /// Get lane drain order
+  [[nodiscard]] DrainPolicy getDrainPolicy() const;
+
+  /// Set per-lane weights for DrainPolicy::WEIGHTED (default 8, 4, 2, 1)
+  /// @throws StateException if a weight is zero
+  void setLaneWeights(const LaneWeights& weights);
+
+  /// Get per-lane weights
+  [[nodiscard]] LaneWeights getLaneWeights() const;
+
+  /// Set maximum number of queued events (0, the default, means unbounded)
+  void setCapacity(size_t capacity);
+
+  /// Get maximum number of queued events
+  [[nodiscard]] size_t getCapacity() const;
+
+  /// Set behaviour when the queue is full (default OverflowPolicy::REJECT)
+  void setOverflowPolicy(OverflowPolicy policy);
+
+  /// Get behaviour when the queue is full
+  [[nodiscard]] OverflowPolicy getOverflowPolicy() const;
+
+  /// Set longest wait of OverflowPolicy::BLOCK (default 100 ms)
+  void setBlockTimeout(std::chrono::milliseconds timeout);
+
+  /// Get longest wait of OverflowPolicy::BLOCK
+  [[nodiscard]] std::chrono::milliseconds getBlockTimeout() const;
+
+  /// Get dispatch outcome counters
+  [[nodiscard]] DispatchStats getDispatchStats() const;
+
+  /// Reset dispatch outcome counters
+  void resetDispatchStats();
+
+  /// Coalesce pending instances of an event (replaces an earlier rule for it)
+  /// @param key_field Event data field telling instances apart (empty: event name only)
+  void setCoalescing(const std::string& event_name, const std::string& key_field = "");
+
+  /// Stop coalescing an event; instances already queued stay queued
+  void clearCoalescing(const std::string& event_name);
+
+  /// Check if an event is coalesced
+  [[nodiscard]] bool isCoalescing(const std::string& event_name) const;
+
+  /// Apply the `coalesce` options of a configuration's `events` section
+  void loadCoalescing(const CompiledConfig& config);
+
   /// Set event handler
   void setEventHandler(EventHandler handler);
 
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "types.hpp"
+
+namespace fsmconfig {
+
+// Forward declarations
+class StateMachine;
+
+/**
+ * @file executor.hpp
+ * @brief Work-stealing thread pool driving many state machines
+ */
+
+/**
+ * @class Executor
+ * @brief Runs the events of many state machines on a shared pool of worker threads
+ *
+ * Executor provides:
+ * - One mailbox per attached machine; events posted from any thread are queued
+ *   lock-free and processed in posting order
+ * - Strand semantics: a machine is processed by at most one worker at a time,
+ *   so its callbacks never run concurrently
+ * - Scheduling of mailboxes with pending events on per-worker deques; idle
+ *   workers steal from busy ones, so throughput scales with the number of cores
+ *
+ * A scheduled mailbox processes a bounded batch of events before it yields the
+ * worker to other machines. Events posted from a worker thread (for example by
+ * a callback) are scheduled on that worker.
+ *
+ * Attached machines must receive events only through the executor and must
+ * outlive it (or at least the processing of their posted events).
+ */
+class Executor {
+ public:
+  /// Event queue of one attached machine
+  class Mailbox;
+
+  /// Events a mailbox processes before it yields its worker
+  static constexpr size_t BATCH_SIZE = 64;
+
+  /**
+   * @brief Constructor, starts the worker threads
+   * @param threads Number of worker threads (0 = hardware concurrency)
+   */
+  explicit Executor(size_t threads = 0);
+
+  /**
+   * @brief Destructor, processes all posted events and joins the workers
+   */
+  ~Executor();
+
+  // Copy and move prohibition (owns running threads)
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+  Executor(Executor&&) = delete;
+  Executor& operator=(Executor&&) = delete;
+
+  /**
+   * @brief Attach machine
+   * @param machine Started machine; must not be moved while attached
+   * @return Mailbox to post the machine's events to
+   */
+  [[nodiscard]] std::shared_ptr<Mailbox> attach(StateMachine& machine);
+
+  /**
+   * @brief Post event to a machine (thread-safe, never blocks)
+   * @param mailbox Mailbox returned by attach()
+   * @param event_name Event name
+   * @param data Event data
+   */
+  void post(const std::shared_ptr<Mailbox>& mailbox, std::string event_name,
+            std::map<std::string, VariableValue> data = {});
+
+  /**
+   * @brief Wait until every posted event has been processed
+   *
+   * Must not be called from a worker thread.
+   */
+  void waitIdle();
+
+  /**
+   * @brief Set handler for errors thrown by triggerEvent()
+   *
+   * Called on worker threads, possibly concurrently. Set it before posting events.
+   *
+   * @param handler Error handler function
+   */
+  void setErrorHandler(ErrorHandler handler);
+
+  /**
+   * @brief Get number of worker threads
+   * @return Thread count
+   */
+  [[nodiscard]] size_t getThreadCount() const;
+
+  /**
+   * @brief Get number of processed events
+   * @return Events processed since construction
+   */
+  [[nodiscard]] uint64_t getProcessedCount() const;
+
+  /**
+   * @brief Get number of tasks taken from another worker's deque
+   * @return Steal count
+   */
+  [[nodiscard]] uint64_t getStealCount() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fsmconfig
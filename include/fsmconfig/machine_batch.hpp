@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "compiled_config.hpp"
+#include "delegate.hpp"
+
+namespace fsmconfig {
+
+// Forward declarations
+class MachineDefinition;
+
+/**
+ * @file machine_batch.hpp
+ * @brief Many instances of one definition stepped together
+ */
+
+/// Callback run once per state with the instances that entered or left it
+using BatchStateCallback = Delegate<void(std::span<const uint32_t> instances)>;
+
+/// Guard evaluated per instance
+using BatchGuardCallback = Delegate<bool(uint32_t instance)>;
+
+/**
+ * @class MachineBatch
+ * @brief Structure-of-arrays set of machine instances sharing one definition
+ *
+ * MachineBatch provides:
+ * - Current states of all instances in one contiguous StateId array
+ * - triggerEvent() applying an event to every instance at once: the next state
+ *   comes from a (event, state) table gather, with an AVX2 kernel when built
+ *   with FSMCONFIG_ENABLE_AVX2 on an x86 CPU that supports it
+ * - on_enter/on_exit callbacks called once per state with the instances whose
+ *   state actually changed, so unaffected instances cost one table lookup
+ *
+ * Instances only track their state: transition callbacks, actions, variables,
+ * observers and timeouts are the business of StateMachine. Instances start in
+ * the initial state without running its on_enter callback. Self-transitions
+ * leave the state unchanged and run no callbacks.
+ *
+ * Events with guarded transitions fall back to a scalar pass that evaluates the
+ * guard of each instance in a guarded source state; an unregistered guard denies
+ * the transition, as in StateMachine. A batch is not thread-safe and callbacks
+ * must not trigger events on the batch they are called from.
+ */
+class MachineBatch {
+ public:
+  /**
+   * @brief Constructor
+   * @param definition Definition shared by all instances
+   * @param count Number of instances
+   * @throws StateException if the definition is null or has no initial state, or count exceeds 2^32 - 1
+   */
+  MachineBatch(std::shared_ptr<const MachineDefinition> definition, size_t count);
+
+  /**
+   * @brief Destructor
+   */
+  ~MachineBatch();
+
+  // Copy prohibition
+  MachineBatch(const MachineBatch&) = delete;
+  MachineBatch& operator=(const MachineBatch&) = delete;
+
+  /**
+   * @brief Move constructor
+   */
+  MachineBatch(MachineBatch&& other) noexcept;
+
+  /**
+   * @brief Move assignment operator
+   */
+  MachineBatch& operator=(MachineBatch&& other) noexcept;
+
+  /**
+   * @brief Get number of instances
+   * @return Instance count
+   */
+  [[nodiscard]] size_t size() const;
+
+  /**
+   * @brief Get definition shared by all instances
+   * @return Shared immutable definition
+   */
+  [[nodiscard]] std::shared_ptr<const MachineDefinition> getDefinition() const;
+
+  /**
+   * @brief Get current states of all instances
+   * @return StateIds of the definition's CompiledConfig, indexed by instance
+   */
+  [[nodiscard]] std::span<const StateId> states() const;
+
+  /**
+   * @brief Get current state name of an instance
+   * @param instance Instance index
+   * @return State name
+   * @throws StateException if instance is out of range
+   */
+  [[nodiscard]] std::string_view getState(size_t instance) const;
+
+  /**
+   * @brief Put an instance into a state without running callbacks
+   * @param instance Instance index
+   * @param state_name State name
+   * @throws StateException if instance is out of range or the state does not exist
+   */
+  void setState(size_t instance, std::string_view state_name);
+
+  /**
+   * @brief Apply an event to every instance
+   * @param event_name Event name (unknown events change nothing)
+   * @return Number of instances whose state changed
+   */
+  size_t triggerEvent(std::string_view event_name);
+
+  /**
+   * @brief Apply an event to every instance
+   * @param event Event identifier of the definition's CompiledConfig
+   * @return Number of instances whose state changed
+   * @throws StateException if called from a callback of this batch
+   */
+  size_t triggerEvent(EventId event);
+
+  /**
+   * @brief Get instances changed by the last triggerEvent()
+   * @return Instance indices in ascending order
+   */
+  [[nodiscard]] std::span<const uint32_t> getChangedInstances() const;
+
+  /**
+   * @brief Check whether triggerEvent() uses the AVX2 kernel
+   * @return true if built with FSMCONFIG_ENABLE_AVX2 and the CPU supports AVX2
+   */
+  [[nodiscard]] static bool isVectorized();
+
+  // Snapshots
+
+  /**
+   * @brief Save the states of all instances
+   *
+   * The snapshot holds the definition's layout hash, the instance count and
+   * the raw StateId array, so it is written and read with one copy each.
+   *
+   * @return Snapshot bytes
+   */
+  [[nodiscard]] std::string snapshot() const;
+
+  /**
+   * @brief Replace all instances with the ones saved by snapshot()
+   *
+   * The instance count becomes the saved one and no callbacks run. The batch is
+   * left unchanged if the snapshot is rejected.
+   *
+   * @param snapshot Bytes returned by snapshot() of a batch with the same layout hash
+   * @throws StateException if the snapshot is malformed or was taken with other states
+   */
+  void restore(std::string_view snapshot);
+
+  // Callback registration
+
+  /**
+   * @brief Register state callback
+   *
+   * Called after all instances have moved: on_exit callbacks of every left
+   * state first, then on_enter callbacks of every entered state.
+   *
+   * @param state_name State name
+   * @param callback_type Callback type ("on_enter" or "on_exit")
+   * @param callback Callback receiving the changed instances in ascending order
+   * @throws StateException if the state does not exist or the type is unknown
+   */
+  void registerStateCallback(const std::string& state_name, const std::string& callback_type,
+                             BatchStateCallback callback);
+
+  /**
+   * @brief Register guard callback
+   * @param from_state Source state
+   * @param to_state Target state
+   * @param event_name Event name
+   * @param callback Guard called with each instance in from_state
+   * @throws StateException if no such transition exists
+   */
+  void registerGuard(const std::string& from_state, const std::string& to_state, const std::string& event_name,
+                     BatchGuardCallback callback);
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fsmconfig
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "compiled_config.hpp"
+#include "state.hpp"
+#include "types.hpp"
+
+namespace fsmconfig {
+
+// Forward declarations
+class ConfigParser;
+
+/**
+ * @file machine_definition.hpp
+ * @brief Immutable compiled state machine definition
+ */
+
+/**
+ * @class MachineDefinition
+ * @brief Immutable, shareable result of loading and validating a configuration
+ *
+ * MachineDefinition provides:
+ * - Loading and validation of a configuration once, off the event-processing path
+ * - Read-only access to parsed states, transitions and variables
+ * - Sharing of one definition between many StateMachine instances
+ *
+ * A definition never changes after construction, so it can be read from any
+ * thread without synchronization. StateMachine holds its definition through a
+ * std::shared_ptr and can swap it atomically (see StateMachine::reload()).
+ */
+class MachineDefinition {
+ public:
+  /**
+   * @brief Load definition from file
+   * @param config_path Path to YAML configuration file
+   * @return Shared immutable definition
+   * @throws ConfigException on load, parse or validation errors
+   */
+  [[nodiscard]] static std::shared_ptr<const MachineDefinition> fromFile(const std::string& config_path);
+
+  /**
+   * @brief Load definition from string
+   * @param yaml_content String with YAML content
+   * @return Shared immutable definition
+   * @throws ConfigException on parse or validation errors
+   */
+  [[nodiscard]] static std::shared_ptr<const MachineDefinition> fromString(const std::string& yaml_content);
+
+  /**
+   * @brief Constructor from a loaded parser
+   * @param parser Parser holding a loaded and validated configuration
+   */
+  explicit MachineDefinition(ConfigParser parser);
+
+  /**
+   * @brief Destructor
+   */
+  ~MachineDefinition();
+
+  // Copy and move prohibition (shared through std::shared_ptr)
+  MachineDefinition(const MachineDefinition&) = delete;
+  MachineDefinition& operator=(const MachineDefinition&) = delete;
+  MachineDefinition(MachineDefinition&&) = delete;
+  MachineDefinition& operator=(MachineDefinition&&) = delete;
+
+  /**
+   * @brief Get parsed configuration
+   * @return Reference to parser holding the configuration
+   */
+  [[nodiscard]] const ConfigParser& getConfig() const;
+
+  /**
+   * @brief Get compiled configuration
+   * @return Reference to the canonical state, transition and variable records
+   */
+  [[nodiscard]] const CompiledConfig& getCompiledConfig() const;
+
+  /**
+   * @brief Find state
+   * @param state_name State name
+   * @return View of the compiled state record, std::nullopt if state does not exist
+   */
+  [[nodiscard]] std::optional<StateView> findState(const std::string& state_name) const;
+
+  /**
+   * @brief Check if state exists
+   * @param state_name State name
+   * @return true if state exists
+   */
+  [[nodiscard]] bool hasState(const std::string& state_name) const;
+
+  /**
+   * @brief Get list of all states
+   * @return Vector of all state names, sorted
+   */
+  [[nodiscard]] std::vector<std::string> getStateNames() const;
+
+  /**
+   * @brief Get initial state
+   * @return Initial state name (empty if configuration has no states)
+   */
+  [[nodiscard]] const std::string& getInitialState() const;
+
+  /**
+   * @brief Get hash of the state numbering
+   *
+   * Definitions with the same states in the same declaration order share the
+   * hash, so StateIds and snapshots (StateMachine::snapshot()) carry over
+   * between them even if transitions or callbacks differ.
+   *
+   * @return Stable 64-bit hash of the state names in StateId order
+   */
+  [[nodiscard]] uint64_t getLayoutHash() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fsmconfig
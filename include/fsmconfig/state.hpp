@@ -2,16 +2,19 @@
 
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "fsmconfig/compiled_config.hpp"
 #include "fsmconfig/types.hpp"
 
 namespace fsmconfig {
 
 /**
  * @file state.hpp
- * @brief Finite state machine state class
+ * @brief Finite state machine state classes
  */
 
 /**
@@ -23,6 +26,10 @@ namespace fsmconfig {
  * - State variable management
  * - Interface for accessing state data
  * - Use of Pimpl idiom for implementation hiding
+ *
+ * State owns a copy of its data and is meant for standalone use. States of a
+ * loaded configuration are inspected through StateView, which reads the
+ * canonical compiled record without copying it.
  */
 class State {
  public:
@@ -118,4 +125,96 @@ class State {
   std::unique_ptr<Impl> impl_;
 };
 
+/**
+ * @class StateView
+ * @brief Non-owning view of a state in a CompiledConfig
+ *
+ * StateView provides:
+ * - Read access to the name, callbacks, actions and variables of a state
+ * - No copies: all data is read from the compiled record
+ * - Cheap copying (a pointer and an identifier)
+ *
+ * The view is valid as long as the CompiledConfig it refers to (for example,
+ * as long as the owning MachineDefinition is alive).
+ */
+class StateView {
+ public:
+  /**
+   * @brief Constructor
+   * @param config Compiled configuration holding the state
+   * @param id State identifier; must be a valid index into config.states()
+   */
+  StateView(const CompiledConfig& config, StateId id) noexcept;
+
+  /**
+   * @brief Get state identifier
+   * @return Index of the state in the compiled configuration
+   */
+  [[nodiscard]] StateId getId() const noexcept;
+
+  /**
+   * @brief Get state name
+   * @return State name
+   */
+  [[nodiscard]] std::string_view getName() const;
+
+  /**
+   * @brief Get on-enter callback
+   * @return Callback name (empty if none)
+   */
+  [[nodiscard]] std::string_view getOnEnterCallback() const;
+
+  /**
+   * @brief Get on-exit callback
+   * @return Callback name (empty if none)
+   */
+  [[nodiscard]] std::string_view getOnExitCallback() const;
+
+  /**
+   * @brief Get state actions
+   * @return Interned action names in declaration order (see CompiledConfig::str())
+   */
+  [[nodiscard]] std::span<const StringId> getActions() const;
+
+  /**
+   * @brief Get state variables
+   * @return Compiled variables sorted by name (see CompiledConfig::value())
+   */
+  [[nodiscard]] std::span<const CompiledVariable> getVariables() const;
+
+  /**
+   * @brief Check if variable exists
+   * @param name Variable name
+   * @return true if variable exists
+   */
+  [[nodiscard]] bool hasVariable(std::string_view name) const;
+
+  /**
+   * @brief Get configured variable value
+   * @param name Variable name
+   * @return Variable value
+   * @throw StateException If variable does not exist
+   */
+  [[nodiscard]] VariableValue getVariable(std::string_view name) const;
+
+  /**
+   * @brief Copy state into an owning StateInfo
+   * @return State information
+   */
+  [[nodiscard]] StateInfo toStateInfo() const;
+
+  /**
+   * @brief Get compiled configuration the view refers to
+   * @return Reference to compiled configuration
+   */
+  [[nodiscard]] const CompiledConfig& getConfig() const noexcept;
+
+ private:
+  [[nodiscard]] const CompiledState& record() const;
+  [[nodiscard]] const CompiledVariable* findVariable(std::string_view name) const;
+
+  const CompiledConfig* config_;
+  StateId id_;
+};
+
 }  // namespace fsmconfig
@@ -1,11 +1,16 @@
 #pragma once
 
-#include <functional>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "compiled_config.hpp"
+#include "coroutine.hpp"
+#include "delegate.hpp"
 #include "types.hpp"
 
 namespace fsmconfig {
@@ -15,13 +20,33 @@ class ConfigParser;
 class CallbackRegistry;
 class VariableManager;
 class EventDispatcher;
-class State;
+class MachineDefinition;
+class TimerService;
 
 /**
  * @file state_machine.hpp
  * @brief Main StateMachine finite state machine class
  */
 
+/**
+ * @brief Event of a batch passed to StateMachine::triggerEvents()
+ */
+struct EventRef {
+  std::string_view name;                                      ///< Event name
+  const std::map<std::string, VariableValue>* data = nullptr;  ///< Event data (nullptr if none)
+};
+
+/**
+ * @brief Outcome of one event of StateMachine::triggerEvents()
+ */
+enum class EventOutcome : uint8_t {
+  TRANSITIONED,    ///< A transition was performed
+  IGNORED,         ///< No transition for the event in the current state
+  GUARD_REJECTED,  ///< The guard denied the transition
+  FAILED,          ///< Processing threw; the error went to the error handler
+  QUEUED,          ///< Strand mode: handed to the thread running the machine, outcome unknown
+};
+
 /**
  * @class StateMachine
  * @brief Finite state machine class for managing states and transitions
@@ -51,6 +76,13 @@ class StateMachine {
    */
   explicit StateMachine(const std::string& yaml_content, bool is_content);
 
+  /**
+   * @brief Constructor from a shared definition
+   * @param definition Loaded definition, may be shared between machines
+   * @throws ConfigException if definition is null
+   */
+  explicit StateMachine(std::shared_ptr<const MachineDefinition> definition);
+
   /**
    * @brief Destructor
    */
@@ -121,12 +153,75 @@ class StateMachine {
    */
   [[nodiscard]] std::vector<std::string> getAllStates() const;
 
+  // Configuration reload
+
+  /**
+   * @brief Reload configuration from file without restarting the machine
+   *
+   * Parses and validates the new configuration first; on failure the machine keeps
+   * its current definition. See swapDefinition() for migration rules.
+   *
+   * @param config_path Path to YAML configuration file
+   * @throws ConfigException on load, parse or validation errors
+   * @throws StateException if the current state does not exist in the new configuration or, once sealed, a callback
+   *         it references is not registered
+   */
+  void reload(const std::string& config_path);
+
+  /**
+   * @brief Reload configuration from YAML content without restarting the machine
+   * @param yaml_content String with YAML configuration
+   * @throws ConfigException on parse or validation errors
+   * @throws StateException if the current state does not exist in the new configuration or, once sealed, a callback
+   *         it references is not registered
+   */
+  void reloadFromString(const std::string& yaml_content);
+
+  /**
+   * @brief Replace the definition of a running or stopped machine
+   *
+   * The current state is kept by name, registered callbacks and observers are kept,
+   * and variables declared by the new definition are added without overwriting
+   * existing values. The definition is published atomically: an event already being
+   * processed finishes on the old definition, later events use the new one.
+   *
+   * The current-state check reads machine state, so call this from the thread that
+   * drives the machine or while no event is being processed.
+   *
+   * @param definition New definition
+   * @throws ConfigException if definition is null
+   * @throws StateException if the current state does not exist in the new definition or, once sealed, a callback
+   *         it references is not registered
+   */
+  void swapDefinition(std::shared_ptr<const MachineDefinition> definition);
+
+  /**
+   * @brief Publish a definition from any thread
+   *
+   * Thread-safe counterpart of swapDefinition() for reloaders running off the
+   * event-processing path (see ConfigWatcher). The definition is adopted by the
+   * driving thread at the start of the next triggerEvent() or start(). If the
+   * current state is missing from it, or the machine is sealed and a callback it
+   * references is not registered, it is dropped and reported through the error
+   * handler. A later call replaces a definition that was not adopted yet.
+   *
+   * @param definition New definition
+   * @throws ConfigException if definition is null
+   */
+  void scheduleDefinition(std::shared_ptr<const MachineDefinition> definition);
+
+  /**
+   * @brief Get current definition
+   * @return Shared pointer to the definition in use
+   */
+  [[nodiscard]] std::shared_ptr<const MachineDefinition> getDefinition() const;
+
   // Event handling
 
   /**
    * @brief Trigger event without data
    * @param event_name Event name
-   * @throws StateException if machine is not running or transition not found
+   * @throws StateException if machine is not running or transition not found (reported instead in strand mode)
    */
   void triggerEvent(const std::string& event_name);
 
@@ -134,10 +229,93 @@ class StateMachine {
    * @brief Trigger event with data
    * @param event_name Event name
    * @param data Event data
-   * @throws StateException if machine is not running or transition not found
+   * @throws StateException if machine is not running or transition not found (reported instead in strand mode)
    */
   void triggerEvent(const std::string& event_name, const std::map<std::string, VariableValue>& data);
 
+  /**
+   * @brief Trigger a sequence of events in one call
+   *
+   * Equivalent to calling triggerEvent() for each event in order, with the
+   * per-call checks done once: the running check, definition lookup and
+   * observer cleanup are hoisted out of the loop and events without a
+   * transition cost one lookup. An event that throws is reported through the
+   * error handler and the batch continues with the next one.
+   *
+   * In strand mode a busy machine gets the events queued like triggerEvent()
+   * would, and their outcomes are EventOutcome::QUEUED. Events sent to a
+   * machine that is not running get EventOutcome::FAILED.
+   *
+   * @param events Events to process (the names only need to live for the call)
+   * @param outcomes Empty, or receives the outcome of each event at the same index
+   * @return Number of transitions performed
+   * @throws StateException if the machine is not running (reported instead in strand mode) or outcomes is too small
+   */
+  size_t triggerEvents(std::span<const EventRef> events, std::span<EventOutcome> outcomes = {});
+
+  /**
+   * @brief Enable or disable strand mode
+   *
+   * In strand mode triggerEvent() may be called from any thread. Calls are
+   * serialized through a lock-free mailbox instead of a mutex: a caller that
+   * finds the machine idle processes its event and then drains events posted
+   * meanwhile, other callers enqueue and return immediately. A callback
+   * triggering an event on its own machine enqueues it as well, so it runs
+   * after the current event completes.
+   *
+   * Processing errors are reported through the error handler instead of being
+   * thrown, since the failing event may run on another thread. Only events go
+   * through the strand: switch the mode, start, register callbacks and set the
+   * error handler before the machine is shared between threads.
+   *
+   * @param enabled true to serialize triggerEvent() calls
+   */
+  void setStrandMode(bool enabled);
+
+  /**
+   * @brief Check if strand mode is enabled
+   * @return true if triggerEvent() calls are serialized
+   */
+  [[nodiscard]] bool isStrandMode() const;
+
+  /**
+   * @brief Set timer service firing the 'after' transitions
+   *
+   * Entering a state arms one timer per outgoing transition with an 'after'
+   * timeout; leaving the state (or replacing the definition, which restarts
+   * them) cancels them. An expired timer triggers the transition's event like
+   * triggerEvent(), on the thread that runs the service's callbacks, so enable
+   * strand mode when the service runs its own thread. Expiries racing with a
+   * state change are dropped. Errors go to the error handler.
+   *
+   * @param timers Timer service (must outlive the machine), or nullptr to disable timeouts
+   */
+  void setTimerService(TimerService* timers);
+
+  // Coroutine support (see coroutine.hpp)
+
+  /**
+   * @brief Await entering a state
+   * @param state_name State to wait for
+   * @return Awaitable yielding the state name
+   */
+  [[nodiscard]] StateAwaitable untilState(std::string state_name);
+
+  /**
+   * @brief Await entering any of several states
+   * @param state_names States to wait for
+   * @return Awaitable yielding the entered state's name
+   */
+  [[nodiscard]] StateAwaitable untilState(std::vector<std::string> state_names);
+
+  /**
+   * @brief Trigger event from a coroutine and await its processing
+   * @param event_name Event name
+   * @param data Event data
+   * @return Awaitable yielding the state after the event
+   */
+  [[nodiscard]] EventAwaitable postEvent(std::string event_name, std::map<std::string, VariableValue> data = {});
+
   // Callback registration (template methods)
 
   /**
@@ -147,6 +325,7 @@ class StateMachine {
    * @param callback_type Callback type (e.g., "on_enter", "on_exit")
    * @param callback Callback method
    * @param instance Pointer to class instance
+   * @throws StateException if the machine is sealed
    */
   template <typename T>
   void registerStateCallback(const std::string& state_name, const std::string& callback_type, void (T::*callback)(),
@@ -159,6 +338,7 @@ class StateMachine {
    * @param to_state Target state
    * @param callback Callback method
    * @param instance Pointer to class instance
+   * @throws StateException if the machine is sealed
    */
   template <typename T>
   void registerTransitionCallback(const std::string& from_state, const std::string& to_state,
@@ -172,6 +352,7 @@ class StateMachine {
    * @param event_name Event name
    * @param callback Callback method
    * @param instance Pointer to class instance
+   * @throws StateException if the machine is sealed
    */
   template <typename T>
   void registerGuard(const std::string& from_state, const std::string& to_state, const std::string& event_name,
@@ -183,10 +364,42 @@ class StateMachine {
    * @param action_name Action name
    * @param callback Callback method
    * @param instance Pointer to class instance
+   * @throws StateException if the machine is sealed
    */
   template <typename T>
   void registerAction(const std::string& action_name, void (T::*callback)(), T* instance);
 
+  // Callback binding
+
+  /**
+   * @brief Verify that every callback referenced by the configuration is registered
+   *
+   * Resolves every on_enter, on_exit, guard, on_transition and action name of
+   * the current definition to its registered callback. Events use the resolved
+   * callbacks until a definition is swapped or a callback is registered.
+   *
+   * @throws StateException listing every unregistered callback
+   */
+  void bind();
+
+  /**
+   * @brief Bind and freeze callback registration
+   *
+   * After sealing, registering a callback throws StateException and only
+   * definitions whose callbacks are all registered are accepted by reload(),
+   * swapDefinition() and scheduleDefinition(). Events then skip the
+   * registration check entirely.
+   *
+   * @throws StateException listing every unregistered callback (the machine stays unsealed)
+   */
+  void seal();
+
+  /**
+   * @brief Check if the machine is sealed
+   * @return true after a successful seal()
+   */
+  [[nodiscard]] bool isSealed() const;
+
   // Variable management
 
   /**
@@ -211,6 +424,54 @@ class StateMachine {
    */
   [[nodiscard]] bool hasVariable(const std::string& name) const;
 
+  // Snapshots
+
+  /**
+   * @brief Save current state and variables
+   *
+   * The snapshot is a compact binary blob holding the definition's layout hash
+   * (MachineDefinition::getLayoutHash()), whether the machine is started, the
+   * current StateId and all global and state variables. Callbacks, observers,
+   * the definition itself and queued events are not part of it.
+   *
+   * @return Snapshot bytes
+   */
+  [[nodiscard]] std::string snapshot() const;
+
+  /**
+   * @brief Restore state and variables saved by snapshot()
+   *
+   * No callbacks, actions or observers run: the machine resumes in the saved
+   * state as if it had never left it. Variables are replaced by the saved ones,
+   * timers of the restored state's 'after' transitions start over and
+   * coroutines waiting for it are resumed. Like start(), it must not be called
+   * while events are being processed.
+   *
+   * @param snapshot Bytes returned by snapshot() of a machine with the same layout hash
+   * @throws StateException if the snapshot is malformed or was taken with other states
+   */
+  void restore(std::string_view snapshot);
+
+  /**
+   * @brief Save many machines into one snapshot
+   * @param machines Machines to save
+   * @return Snapshot bytes holding one record per machine, in order
+   */
+  [[nodiscard]] static std::string snapshotAll(std::span<const StateMachine* const> machines);
+
+  /**
+   * @brief Restore many machines from snapshotAll()
+   *
+   * The whole snapshot is validated before any machine changes, so a bad
+   * snapshot leaves every machine as it was.
+   *
+   * @param machines Machines to restore, in the order they were saved
+   * @param snapshot Bytes returned by snapshotAll() (or snapshot() for one machine)
+   * @throws StateException if the snapshot is malformed, holds another number of
+   *         machines, or a record was taken with other states
+   */
+  static void restoreAll(std::span<StateMachine* const> machines, std::string_view snapshot);
+
   // Observers
 
   /**
@@ -243,23 +504,38 @@ class StateMachine {
   struct Impl;
   std::unique_ptr<Impl> impl_;
 
+  friend class StateAwaitable;
+  friend class EventAwaitable;
+
   // Helper methods
-  void performTransition(const TransitionEvent& event);
-  bool evaluateGuard(const std::string& from_state, const std::string& to_state, const std::string& event_name);
-  void executeStateActions(const std::string& state_name);
-  void executeTransitionActions(const std::vector<std::string>& actions);
+  void processEvent(const std::string& event_name, const std::map<std::string, VariableValue>& data);
+  void processStrandEvent(const std::string& event_name, const std::map<std::string, VariableValue>& data);
+  void processTimeout(uint64_t epoch, EventId event);
+  EventOutcome applyEvent(const std::shared_ptr<const MachineDefinition>& definition, StateId& state,
+                          std::string_view event_name, const std::map<std::string, VariableValue>& data);
+  size_t processBatch(std::span<const EventRef> events, std::span<EventOutcome> outcomes);
+  void performTransition(const CompiledConfig& config, const CompiledTransition& transition,
+                         const TransitionEvent& event);
+  void executeStateActions(const CompiledConfig& config, StateId state);
+  void executeTransitionActions(const CompiledConfig& config, const CompiledTransition& transition);
+
+  // Helper methods for coroutine awaitables
+  bool suspendUntilState(StateAwaitable& waiter);
+  bool suspendForEvent(EventAwaitable& waiter);
+  bool addStateWaiter(StateAwaitable& waiter);
+  void resumeStateWaiters();
 
   // Helper methods for callback registration (for template methods)
   void registerStateCallbackImpl(const std::string& state_name, const std::string& callback_type,
-                                 std::function<void()> callback);
+                                 Delegate<void()> callback);
 
   void registerTransitionCallbackImpl(const std::string& from_state, const std::string& to_state,
-                                      std::function<void(const TransitionEvent&)> callback);
+                                      Delegate<void(const TransitionEvent&)> callback);
 
   void registerGuardImpl(const std::string& from_state, const std::string& to_state, const std::string& event_name,
-                         std::function<bool()> callback);
+                         Delegate<bool()> callback);
 
-  void registerActionImpl(const std::string& action_name, std::function<void()> callback);
+  void registerActionImpl(const std::string& action_name, Delegate<void()> callback);
 };
 
 // Template method implementations in header
@@ -267,28 +543,24 @@ class StateMachine {
 template <typename T>
 void StateMachine::registerStateCallback(const std::string& state_name, const std::string& callback_type,
                                          void (T::*callback)(), T* instance) {
-  auto cb = [instance, callback]() { (instance->*callback)(); };
-  registerStateCallbackImpl(state_name, callback_type, cb);
+  registerStateCallbackImpl(state_name, callback_type, Delegate<void()>(callback, instance));
 }
 
 template <typename T>
 void StateMachine::registerTransitionCallback(const std::string& from_state, const std::string& to_state,
                                               void (T::*callback)(const TransitionEvent&), T* instance) {
-  auto cb = [instance, callback](const TransitionEvent& event) { (instance->*callback)(event); };
-  registerTransitionCallbackImpl(from_state, to_state, cb);
+  registerTransitionCallbackImpl(from_state, to_state, Delegate<void(const TransitionEvent&)>(callback, instance));
 }
 
 template <typename T>
 void StateMachine::registerGuard(const std::string& from_state, const std::string& to_state,
                                  const std::string& event_name, bool (T::*callback)(), T* instance) {
-  auto cb = [instance, callback]() -> bool { return (instance->*callback)(); };
-  registerGuardImpl(from_state, to_state, event_name, cb);
+  registerGuardImpl(from_state, to_state, event_name, Delegate<bool()>(callback, instance));
 }
 
 template <typename T>
 void StateMachine::registerAction(const std::string& action_name, void (T::*callback)(), T* instance) {
-  auto cb = [instance, callback]() { (instance->*callback)(); };
-  registerActionImpl(action_name, cb);
+  registerActionImpl(action_name, Delegate<void()>(callback, instance));
 }
 
 }  // namespace fsmconfig
@@ -0,0 +1,420 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fsmconfig/types.hpp"
+#include "fsmconfig/variable_manager.hpp"
+
+namespace fsmconfig {
+
+/**
+ * @file static_state_machine.hpp
+ * @brief Compile-time state machine with a static transition table
+ */
+
+/**
+ * @brief Transition row of a static transition table
+ * @tparam From Source state
+ * @tparam On Event
+ * @tparam To Target state
+ * @tparam Guard Guard tag type, or void for an unguarded transition
+ * @tparam Action Action tag type, or void for no action
+ *
+ * Guard and action are tag types declared by the definition. The handler implements
+ * them as overloads `bool guard(Guard)` and `void action(Action)`, so the call is
+ * selected by overload resolution at compile time.
+ */
+template <auto From, auto On, auto To, typename Guard = void, typename Action = void>
+struct StaticTransition {
+  static constexpr auto from = From;  ///< Source state
+  static constexpr auto event = On;   ///< Event
+  static constexpr auto to = To;      ///< Target state
+  using guard = Guard;                ///< Guard tag (void if none)
+  using action = Action;              ///< Action tag (void if none)
+};
+
+/**
+ * @brief Compile-time list of StaticTransition rows
+ */
+template <typename... Rows>
+struct StaticTransitionTable {
+  static constexpr size_t size = sizeof...(Rows);  ///< Number of rows
+};
+
+namespace detail {
+
+template <typename State, typename Event, typename... Rows>
+constexpr bool hasUniqueRows(StaticTransitionTable<Rows...> /*table*/) {
+  if constexpr (sizeof...(Rows) < 2) {
+    return true;
+  } else {
+    constexpr std::array<std::pair<State, Event>, sizeof...(Rows)> keys = {{{Rows::from, Rows::event}...}};
+    for (size_t i = 0; i < keys.size(); ++i) {
+      for (size_t j = i + 1; j < keys.size(); ++j) {
+        if (keys[i] == keys[j]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Requirements for a StaticStateMachine definition
+ *
+ * A definition provides `State` and `Event` enumerations, `initial_state`,
+ * `state_names`/`event_names` arrays indexed by enumerator value, and a
+ * `transitions` StaticTransitionTable.
+ */
+template <typename Def>
+concept StaticMachineDefinition = requires {
+  typename Def::State;
+  typename Def::Event;
+  typename Def::transitions;
+  { Def::initial_state } -> std::convertible_to<typename Def::State>;
+  { Def::state_names[0] } -> std::convertible_to<std::string_view>;
+  { Def::event_names[0] } -> std::convertible_to<std::string_view>;
+};
+
+/**
+ * @class StaticStateMachine
+ * @brief Header-only state machine resolved entirely at compile time
+ * @tparam Definition Type satisfying StaticMachineDefinition
+ * @tparam Handler Type implementing guards, actions and optional hooks
+ *
+ * StaticStateMachine provides:
+ * - Dispatch over a compile-time transition table, without virtual calls,
+ *   std::function or map lookups
+ * - Guards and actions resolved by overload: `bool guard(Tag)`, `void action(Tag)`
+ * - Optional `void onExit(State)` and `void onEnter(State)` handler hooks
+ * - The StateMachine lifecycle, observer and variable API, so machines can be
+ *   migrated one at a time
+ *
+ * Transition order matches StateMachine: guard, on_exit, exit observers, action,
+ * state switch, on_enter, enter observers, transition observers. Observers are
+ * only notified (and names only converted to std::string) when any are registered.
+ * Like StateMachine, this class has no internal synchronization.
+ */
+template <StaticMachineDefinition Definition, typename Handler>
+class StaticStateMachine {
+ public:
+  using State = typename Definition::State;  ///< State enumeration
+  using Event = typename Definition::Event;  ///< Event enumeration
+
+  static_assert(detail::hasUniqueRows<State, Event>(typename Definition::transitions{}),
+                "Duplicate transition (same source state and event) in static transition table");
+
+  /**
+   * @brief Constructor
+   * @param handler Handler instance; must outlive the machine
+   */
+  explicit StaticStateMachine(Handler& handler) : handler_(handler) {}
+
+  // Lifecycle
+
+  /**
+   * @brief Start the finite state machine
+   * @throws StateException if machine is already running
+   */
+  void start() {
+    if (started_) {
+      fail("StateMachine is already started");
+    }
+    current_ = Definition::initial_state;
+    has_state_ = true;
+    callEnter(current_);
+    if (!observers_.empty()) {
+      notify([this](StateObserver& observer) { observer.onStateEnter(getCurrentStateName()); });
+    }
+    started_ = true;
+  }
+
+  /**
+   * @brief Stop the finite state machine
+   * @throws StateException if machine is not running
+   */
+  void stop() {
+    if (!started_) {
+      fail("StateMachine is not started");
+    }
+    callExit(current_);
+    if (!observers_.empty()) {
+      notify([this](StateObserver& observer) { observer.onStateExit(getCurrentStateName()); });
+    }
+    started_ = false;
+  }
+
+  /**
+   * @brief Reset finite state machine to initial state
+   */
+  void reset() {
+    if (started_) {
+      stop();
+    }
+    current_ = Definition::initial_state;
+    has_state_ = false;
+  }
+
+  /**
+   * @brief Check if machine is running
+   * @return true if started
+   */
+  [[nodiscard]] bool isStarted() const noexcept { return started_; }
+
+  // State queries
+
+  /**
+   * @brief Get current state
+   * @return Current state enumerator
+   */
+  [[nodiscard]] constexpr State getCurrentState() const noexcept { return current_; }
+
+  /**
+   * @brief Get current state name
+   * @return Current state name, empty before start() and after reset()
+   */
+  [[nodiscard]] std::string getCurrentStateName() const {
+    return has_state_ ? std::string(stateName(current_)) : std::string();
+  }
+
+  /**
+   * @brief Get state name
+   * @param state State enumerator
+   * @return Name from Definition::state_names
+   */
+  [[nodiscard]] static constexpr std::string_view stateName(State state) noexcept {
+    return Definition::state_names[static_cast<size_t>(state)];
+  }
+
+  /**
+   * @brief Get event name
+   * @param event Event enumerator
+   * @return Name from Definition::event_names
+   */
+  [[nodiscard]] static constexpr std::string_view eventName(Event event) noexcept {
+    return Definition::event_names[static_cast<size_t>(event)];
+  }
+
+  // Event handling
+
+  /**
+   * @brief Trigger event
+   * @param event Event enumerator
+   * @return true if a transition was performed
+   * @throws StateException if machine is not running
+   */
+  bool triggerEvent(Event event) {
+    if (!started_) {
+      fail("StateMachine is not started");
+    }
+    return dispatch(event, typename Definition::transitions{});
+  }
+
+  /**
+   * @brief Trigger event by name
+   * @param event_name Event name
+   * @return true if a transition was performed; unknown events are ignored
+   * @throws StateException if machine is not running
+   */
+  bool triggerEvent(std::string_view event_name) {
+    for (size_t i = 0; i < Definition::event_names.size(); ++i) {
+      if (Definition::event_names[i] == event_name) {
+        return triggerEvent(static_cast<Event>(i));
+      }
+    }
+    if (!started_) {
+      fail("StateMachine is not started");
+    }
+    return false;
+  }
+
+  // Variable management (same scoping rules as StateMachine)
+
+  /**
+   * @brief Set variable value
+   *
+   * Sets a local variable of the current state once started, otherwise a global variable.
+   *
+   * @param name Variable name
+   * @param value Variable value
+   */
+  void setVariable(const std::string& name, const VariableValue& value) {
+    if (has_state_) {
+      variables_.setStateVariable(std::string(stateName(current_)), name, value);
+    } else {
+      variables_.setGlobalVariable(name, value);
+    }
+  }
+
+  /**
+   * @brief Get variable value
+   * @param name Variable name
+   * @return Variable value
+   * @throws StateException if variable does not exist
+   */
+  [[nodiscard]] VariableValue getVariable(const std::string& name) const {
+    auto value = variables_.getVariable(getCurrentStateName(), name);
+    if (!value) {
+      fail("Variable '" + name + "' not found");
+    }
+    return *value;
+  }
+
+  /**
+   * @brief Check if variable exists
+   * @param name Variable name
+   * @return true if variable exists
+   */
+  [[nodiscard]] bool hasVariable(const std::string& name) const {
+    return variables_.hasVariable(getCurrentStateName(), name);
+  }
+
+  /**
+   * @brief Get variable manager
+   * @return Reference to variable manager
+   */
+  [[nodiscard]] VariableManager& variables() noexcept { return variables_; }
+
+  // Observers
+
+  /**
+   * @brief Register state change observer
+   * @param observer Shared pointer to observer (stored as weak_ptr)
+   */
+  void registerStateObserver(const std::shared_ptr<StateObserver>& observer) {
+    if (!observer) {
+      return;
+    }
+    for (const auto& weak_obs : observers_) {
+      if (weak_obs.lock() == observer) {
+        return;
+      }
+    }
+    observers_.push_back(observer);
+  }
+
+  /**
+   * @brief Unregister observer
+   * @param observer Shared pointer to observer
+   */
+  void unregisterStateObserver(const std::shared_ptr<StateObserver>& observer) {
+    if (!observer) {
+      return;
+    }
+    observers_.erase(std::remove_if(observers_.begin(), observers_.end(),
+                                    [&observer](const std::weak_ptr<StateObserver>& weak_obs) {
+                                      auto existing = weak_obs.lock();
+                                      return existing && existing == observer;
+                                    }),
+                     observers_.end());
+  }
+
+  // Error handling
+
+  /**
+   * @brief Set error handler
+   * @param handler Error handler function
+   */
+  void setErrorHandler(ErrorHandler handler) { error_handler_ = std::move(handler); }
+
+ private:
+  Handler& handler_;
+  State current_ = Definition::initial_state;
+  bool started_ = false;
+  bool has_state_ = false;
+  VariableManager variables_;
+  std::vector<std::weak_ptr<StateObserver>> observers_;
+  ErrorHandler error_handler_;
+
+  [[noreturn]] void fail(const std::string& error) const {
+    if (error_handler_) {
+      error_handler_(error);
+    }
+    throw StateException(error);
+  }
+
+  void callEnter(State state) {
+    if constexpr (requires(Handler& h) { h.onEnter(state); }) {
+      handler_.onEnter(state);
+    }
+  }
+
+  void callExit(State state) {
+    if constexpr (requires(Handler& h) { h.onExit(state); }) {
+      handler_.onExit(state);
+    }
+  }
+
+  template <typename Fn>
+  void notify(Fn&& fn) {
+    observers_.erase(std::remove_if(observers_.begin(), observers_.end(),
+                                    [](const std::weak_ptr<StateObserver>& weak_obs) { return weak_obs.expired(); }),
+                     observers_.end());
+    for (const auto& weak_obs : observers_) {
+      if (auto observer = weak_obs.lock()) {
+        fn(*observer);
+      }
+    }
+  }
+
+  template <typename... Rows>
+  bool dispatch(Event event, StaticTransitionTable<Rows...> /*table*/) {
+    bool transitioned = false;
+    static_cast<void>(
+        ((current_ == Rows::from && event == Rows::event ? (transitioned = fire<Rows>(), true) : false) || ...));
+    return transitioned;
+  }
+
+  template <typename Row>
+  bool fire() {
+    if constexpr (!std::is_void_v<typename Row::guard>) {
+      static_assert(requires(Handler& h) {
+        { h.guard(typename Row::guard{}) } -> std::convertible_to<bool>;
+      }, "Handler must implement bool guard(Tag) for every guard tag of the definition");
+      if (!handler_.guard(typename Row::guard{})) {
+        return false;
+      }
+    }
+
+    callExit(Row::from);
+    if (!observers_.empty()) {
+      notify([](StateObserver& observer) { observer.onStateExit(std::string(stateName(Row::from))); });
+    }
+
+    if constexpr (!std::is_void_v<typename Row::action>) {
+      static_assert(requires(Handler& h) { h.action(typename Row::action{}); },
+                    "Handler must implement void action(Tag) for every action tag of the definition");
+      handler_.action(typename Row::action{});
+    }
+
+    current_ = Row::to;
+    callEnter(Row::to);
+
+    if (!observers_.empty()) {
+      notify([](StateObserver& observer) { observer.onStateEnter(std::string(stateName(Row::to))); });
+
+      TransitionEvent event;
+      event.event_name = eventName(Row::event);
+      event.from_state = stateName(Row::from);
+      event.to_state = stateName(Row::to);
+      event.timestamp = std::chrono::system_clock::now();
+      notify([&event](StateObserver& observer) { observer.onTransition(event); });
+    }
+    return true;
+  }
+};
+
+}  // namespace fsmconfig
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "delegate.hpp"
+
+namespace fsmconfig {
+
+/**
+ * @file timer_service.hpp
+ * @brief Hierarchical timing wheel for timeout transitions
+ */
+
+/// Handle of a scheduled timer (INVALID_TIMER is never returned by schedule())
+using TimerId = uint64_t;
+
+/// Handle value meaning "no timer"
+inline constexpr TimerId INVALID_TIMER = 0;
+
+/// Callback run when a timer expires
+using TimerCallback = Delegate<void()>;
+
+/**
+ * @class TimerService
+ * @brief One-shot timers on a hierarchical timing wheel
+ *
+ * TimerService provides:
+ * - O(1) schedule() and cancel(): timers are intrusive list nodes in wheel
+ *   slots, recycled through a free list, so arming allocates nothing once warm
+ * - Five wheel levels (256 + 4 x 64 slots) covering 2^32 ticks; timers move to
+ *   finer levels as their deadline approaches, longer delays are re-cascaded
+ * - Either a background thread driven by the steady clock (start()) or manual
+ *   time control with advance(), which makes timeouts testable
+ *
+ * Time is counted in ticks; a timer fires on the first tick at or after its
+ * delay, rounded up to whole ticks. Callbacks run outside the service lock, on
+ * the background thread or the thread calling advance(), and may schedule or
+ * cancel timers. Callbacks must not throw, call advance(), start() or stop().
+ *
+ * StateMachine::setTimerService() uses it to fire 'after' transitions.
+ */
+class TimerService {
+ public:
+  /// Clock driving the background thread
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Constructor, time starts at tick 0 and stands still until start() or advance()
+   * @param tick Wheel resolution (must be positive)
+   * @throws StateException if tick is not positive
+   */
+  explicit TimerService(std::chrono::milliseconds tick = std::chrono::milliseconds(1));
+
+  /**
+   * @brief Destructor, stops the background thread; pending timers never fire
+   */
+  ~TimerService();
+
+  // Copy and move prohibition (callbacks refer to the service)
+  TimerService(const TimerService&) = delete;
+  TimerService& operator=(const TimerService&) = delete;
+  TimerService(TimerService&&) = delete;
+  TimerService& operator=(TimerService&&) = delete;
+
+  /**
+   * @brief Schedule one-shot timer (thread-safe)
+   * @param delay Time until expiry (at least one tick)
+   * @param callback Callback to run on expiry
+   * @return Handle for cancel()
+   */
+  TimerId schedule(std::chrono::milliseconds delay, TimerCallback callback);
+
+  /**
+   * @brief Cancel timer (thread-safe)
+   *
+   * If the callback is running on another thread, waits for it to return, so
+   * the callback's target may be destroyed afterwards.
+   *
+   * @param id Handle returned by schedule()
+   * @return true if the timer was pending and will not fire
+   */
+  bool cancel(TimerId id);
+
+  /**
+   * @brief Advance time manually and run expired callbacks on this thread
+   *
+   * Only valid while the background thread is stopped.
+   *
+   * @param elapsed Time to advance by; remainders below one tick are carried over
+   * @return Number of callbacks run
+   * @throws StateException if the background thread is running
+   */
+  size_t advance(std::chrono::milliseconds elapsed);
+
+  /**
+   * @brief Start background thread advancing time with the steady clock
+   */
+  void start();
+
+  /**
+   * @brief Stop background thread; time stands still until restarted
+   */
+  void stop();
+
+  /**
+   * @brief Check if the background thread is running
+   */
+  [[nodiscard]] bool isRunning() const;
+
+  /**
+   * @brief Get number of pending timers
+   */
+  [[nodiscard]] size_t getPendingCount() const;
+
+  /**
+   * @brief Get wheel resolution
+   */
+  [[nodiscard]] std::chrono::milliseconds getTick() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace fsmconfig
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace fsmconfig {
+
+/**
+ * @file tracer.hpp
+ * @brief Phase tracer with Chrome trace (Perfetto) export
+ */
+
+/**
+ * @brief Kind of trace record
+ */
+enum class TracePhase : std::uint8_t {
+  BEGIN,  ///< Span begin ("ph": "B")
+  END     ///< Span end ("ph": "E")
+};
+
+/**
+ * @brief Single trace record stored in a per-thread buffer
+ */
+struct TraceRecord {
+  const char* name;            ///< Span name (must have static storage duration)
+  std::uint64_t timestamp_ns;  ///< Nanoseconds since tracer epoch
+  TracePhase phase;            ///< Begin or end of the span
+};
+
+/**
+ * @class Tracer
+ * @brief Process-wide recorder of begin/end spans
+ *
+ * Tracer provides:
+ * - Per-thread record buffers written without locks by the owning thread
+ * - Runtime enable/disable switch
+ * - Export of all recorded spans as Chrome trace JSON, viewable in Perfetto
+ *
+ * Each thread appends to its own fixed-capacity buffer. The buffer is registered
+ * once per thread; after that, recording a span is a relaxed flag check, a clock
+ * read and a release store. When a buffer is full, further spans are dropped
+ * and counted instead of overwriting data that a concurrent dump may be reading;
+ * a span is kept only together with a slot reserved for its END, so exported
+ * spans stay balanced. If a buffer cannot be allocated, records of that thread
+ * are counted as dropped.
+ *
+ * StateMachine instrumentation is compiled in only when the library is built with
+ * FSMCONFIG_ENABLE_TRACING; otherwise FSMCONFIG_TRACE_SPAN expands to nothing.
+ */
+class Tracer {
+ public:
+  /// Default per-thread buffer capacity in records
+  static constexpr size_t DEFAULT_BUFFER_CAPACITY = 65536;
+
+  /**
+   * @brief Enable recording
+   */
+  static void enable();
+
+  /**
+   * @brief Disable recording
+   *
+   * Already recorded spans are kept until clear() is called.
+   */
+  static void disable();
+
+  /**
+   * @brief Check if recording is enabled
+   * @return true if spans are being recorded
+   */
+  [[nodiscard]] static bool isEnabled();
+
+  /**
+   * @brief Record span begin on the calling thread
+   * @param name Span name (must have static storage duration)
+   * @return true if the span was opened; then endSpan() must be called for it,
+   *         even if recording has been disabled in between
+   */
+  static bool beginSpan(const char* name) noexcept;
+
+  /**
+   * @brief Record span end on the calling thread
+   *
+   * Ends the innermost span opened by beginSpan(), whether or not recording is
+   * still enabled.
+   *
+   * @param name Span name (must have static storage duration)
+   */
+  static void endSpan(const char* name) noexcept;
+
+  /**
+   * @brief Write all recorded spans as Chrome trace JSON
+   * @param out Output stream
+   */
+  static void writeChromeTrace(std::ostream& out);
+
+  /**
+   * @brief Get all recorded spans as Chrome trace JSON
+   * @return JSON document
+   */
+  [[nodiscard]] static std::string toChromeTrace();
+
+  /**
+   * @brief Discard all recorded spans and reset the dropped counter
+   *
+   * Must not be called while other threads are recording spans. Spans open
+   * across the call are dropped: their ENDs are not recorded.
+   */
+  static void clear();
+
+  /**
+   * @brief Set capacity for buffers created after this call
+   * @param records Number of records per thread buffer
+   */
+  static void setBufferCapacity(size_t records);
+
+  /**
+   * @brief Get number of records currently stored across all threads
+   * @return Number of records
+   */
+  [[nodiscard]] static size_t getRecordCount();
+
+  /**
+   * @brief Get number of records dropped because a buffer was full or could not be allocated
+   * @return Number of dropped records
+   */
+  [[nodiscard]] static size_t getDroppedCount();
+};
+
+/**
+ * @class TraceSpan
+ * @brief RAII helper recording a begin record on construction and an end record on destruction
+ */
+class TraceSpan {
+ public:
+  /**
+   * @brief Constructor
+   * @param name Span name (must have static storage duration)
+   */
+  explicit TraceSpan(const char* name) noexcept : name_(name), open_(Tracer::beginSpan(name)) {}
+
+  /**
+   * @brief Destructor, ends the span if its begin was recorded or counted as dropped
+   */
+  ~TraceSpan() {
+    if (open_) {
+      Tracer::endSpan(name_);
+    }
+  }
+
+  // Copy and move prohibition
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+  TraceSpan(TraceSpan&&) = delete;
+  TraceSpan& operator=(TraceSpan&&) = delete;
+
+ private:
+  const char* name_;
+  bool open_;
+};
+
+}  // namespace fsmconfig
+
+#define FSMCONFIG_TRACE_CONCAT_IMPL(a, b) a##b
+#define FSMCONFIG_TRACE_CONCAT(a, b) FSMCONFIG_TRACE_CONCAT_IMPL(a, b)
+
+#if defined(FSMCONFIG_ENABLE_TRACING)
+/// Record a span covering the rest of the enclosing scope
+#define FSMCONFIG_TRACE_SPAN(name) \
+  const ::fsmconfig::TraceSpan FSMCONFIG_TRACE_CONCAT(fsmconfig_trace_span_, __LINE__)(name)
+#else
+/// Tracing disabled at build time: expands to nothing
+#define FSMCONFIG_TRACE_SPAN(name) static_cast<void>(0)
+#endif
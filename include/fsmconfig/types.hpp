@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <stdexcept>
@@ -203,6 +204,7 @@ struct TransitionInfo {
   std::string event_name;            ///< Event name
   std::string guard_callback;        ///< Guard callback
   std::string transition_callback;   ///< Transition callback
+  uint64_t after_ms = 0;             ///< Timeout in milliseconds (0 if triggered by event only)
   std::vector<std::string> actions;  ///< List of actions
 
   /**
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "fsmconfig/types.hpp"
+
+namespace fsmconfig::detail {
+
+/**
+ * @file binary_io.hpp
+ * @brief Portable binary encoding for persisted images (library internal)
+ */
+
+/**
+ * @class BinaryWriter
+ * @brief Appends fixed-width little-endian values and length-prefixed strings to a buffer
+ */
+class BinaryWriter {
+ public:
+  void u8(uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+
+  void u32(uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+      u8(static_cast<uint8_t>(value >> shift));
+    }
+  }
+
+  void u64(uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+      u8(static_cast<uint8_t>(value >> shift));
+    }
+  }
+
+  void i32(int32_t value) { u32(static_cast<uint32_t>(value)); }
+
+  void f32(float value) { u32(std::bit_cast<uint32_t>(value)); }
+
+  void str(std::string_view value) {
+    u32(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+  }
+
+  /**
+   * @brief Append an array of u32 values (one copy on little-endian hosts)
+   */
+  void u32s(std::span<const uint32_t> values) {
+    if constexpr (std::endian::native == std::endian::little) {
+      buffer_.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+    } else {
+      for (const uint32_t value : values) {
+        u32(value);
+      }
+    }
+  }
+
+  /**
+   * @brief Reserve space for bytes about to be written
+   */
+  void reserve(size_t size) { buffer_.reserve(buffer_.size() + size); }
+
+  /**
+   * @brief Get encoded bytes
+   */
+  [[nodiscard]] const std::string& data() const { return buffer_; }
+
+  /**
+   * @brief Move encoded bytes out, leaving the writer empty
+   */
+  [[nodiscard]] std::string take() { return std::move(buffer_); }
+
+ private:
+  std::string buffer_;
+};
+
+/**
+ * @class BinaryReader
+ * @brief Reads values written by BinaryWriter
+ *
+ * Strings are returned as views into the source buffer, which must outlive
+ * them. Reading past the end throws ConfigException.
+ */
+class BinaryReader {
+ public:
+  explicit BinaryReader(std::string_view data) : data_(data) {}
+
+  uint8_t u8() {
+    require(1);
+    return static_cast<uint8_t>(data_[offset_++]);
+  }
+
+  uint32_t u32() {
+    require(4);
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+      value |= static_cast<uint32_t>(static_cast<uint8_t>(data_[offset_++])) << shift;
+    }
+    return value;
+  }
+
+  uint64_t u64() {
+    require(8);
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 8) {
+      value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[offset_++])) << shift;
+    }
+    return value;
+  }
+
+  int32_t i32() { return static_cast<int32_t>(u32()); }
+
+  float f32() { return std::bit_cast<float>(u32()); }
+
+  std::string_view str() {
+    const uint32_t size = u32();
+    require(size);
+    const std::string_view value = data_.substr(offset_, size);
+    offset_ += size;
+    return value;
+  }
+
+  /**
+   * @brief Read an array of u32 values written by BinaryWriter::u32s()
+   */
+  void u32s(std::span<uint32_t> values) {
+    require(values.size_bytes());
+    if constexpr (std::endian::native == std::endian::little) {
+      std::memcpy(values.data(), data_.data() + offset_, values.size_bytes());
+      offset_ += values.size_bytes();
+    } else {
+      for (uint32_t& value : values) {
+        value = u32();
+      }
+    }
+  }
+
+  /**
+   * @brief Read element count, rejecting counts the remaining bytes cannot hold
+   * @param min_element_size Lower bound of the encoded size of one element
+   */
+  uint32_t count(size_t min_element_size) {
+    const uint32_t value = u32();
+    if (min_element_size > 0 && value > (data_.size() - offset_) / min_element_size) {
+      throw ConfigException("Binary image is truncated");
+    }
+    return value;
+  }
+
+  [[nodiscard]] bool atEnd() const { return offset_ == data_.size(); }
+
+ private:
+  void require(size_t size) const {
+    if (size > data_.size() - offset_) {
+      throw ConfigException("Binary image is truncated");
+    }
+  }
+
+  std::string_view data_;
+  size_t offset_ = 0;
+};
+
+}  // namespace fsmconfig::detail
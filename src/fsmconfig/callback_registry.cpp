@@ -1,7 +1,9 @@
 #include "fsmconfig/callback_registry.hpp"
 
-#include <functional>
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -12,21 +14,37 @@ namespace fsmconfig {
  */
 class CallbackRegistry::Impl {
  public:
+  // Callbacks are shared so resolved callbacks outlive re-registration
+
   /// State callbacks: key = "state_name:callback_type"
-  std::map<std::string, StateCallback> state_callbacks;
+  std::map<std::string, std::shared_ptr<const StateCallback>> state_callbacks;
 
   /// Transition callbacks: key = "from_state:to_state"
-  std::map<std::string, TransitionCallback> transition_callbacks;
+  std::map<std::string, std::shared_ptr<const TransitionCallback>> transition_callbacks;
 
   /// Guard callbacks: key = "from_state:to_state:event_name"
-  std::map<std::string, GuardCallback> guards;
+  std::map<std::string, std::shared_ptr<const GuardCallback>> guards;
 
   /// Action callbacks: key = "action_name"
-  std::map<std::string, ActionCallback> actions;
+  std::map<std::string, std::shared_ptr<const ActionCallback>> actions;
+
+  /**
+   * @brief Find callback by key
+   * @return Registered callback or nullptr
+   */
+  template <typename Callback>
+  static std::shared_ptr<const Callback> find(const std::map<std::string, std::shared_ptr<const Callback>>& callbacks,
+                                              const std::string& key) {
+    auto iter = callbacks.find(key);
+    return iter != callbacks.end() ? iter->second : nullptr;
+  }
 
   /// Mutex for thread safety
   mutable std::mutex mutex;
 
+  /// Bumped on every registration change
+  std::atomic<uint64_t> generation{0};
+
   /**
    * @brief Clear all callbacks
    */
@@ -35,6 +53,7 @@ class CallbackRegistry::Impl {
     transition_callbacks.clear();
     guards.clear();
     actions.clear();
+    generation.fetch_add(1, std::memory_order_release);
   }
 };
 
@@ -67,7 +86,8 @@ void CallbackRegistry::registerStateCallback(const std::string& state_name, cons
 
   const std::scoped_lock lock(impl_->mutex);
   const std::string key = makeStateCallbackKey(state_name, callback_type);
-  impl_->state_callbacks[key] = std::move(callback);
+  impl_->state_callbacks[key] = std::make_shared<const StateCallback>(std::move(callback));
+  impl_->generation.fetch_add(1, std::memory_order_release);
 }
 
 void CallbackRegistry::registerTransitionCallback(const std::string& from_state, const std::string& to_state,
@@ -78,7 +98,8 @@ void CallbackRegistry::registerTransitionCallback(const std::string& from_state,
 
   const std::scoped_lock lock(impl_->mutex);
   const std::string key = makeTransitionCallbackKey(from_state, to_state);
-  impl_->transition_callbacks[key] = std::move(callback);
+  impl_->transition_callbacks[key] = std::make_shared<const TransitionCallback>(std::move(callback));
+  impl_->generation.fetch_add(1, std::memory_order_release);
 }
 
 void CallbackRegistry::registerGuard(const std::string& from_state, const std::string& to_state,
@@ -89,7 +110,8 @@ void CallbackRegistry::registerGuard(const std::string& from_state, const std::s
 
   const std::scoped_lock lock(impl_->mutex);
   const std::string key = makeGuardKey(from_state, to_state, event_name);
-  impl_->guards[key] = std::move(callback);
+  impl_->guards[key] = std::make_shared<const GuardCallback>(std::move(callback));
+  impl_->generation.fetch_add(1, std::memory_order_release);
 }
 
 void CallbackRegistry::registerAction(const std::string& action_name, ActionCallback callback) {
@@ -98,7 +120,8 @@ void CallbackRegistry::registerAction(const std::string& action_name, ActionCall
   }
 
   const std::scoped_lock lock(impl_->mutex);
-  impl_->actions[action_name] = std::move(callback);
+  impl_->actions[action_name] = std::make_shared<const ActionCallback>(std::move(callback));
+  impl_->generation.fetch_add(1, std::memory_order_release);
 }
 
 // ============================================================================
@@ -110,8 +133,8 @@ void CallbackRegistry::callStateCallback(const std::string& state_name, const st
   const std::string key = makeStateCallbackKey(state_name, callback_type);
 
   auto iter = impl_->state_callbacks.find(key);
-  if (iter != impl_->state_callbacks.end() && iter->second) {
-    iter->second();
+  if (iter != impl_->state_callbacks.end()) {
+    (*iter->second)();
   }
 }
 
@@ -121,8 +144,8 @@ void CallbackRegistry::callTransitionCallback(const std::string& from_state, con
   const std::string key = makeTransitionCallbackKey(from_state, to_state);
 
   auto iter = impl_->transition_callbacks.find(key);
-  if (iter != impl_->transition_callbacks.end() && iter->second) {
-    iter->second(event);
+  if (iter != impl_->transition_callbacks.end()) {
+    (*iter->second)(event);
   }
 }
 
@@ -132,8 +155,8 @@ bool CallbackRegistry::callGuard(const std::string& from_state, const std::strin
   const std::string key = makeGuardKey(from_state, to_state, event_name);
 
   auto iter = impl_->guards.find(key);
-  if (iter != impl_->guards.end() && iter->second) {
-    return iter->second();
+  if (iter != impl_->guards.end()) {
+    return (*iter->second)();
   }
   // If guard is not registered, deny transition
   return false;
@@ -143,8 +166,8 @@ void CallbackRegistry::callAction(const std::string& action_name) const {
   const std::scoped_lock lock(impl_->mutex);
 
   auto iter = impl_->actions.find(action_name);
-  if (iter != impl_->actions.end() && iter->second) {
-    iter->second();
+  if (iter != impl_->actions.end()) {
+    (*iter->second)();
   }
 }
 
@@ -156,16 +179,14 @@ bool CallbackRegistry::hasStateCallback(const std::string& state_name, const std
   const std::scoped_lock lock(impl_->mutex);
   const std::string key = makeStateCallbackKey(state_name, callback_type);
 
-  auto iter = impl_->state_callbacks.find(key);
-  return iter != impl_->state_callbacks.end() && static_cast<bool>(iter->second);
+  return impl_->state_callbacks.contains(key);
 }
 
 bool CallbackRegistry::hasTransitionCallback(const std::string& from_state, const std::string& to_state) const {
   const std::scoped_lock lock(impl_->mutex);
   const std::string key = makeTransitionCallbackKey(from_state, to_state);
 
-  auto iter = impl_->transition_callbacks.find(key);
-  return iter != impl_->transition_callbacks.end() && static_cast<bool>(iter->second);
+  return impl_->transition_callbacks.contains(key);
 }
 
 bool CallbackRegistry::hasGuard(const std::string& from_state, const std::string& to_state,
@@ -173,17 +194,45 @@ bool CallbackRegistry::hasGuard(const std::string& from_state, const std::string
   const std::scoped_lock lock(impl_->mutex);
   const std::string key = makeGuardKey(from_state, to_state, event_name);
 
-  auto iter = impl_->guards.find(key);
-  return iter != impl_->guards.end() && static_cast<bool>(iter->second);
+  return impl_->guards.contains(key);
 }
 
 bool CallbackRegistry::hasAction(const std::string& action_name) const {
   const std::scoped_lock lock(impl_->mutex);
 
-  auto iter = impl_->actions.find(action_name);
-  return iter != impl_->actions.end() && static_cast<bool>(iter->second);
+  return impl_->actions.contains(action_name);
+}
+
+// ============================================================================
+// Resolution methods
+// ============================================================================
+
+std::shared_ptr<const StateCallback> CallbackRegistry::resolveStateCallback(const std::string& state_name,
+                                                                            const std::string& callback_type) const {
+  const std::scoped_lock lock(impl_->mutex);
+  return Impl::find(impl_->state_callbacks, makeStateCallbackKey(state_name, callback_type));
 }
 
+std::shared_ptr<const TransitionCallback> CallbackRegistry::resolveTransitionCallback(
+    const std::string& from_state, const std::string& to_state) const {
+  const std::scoped_lock lock(impl_->mutex);
+  return Impl::find(impl_->transition_callbacks, makeTransitionCallbackKey(from_state, to_state));
+}
+
+std::shared_ptr<const GuardCallback> CallbackRegistry::resolveGuard(const std::string& from_state,
+                                                                    const std::string& to_state,
+                                                                    const std::string& event_name) const {
+  const std::scoped_lock lock(impl_->mutex);
+  return Impl::find(impl_->guards, makeGuardKey(from_state, to_state, event_name));
+}
+
+std::shared_ptr<const ActionCallback> CallbackRegistry::resolveAction(const std::string& action_name) const {
+  const std::scoped_lock lock(impl_->mutex);
+  return Impl::find(impl_->actions, action_name);
+}
+
+uint64_t CallbackRegistry::getGeneration() const { return impl_->generation.load(std::memory_order_acquire); }
+
 // ============================================================================
 // Management methods
 // ============================================================================
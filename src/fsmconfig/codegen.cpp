@@ -0,0 +1,383 @@
+#include "fsmconfig/codegen.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config_stream.hpp"
+#include "fsmconfig/config_parser.hpp"
+#include "fsmconfig/types.hpp"
+
+namespace fsmconfig {
+
+namespace {
+
+/// C++ keywords that cannot be used as generated identifiers
+constexpr auto CPP_KEYWORDS = std::to_array<std::string_view>({
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+    "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+    "constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+    "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+    "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+    "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+    "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch",
+    "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned",
+    "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"});
+
+/**
+ * @brief Map an arbitrary configuration name to a valid C++ identifier
+ */
+std::string toIdentifier(const std::string& name) {
+  std::string result;
+  result.reserve(name.size() + 1);
+  for (const char c : name) {
+    result += (std::isalnum(static_cast<unsigned char>(c)) != 0) ? c : '_';
+  }
+  if (result.empty() || (std::isdigit(static_cast<unsigned char>(result.front())) != 0)) {
+    result.insert(result.begin(), 'n');
+  }
+  if (std::find(CPP_KEYWORDS.begin(), CPP_KEYWORDS.end(), result) != CPP_KEYWORDS.end()) {
+    result += '_';
+  }
+  return result;
+}
+
+/**
+ * @brief Assign unique identifiers to a list of names
+ * @throws ConfigException if two names map to the same identifier
+ */
+std::map<std::string, std::string> makeIdentifiers(const std::vector<std::string>& names, const std::string& kind) {
+  std::map<std::string, std::string> result;
+  std::map<std::string, std::string> owners;
+  for (const auto& name : names) {
+    std::string id = toIdentifier(name);
+    auto [it, inserted] = owners.emplace(id, name);
+    if (!inserted && it->second != name) {
+      throw ConfigException("Cannot generate code: " + kind + " names '" + it->second + "' and '" + name +
+                            "' map to the same identifier '" + id + "'");
+    }
+    result[name] = std::move(id);
+  }
+  return result;
+}
+
+/**
+ * @brief Smallest unsigned type that can enumerate count values
+ */
+std::string underlyingType(size_t count) {
+  if (count <= 0x100) {
+    return "std::uint8_t";
+  }
+  if (count <= 0x10000) {
+    return "std::uint16_t";
+  }
+  return "std::uint32_t";
+}
+
+std::string quoted(const std::string& text) {
+  std::string result = "\"";
+  for (const char c : text) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  result += '"';
+  return result;
+}
+
+void writeActions(std::ostringstream& out, const std::string& indent, const std::vector<std::string>& actions) {
+  for (const auto& action : actions) {
+    out << indent << "handler_." << toIdentifier(action) << "();\n";
+  }
+}
+
+void writeEnter(std::ostringstream& out, const std::string& indent, const StateInfo& state) {
+  if (!state.on_enter_callback.empty()) {
+    out << indent << "handler_." << toIdentifier(state.on_enter_callback) << "();\n";
+  }
+  writeActions(out, indent, state.actions);
+}
+
+/**
+ * @brief Check whether a transition is a timeout declared without 'event'
+ *
+ * Such transitions carry the synthesized "after <timeout>" event name, which
+ * only the timer is meant to send.
+ */
+bool isTimeoutOnly(const TransitionInfo& transition) {
+  constexpr std::string_view prefix = "after ";
+  const std::string_view event = transition.event_name;
+  return transition.after_ms != 0 && event.starts_with(prefix) &&
+         detail::parseDuration(event.substr(prefix.size())) == transition.after_ms;
+}
+
+/**
+ * @brief Write the body of a transition taken from source: guard, on_exit, actions, on_transition, on_enter
+ */
+void writeTransition(std::ostringstream& out, const std::string& indent, const StateInfo& source,
+                     const StateInfo& target, const TransitionInfo& transition,
+                     const std::map<std::string, std::string>& state_ids) {
+  if (!transition.guard_callback.empty()) {
+    out << indent << "if (!handler_." << toIdentifier(transition.guard_callback) << "()) {\n";
+    out << indent << "  return false;\n";
+    out << indent << "}\n";
+  }
+  if (!source.on_exit_callback.empty()) {
+    out << indent << "handler_." << toIdentifier(source.on_exit_callback) << "();\n";
+  }
+  writeActions(out, indent, transition.actions);
+  if (!transition.transition_callback.empty()) {
+    out << indent << "handler_." << toIdentifier(transition.transition_callback) << "();\n";
+  }
+  out << indent << "state_ = State::" << state_ids.at(transition.to_state) << ";\n";
+  writeEnter(out, indent, target);
+  out << indent << "return true;\n";
+}
+
+}  // namespace
+
+std::string generateStaticMachine(const ConfigParser& parser, const CodegenOptions& options) {
+  const auto& states = parser.getStates();
+  const auto& transitions = parser.getTransitions();
+  if (states.empty()) {
+    throw ConfigException("Cannot generate code: configuration has no states");
+  }
+
+  const std::string initial_state = parser.getInitialState();
+  if (!parser.hasState(initial_state)) {
+    throw ConfigException("Cannot generate code: initial state '" + initial_state + "' not found");
+  }
+
+  // Validate namespace: identifiers separated by "::"
+  const std::string& ns = options.namespace_name;
+  for (size_t pos = 0;;) {
+    const size_t next = ns.find("::", pos);
+    const std::string part = ns.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+    if (part.empty() || toIdentifier(part) != part) {
+      throw ConfigException("Cannot generate code: invalid namespace '" + ns + "'");
+    }
+    if (next == std::string::npos) {
+      break;
+    }
+    pos = next + 2;
+  }
+
+  std::vector<std::string> state_names;
+  state_names.reserve(states.size());
+  for (const auto& [name, info] : states) {
+    state_names.push_back(name);
+  }
+
+  // Timeout ('after') transitions get their own table and expire(); those with an explicit event are dispatched too
+  std::vector<const TransitionInfo*> event_transitions;
+  std::vector<const TransitionInfo*> timeout_transitions;
+  for (const auto& transition : transitions) {
+    if (!isTimeoutOnly(transition)) {
+      event_transitions.push_back(&transition);
+    }
+    if (transition.after_ms != 0) {
+      timeout_transitions.push_back(&transition);
+    }
+  }
+
+  std::vector<std::string> event_names;
+  std::set<std::string> seen_events;
+  for (const TransitionInfo* transition : event_transitions) {
+    if (seen_events.insert(transition->event_name).second) {
+      event_names.push_back(transition->event_name);
+    }
+  }
+
+  const auto state_ids = makeIdentifiers(state_names, "state");
+  const auto event_ids = makeIdentifiers(event_names, "event");
+
+  std::ostringstream out;
+  out << "// Generated by fsmconfig_codegen";
+  if (!options.source_name.empty()) {
+    out << " from " << options.source_name;
+  }
+  out << ". Do not edit.\n";
+  out << "#pragma once\n\n";
+  out << "#include <array>\n#include <cstddef>\n#include <cstdint>\n#include <string_view>\n\n";
+  out << "namespace " << ns << " {\n\n";
+
+  // Enumerations
+  out << "/// States\n";
+  out << "enum class State : " << underlyingType(state_names.size()) << " {\n";
+  for (const auto& name : state_names) {
+    out << "  " << state_ids.at(name) << ",\n";
+  }
+  out << "};\n\n";
+
+  out << "/// Events\n";
+  out << "enum class Event : " << underlyingType(std::max<size_t>(event_names.size(), 1)) << " {\n";
+  for (const auto& name : event_names) {
+    out << "  " << event_ids.at(name) << ",\n";
+  }
+  out << "};\n\n";
+
+  out << "/// Number of states\n";
+  out << "inline constexpr std::size_t state_count = " << state_names.size() << ";\n\n";
+  out << "/// Number of events\n";
+  out << "inline constexpr std::size_t event_count = " << event_names.size() << ";\n\n";
+  out << "/// Initial state\n";
+  out << "inline constexpr State initial_state = State::" << state_ids.at(initial_state) << ";\n\n";
+
+  // Name tables
+  out << "/// State names as written in the configuration\n";
+  out << "inline constexpr std::array<std::string_view, state_count> state_names = {\n";
+  for (const auto& name : state_names) {
+    out << "    " << quoted(name) << ",\n";
+  }
+  out << "};\n\n";
+
+  out << "/// Event names as written in the configuration\n";
+  out << "inline constexpr std::array<std::string_view, event_count> event_names = {";
+  if (!event_names.empty()) {
+    out << "\n";
+    for (const auto& name : event_names) {
+      out << "    " << quoted(name) << ",\n";
+    }
+  }
+  out << "};\n\n";
+
+  out << "/// Get state name\n";
+  out << "constexpr std::string_view toString(State state) noexcept {\n";
+  out << "  return state_names[static_cast<std::size_t>(state)];\n}\n\n";
+  out << "/// Get event name\n";
+  out << "constexpr std::string_view toString(Event event) noexcept {\n";
+  out << "  return event_names[static_cast<std::size_t>(event)];\n}\n\n";
+
+  // Transition table
+  out << "/// Transition table entry\n";
+  out << "struct Transition {\n  State from;\n  Event event;\n  State to;\n  bool guarded;\n};\n\n";
+  out << "/// Transition table\n";
+  out << "inline constexpr std::array<Transition, " << event_transitions.size() << "> transitions = {{";
+  if (!event_transitions.empty()) {
+    out << "\n";
+    for (const TransitionInfo* transition : event_transitions) {
+      out << "    {State::" << state_ids.at(transition->from_state) << ", Event::"
+          << event_ids.at(transition->event_name) << ", State::" << state_ids.at(transition->to_state) << ", "
+          << (transition->guard_callback.empty() ? "false" : "true") << "},\n";
+    }
+  }
+  out << "}};\n\n";
+
+  // Timeout table
+  out << "/// Timeout transition entry: taken once 'from' has been active for after_ms milliseconds\n";
+  out << "struct Timeout {\n  State from;\n  State to;\n  std::uint64_t after_ms;\n  bool guarded;\n};\n\n";
+  out << "/// Timeout transitions, indexed as in Machine::expire()\n";
+  out << "inline constexpr std::array<Timeout, " << timeout_transitions.size() << "> timeouts = {{";
+  if (!timeout_transitions.empty()) {
+    out << "\n";
+    for (const TransitionInfo* transition : timeout_transitions) {
+      out << "    {State::" << state_ids.at(transition->from_state) << ", State::"
+          << state_ids.at(transition->to_state) << ", " << transition->after_ms << ", "
+          << (transition->guard_callback.empty() ? "false" : "true") << "},\n";
+    }
+  }
+  out << "}};\n\n";
+
+  // Machine
+  out << "/**\n";
+  out << " * @brief Statically dispatched state machine\n";
+  out << " * @tparam Handler Type providing hook member functions named as in the configuration\n";
+  out << " */\n";
+  out << "template <typename Handler>\n";
+  out << "class Machine {\n";
+  out << " public:\n";
+  out << "  explicit constexpr Machine(Handler& handler) noexcept : handler_(handler) {}\n\n";
+
+  out << "  /// Enter the initial state, running its on_enter hook and actions\n";
+  out << "  void start() {\n";
+  out << "    state_ = initial_state;\n";
+  out << "    switch (state_) {\n";
+  for (const auto& [name, info] : states) {
+    if (info.on_enter_callback.empty() && info.actions.empty()) {
+      continue;
+    }
+    out << "      case State::" << state_ids.at(name) << ":\n";
+    writeEnter(out, "        ", info);
+    out << "        break;\n";
+  }
+  out << "      default:\n        break;\n";
+  out << "    }\n";
+  out << "  }\n\n";
+
+  out << "  /// Get current state\n";
+  out << "  [[nodiscard]] constexpr State state() const noexcept { return state_; }\n\n";
+
+  out << "  /**\n";
+  out << "   * @brief Process an event\n";
+  out << "   * @return true if a transition was performed\n";
+  out << "   */\n";
+  out << "  bool dispatch(Event event) {\n";
+  if (event_transitions.empty()) {
+    out << "    static_cast<void>(event);\n";
+  }
+  out << "    switch (state_) {\n";
+  for (const auto& [name, info] : states) {
+    std::vector<const TransitionInfo*> outgoing;
+    for (const TransitionInfo* transition : event_transitions) {
+      if (transition->from_state == name) {
+        outgoing.push_back(transition);
+      }
+    }
+    if (outgoing.empty()) {
+      continue;
+    }
+
+    out << "      case State::" << state_ids.at(name) << ":\n";
+    out << "        switch (event) {\n";
+    for (const TransitionInfo* transition : outgoing) {
+      out << "          case Event::" << event_ids.at(transition->event_name) << ":\n";
+      writeTransition(out, "            ", info, states.at(transition->to_state), *transition, state_ids);
+    }
+    out << "          default:\n";
+    out << "            return false;\n";
+    out << "        }\n";
+  }
+  out << "      default:\n";
+  out << "        return false;\n";
+  out << "    }\n";
+  out << "  }\n\n";
+
+  out << "  /**\n";
+  out << "   * @brief Take a timeout transition once its duration has elapsed in its source state\n";
+  out << "   * @param timeout Index into timeouts\n";
+  out << "   * @return true if a transition was performed\n";
+  out << "   */\n";
+  out << "  bool expire(std::size_t timeout) {\n";
+  out << "    switch (timeout) {\n";
+  for (size_t i = 0; i < timeout_transitions.size(); ++i) {
+    const TransitionInfo& transition = *timeout_transitions[i];
+    out << "      case " << i << ":\n";
+    out << "        if (state_ != State::" << state_ids.at(transition.from_state) << ") {\n";
+    out << "          return false;\n";
+    out << "        }\n";
+    writeTransition(out, "        ", states.at(transition.from_state), states.at(transition.to_state), transition,
+                    state_ids);
+  }
+  out << "      default:\n";
+  out << "        return false;\n";
+  out << "    }\n";
+  out << "  }\n\n";
+
+  out << " private:\n";
+  out << "  Handler& handler_;\n";
+  out << "  State state_ = initial_state;\n";
+  out << "};\n\n";
+  out << "}  // namespace " << ns << "\n";
+
+  return out.str();
+}
+
+}  // namespace fsmconfig
@@ -0,0 +1,478 @@
+#include "fsmconfig/compiled_config.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "compiled_config_builder.hpp"
+
+namespace fsmconfig {
+
+// ============================================================================
+// CompiledConfig::Impl - Implementation (Pimpl idiom)
+// ============================================================================
+
+/**
+ * @brief Internal implementation of CompiledConfig
+ *
+ * Every span points into the arena, which is released as a whole.
+ */
+class CompiledConfig::Impl {
+ public:
+  /// Backing storage for strings and all record tables
+  std::pmr::monotonic_buffer_resource arena;
+
+  /// Bytes handed out by the arena
+  size_t arena_bytes = 0;
+
+  /// Interned strings indexed by StringId
+  std::span<const std::string_view> strings;
+
+  /// States indexed by StateId
+  std::span<const CompiledState> states;
+
+  /// State identifiers sorted by name
+  std::span<const StateId> states_by_name;
+
+  /// Event names indexed by EventId
+  std::span<const StringId> events;
+
+  /// Event identifiers sorted by name
+  std::span<const EventId> events_by_name;
+
+  /// Coalescing rules in declaration order
+  std::span<const CompiledCoalescing> coalescing;
+
+  /// Transitions in declaration order
+  std::span<const CompiledTransition> transitions;
+
+  /// Transition indices sorted by (from, event), declaration order within equal keys
+  std::span<const uint32_t> transition_index;
+
+  /// Start of each state's range in transition_index (states.size() + 1 entries)
+  std::span<const uint32_t> transition_offsets;
+
+  /// Global variables sorted by name
+  std::span<const CompiledVariable> global_variables;
+
+  StringId initial_state_name = INVALID_ID;
+  StateId initial_state = INVALID_ID;
+
+  /**
+   * @brief Allocate value-initialized array from the arena
+   */
+  template <typename T>
+  std::span<T> allocate(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>, "Arena records are never destroyed");
+    if (count == 0) {
+      return {};
+    }
+    auto* data = static_cast<T*>(arena.allocate(count * sizeof(T), alignof(T)));
+    arena_bytes += count * sizeof(T);
+    std::uninitialized_value_construct_n(data, count);
+    return {data, count};
+  }
+
+  /**
+   * @brief Copy array into the arena
+   */
+  template <typename T>
+  std::span<const T> copy(std::span<const T> source) {
+    auto target = allocate<T>(source.size());
+    std::copy(source.begin(), source.end(), target.begin());
+    return target;
+  }
+
+  /**
+   * @brief Copy string characters into the arena
+   */
+  std::string_view storeString(std::string_view value) {
+    if (value.empty()) {
+      return {};
+    }
+    auto* data = static_cast<char*>(arena.allocate(value.size(), 1));
+    arena_bytes += value.size();
+    std::memcpy(data, value.data(), value.size());
+    return {data, value.size()};
+  }
+
+  [[nodiscard]] std::string_view str(StringId id) const {
+    return id < strings.size() ? strings[id] : std::string_view();
+  }
+};
+
+// ============================================================================
+// Constructors and destructor
+// ============================================================================
+
+CompiledConfig::CompiledConfig() : impl_(std::make_unique<Impl>()) {}
+
+CompiledConfig::~CompiledConfig() = default;
+
+// ============================================================================
+// Data access methods
+// ============================================================================
+
+std::string_view CompiledConfig::str(StringId id) const { return impl_->str(id); }
+
+size_t CompiledConfig::stringCount() const { return impl_->strings.size(); }
+
+std::span<const CompiledState> CompiledConfig::states() const { return impl_->states; }
+
+std::string_view CompiledConfig::stateName(StateId state) const {
+  return state < impl_->states.size() ? impl_->str(impl_->states[state].name) : std::string_view();
+}
+
+StateId CompiledConfig::findState(std::string_view name) const {
+  const auto& by_name = impl_->states_by_name;
+  auto it = std::lower_bound(by_name.begin(), by_name.end(), name,
+                             [this](StateId state, std::string_view key) { return stateName(state) < key; });
+  return it != by_name.end() && stateName(*it) == name ? *it : INVALID_ID;
+}
+
+StateId CompiledConfig::initialState() const { return impl_->initial_state; }
+
+std::string_view CompiledConfig::initialStateName() const { return impl_->str(impl_->initial_state_name); }
+
+size_t CompiledConfig::eventCount() const { return impl_->events.size(); }
+
+std::string_view CompiledConfig::eventName(EventId event) const {
+  return event < impl_->events.size() ? impl_->str(impl_->events[event]) : std::string_view();
+}
+
+EventId CompiledConfig::findEvent(std::string_view name) const {
+  const auto& by_name = impl_->events_by_name;
+  auto it = std::lower_bound(by_name.begin(), by_name.end(), name,
+                             [this](EventId event, std::string_view key) { return eventName(event) < key; });
+  return it != by_name.end() && eventName(*it) == name ? *it : INVALID_ID;
+}
+
+std::span<const CompiledCoalescing> CompiledConfig::coalescedEvents() const { return impl_->coalescing; }
+
+std::span<const CompiledTransition> CompiledConfig::transitions() const { return impl_->transitions; }
+
+std::span<const uint32_t> CompiledConfig::transitionsFrom(StateId state) const {
+  if (state >= impl_->states.size()) {
+    return {};
+  }
+  const uint32_t begin = impl_->transition_offsets[state];
+  const uint32_t end = impl_->transition_offsets[state + 1];
+  return impl_->transition_index.subspan(begin, end - begin);
+}
+
+const CompiledTransition* CompiledConfig::findTransition(StateId from, EventId event) const {
+  const auto candidates = transitionsFrom(from);
+  const auto& transitions = impl_->transitions;
+  auto it = std::lower_bound(candidates.begin(), candidates.end(), event,
+                             [&transitions](uint32_t index, EventId key) { return transitions[index].event < key; });
+  if (it == candidates.end() || transitions[*it].event != event) {
+    return nullptr;
+  }
+  return &transitions[*it];
+}
+
+std::span<const CompiledVariable> CompiledConfig::globalVariables() const { return impl_->global_variables; }
+
+VariableValue CompiledConfig::value(const CompiledVariable& variable) const {
+  switch (variable.type) {
+    case VariableType::INT:
+      return VariableValue(variable.int_value);
+    case VariableType::FLOAT:
+      return VariableValue(variable.float_value);
+    case VariableType::BOOL:
+      return VariableValue(variable.bool_value);
+    case VariableType::STRING:
+      return VariableValue(std::string(impl_->str(variable.string_value)));
+  }
+  return VariableValue();
+}
+
+size_t CompiledConfig::arenaBytes() const { return impl_->arena_bytes; }
+
+// ============================================================================
+// CompiledConfig::Builder
+// ============================================================================
+
+CompiledConfig::Builder::Builder() : config_(std::make_unique<CompiledConfig>()) {}
+
+CompiledConfig::Builder::~Builder() = default;
+
+StringId CompiledConfig::Builder::intern(std::string_view value) {
+  auto it = string_ids_.find(value);
+  if (it != string_ids_.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<StringId>(strings_.size());
+  const std::string_view stored = config_->impl_->storeString(value);
+  strings_.push_back(stored);
+  string_ids_.emplace(stored, id);
+  return id;
+}
+
+StringId CompiledConfig::Builder::optionalName(std::string_view name) {
+  // An empty callback name means "no callback"
+  return name.empty() ? INVALID_ID : intern(name);
+}
+
+CompiledVariable CompiledConfig::Builder::compileVariable(std::string_view name, const VariableValue& value) {
+  CompiledVariable variable;
+  variable.name = intern(name);
+  variable.type = value.type;
+  switch (value.type) {
+    case VariableType::INT:
+      variable.int_value = value.int_value;
+      break;
+    case VariableType::FLOAT:
+      variable.float_value = value.float_value;
+      break;
+    case VariableType::BOOL:
+      variable.bool_value = value.bool_value;
+      break;
+    case VariableType::STRING:
+      variable.string_value = intern(value.string_value);
+      break;
+  }
+  return variable;
+}
+
+void CompiledConfig::Builder::setGlobalVariable(std::string_view name, const VariableValue& value) {
+  const CompiledVariable variable = compileVariable(name, value);
+  auto [it, inserted] = global_ids_.emplace(variable.name, globals_.size());
+  if (inserted) {
+    globals_.push_back(variable);
+  } else {
+    globals_[it->second] = variable;
+  }
+}
+
+void CompiledConfig::Builder::beginState(std::string_view name) {
+  const StringId name_id = intern(name);
+  auto [it, inserted] = state_ids_.emplace(name_id, static_cast<StateId>(states_.size()));
+  if (inserted) {
+    states_.emplace_back();
+  }
+
+  // A redefinition replaces the previous state body but keeps its identifier
+  current_state_ = it->second;
+  PendingState& state = states_[current_state_];
+  state = PendingState{};
+  state.name = name_id;
+  state.actions_begin = state.actions_end = static_cast<uint32_t>(state_actions_.size());
+  state.variables_begin = state.variables_end = static_cast<uint32_t>(state_variables_.size());
+}
+
+void CompiledConfig::Builder::setOnEnter(std::string_view callback) {
+  states_[current_state_].on_enter = optionalName(callback);
+}
+
+void CompiledConfig::Builder::setOnExit(std::string_view callback) {
+  states_[current_state_].on_exit = optionalName(callback);
+}
+
+void CompiledConfig::Builder::addStateAction(std::string_view action) {
+  state_actions_.push_back(intern(action));
+  states_[current_state_].actions_end = static_cast<uint32_t>(state_actions_.size());
+}
+
+void CompiledConfig::Builder::setStateVariable(std::string_view name, const VariableValue& value) {
+  const CompiledVariable variable = compileVariable(name, value);
+  PendingState& state = states_[current_state_];
+  for (uint32_t i = state.variables_begin; i < state.variables_end; ++i) {
+    if (state_variables_[i].name == variable.name) {
+      state_variables_[i] = variable;
+      return;
+    }
+  }
+  state_variables_.push_back(variable);
+  state.variables_end = static_cast<uint32_t>(state_variables_.size());
+}
+
+void CompiledConfig::Builder::beginTransition(std::string_view from, std::string_view to, std::string_view event) {
+  PendingTransition transition;
+  transition.from = intern(from);
+  transition.to = intern(to);
+  transition.event = intern(event);
+  transition.actions_begin = transition.actions_end = static_cast<uint32_t>(transition_actions_.size());
+  transitions_.push_back(transition);
+}
+
+void CompiledConfig::Builder::setGuard(std::string_view callback) {
+  transitions_.back().guard = optionalName(callback);
+}
+
+void CompiledConfig::Builder::setOnTransition(std::string_view callback) {
+  transitions_.back().on_transition = optionalName(callback);
+}
+
+void CompiledConfig::Builder::setAfter(uint64_t milliseconds) {
+  transitions_.back().after_ms = milliseconds;
+}
+
+void CompiledConfig::Builder::addTransitionAction(std::string_view action) {
+  transition_actions_.push_back(intern(action));
+  transitions_.back().actions_end = static_cast<uint32_t>(transition_actions_.size());
+}
+
+void CompiledConfig::Builder::setCoalescing(std::string_view event, std::string_view key) {
+  const CompiledCoalescing rule{intern(event), optionalName(key)};
+  auto it = std::find_if(coalescing_.begin(), coalescing_.end(),
+                         [&rule](const CompiledCoalescing& existing) { return existing.event == rule.event; });
+  if (it != coalescing_.end()) {
+    *it = rule;
+  } else {
+    coalescing_.push_back(rule);
+  }
+}
+
+void CompiledConfig::Builder::setInitialState(std::string_view name) { initial_state_ = intern(name); }
+
+std::unique_ptr<CompiledConfig> CompiledConfig::Builder::build() {
+  Impl& impl = *config_->impl_;
+
+  // Resolve state references, number events in order of first use and detect
+  // duplicate (from, event) pairs in a single pass, collecting every error
+  std::vector<CompiledTransition> transitions(transitions_.size());
+  std::vector<StringId> events;
+  std::unordered_map<StringId, EventId> event_ids;
+  std::unordered_set<uint64_t> transition_keys;
+  transition_keys.reserve(transitions_.size());
+  std::vector<std::string> errors;
+  for (size_t i = 0; i < transitions_.size(); ++i) {
+    const PendingTransition& pending = transitions_[i];
+    auto [event, inserted] = event_ids.emplace(pending.event, static_cast<EventId>(events.size()));
+    if (inserted) {
+      events.push_back(pending.event);
+    }
+
+    auto from = state_ids_.find(pending.from);
+    if (from == state_ids_.end()) {
+      errors.push_back("Transition references non-existent source state: '" + std::string(strings_[pending.from]) +
+                       "'");
+    } else if (!transition_keys.insert((uint64_t{from->second} << 32) | event->second).second) {
+      errors.push_back("Duplicate transition from state '" + std::string(strings_[pending.from]) + "' with event '" +
+                       std::string(strings_[pending.event]) + "'");
+    }
+    auto to = state_ids_.find(pending.to);
+    if (to == state_ids_.end()) {
+      errors.push_back("Transition references non-existent target state: '" + std::string(strings_[pending.to]) +
+                       "'");
+    }
+    if (!errors.empty()) {
+      continue;
+    }
+
+    transitions[i].from = from->second;
+    transitions[i].to = to->second;
+    transitions[i].event = event->second;
+    transitions[i].guard = pending.guard;
+    transitions[i].on_transition = pending.on_transition;
+    transitions[i].after_ms = pending.after_ms;
+  }
+
+  if (errors.size() == 1) {
+    throw ConfigException(errors.front());
+  }
+  if (!errors.empty()) {
+    std::string message = std::to_string(errors.size()) + " configuration errors";
+    for (const auto& error : errors) {
+      message += "; " + error;
+    }
+    throw ConfigException(message);
+  }
+
+  const auto slice = [](const auto& pool, uint32_t begin, uint32_t end) {
+    return std::span(pool).subspan(begin, end - begin);
+  };
+
+  // String table
+  impl.strings = impl.copy(std::span<const std::string_view>(strings_));
+
+  // States with their actions and name-sorted variables
+  auto states = impl.allocate<CompiledState>(states_.size());
+  for (size_t i = 0; i < states_.size(); ++i) {
+    const PendingState& pending = states_[i];
+    auto variables = std::span<CompiledVariable>(state_variables_)
+                         .subspan(pending.variables_begin, pending.variables_end - pending.variables_begin);
+    std::sort(variables.begin(), variables.end(), [this](const CompiledVariable& lhs, const CompiledVariable& rhs) {
+      return strings_[lhs.name] < strings_[rhs.name];
+    });
+
+    states[i].name = pending.name;
+    states[i].on_enter = pending.on_enter;
+    states[i].on_exit = pending.on_exit;
+    states[i].actions = impl.copy(slice(state_actions_, pending.actions_begin, pending.actions_end));
+    states[i].variables = impl.copy(std::span<const CompiledVariable>(variables));
+  }
+  impl.states = states;
+
+  auto states_by_name = impl.allocate<StateId>(states_.size());
+  std::iota(states_by_name.begin(), states_by_name.end(), StateId{0});
+  std::sort(states_by_name.begin(), states_by_name.end(), [this](StateId lhs, StateId rhs) {
+    return strings_[states_[lhs].name] < strings_[states_[rhs].name];
+  });
+  impl.states_by_name = states_by_name;
+
+  // Events
+  impl.events = impl.copy(std::span<const StringId>(events));
+  auto events_by_name = impl.allocate<EventId>(events.size());
+  std::iota(events_by_name.begin(), events_by_name.end(), EventId{0});
+  std::sort(events_by_name.begin(), events_by_name.end(), [this, &events](EventId lhs, EventId rhs) {
+    return strings_[events[lhs]] < strings_[events[rhs]];
+  });
+  impl.events_by_name = events_by_name;
+  impl.coalescing = impl.copy(std::span<const CompiledCoalescing>(coalescing_));
+
+  // Transitions and the per-state lookup index
+  for (size_t i = 0; i < transitions_.size(); ++i) {
+    const PendingTransition& pending = transitions_[i];
+    transitions[i].actions = impl.copy(slice(transition_actions_, pending.actions_begin, pending.actions_end));
+  }
+  impl.transitions = impl.copy(std::span<const CompiledTransition>(transitions));
+
+  auto transition_index = impl.allocate<uint32_t>(transitions.size());
+  std::iota(transition_index.begin(), transition_index.end(), uint32_t{0});
+  std::stable_sort(transition_index.begin(), transition_index.end(), [&transitions](uint32_t lhs, uint32_t rhs) {
+    return std::tie(transitions[lhs].from, transitions[lhs].event) <
+           std::tie(transitions[rhs].from, transitions[rhs].event);
+  });
+  impl.transition_index = transition_index;
+
+  auto transition_offsets = impl.allocate<uint32_t>(states_.size() + 1);
+  for (const auto& transition : transitions) {
+    ++transition_offsets[transition.from + 1];
+  }
+  std::partial_sum(transition_offsets.begin(), transition_offsets.end(), transition_offsets.begin());
+  impl.transition_offsets = transition_offsets;
+
+  // Global variables
+  std::sort(globals_.begin(), globals_.end(), [this](const CompiledVariable& lhs, const CompiledVariable& rhs) {
+    return strings_[lhs.name] < strings_[rhs.name];
+  });
+  impl.global_variables = impl.copy(std::span<const CompiledVariable>(globals_));
+
+  // Initial state: explicit setting, else the first declared state
+  if (initial_state_ != INVALID_ID) {
+    impl.initial_state_name = initial_state_;
+  } else if (!states_.empty()) {
+    impl.initial_state_name = states_.front().name;
+  }
+  if (impl.initial_state_name != INVALID_ID) {
+    auto it = state_ids_.find(impl.initial_state_name);
+    impl.initial_state = it != state_ids_.end() ? it->second : INVALID_ID;
+  }
+
+  return std::move(config_);
+}
+
+}  // namespace fsmconfig
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "fsmconfig/compiled_config.hpp"
+#include "fsmconfig/types.hpp"
+
+namespace fsmconfig {
+
+/**
+ * @file compiled_config_builder.hpp
+ * @brief Incremental construction of CompiledConfig (library internal)
+ */
+
+/**
+ * @class CompiledConfig::Builder
+ * @brief Collects a configuration while it is parsed and lays it out in the arena
+ *
+ * Names are interned into the target arena as they arrive. Records are staged
+ * in flat vectors and copied into exactly sized arena blocks by build(), so the
+ * staging memory is released once loading finishes. Redefining a state or a
+ * variable replaces the earlier definition, matching YAML map semantics.
+ */
+class CompiledConfig::Builder {
+ public:
+  /**
+   * @brief Constructor
+   */
+  Builder();
+
+  /**
+   * @brief Destructor
+   */
+  ~Builder();
+
+  // Copy and move prohibition
+  Builder(const Builder&) = delete;
+  Builder& operator=(const Builder&) = delete;
+  Builder(Builder&&) = delete;
+  Builder& operator=(Builder&&) = delete;
+
+  /**
+   * @brief Intern string
+   * @param value String to intern
+   * @return Identifier of the single stored copy
+   */
+  StringId intern(std::string_view value);
+
+  /**
+   * @brief Set global variable
+   * @param name Variable name
+   * @param value Variable value
+   */
+  void setGlobalVariable(std::string_view name, const VariableValue& value);
+
+  /**
+   * @brief Start (or restart) state definition; following state calls apply to it
+   * @param name State name
+   */
+  void beginState(std::string_view name);
+
+  /**
+   * @brief Set on-enter callback of current state
+   * @param callback Callback name
+   */
+  void setOnEnter(std::string_view callback);
+
+  /**
+   * @brief Set on-exit callback of current state
+   * @param callback Callback name
+   */
+  void setOnExit(std::string_view callback);
+
+  /**
+   * @brief Append action to current state
+   * @param action Action name
+   */
+  void addStateAction(std::string_view action);
+
+  /**
+   * @brief Set variable of current state
+   * @param name Variable name
+   * @param value Variable value
+   */
+  void setStateVariable(std::string_view name, const VariableValue& value);
+
+  /**
+   * @brief Start transition definition; following transition calls apply to it
+   * @param from Source state name (resolved by build())
+   * @param to Target state name (resolved by build())
+   * @param event Event name
+   */
+  void beginTransition(std::string_view from, std::string_view to, std::string_view event);
+
+  /**
+   * @brief Set guard of current transition
+   * @param callback Guard callback name
+   */
+  void setGuard(std::string_view callback);
+
+  /**
+   * @brief Set transition callback of current transition
+   * @param callback Callback name
+   */
+  void setOnTransition(std::string_view callback);
+
+  /**
+   * @brief Make current transition fire after a timeout
+   * @param milliseconds Time spent in the source state (0 = triggered by its event only)
+   */
+  void setAfter(uint64_t milliseconds);
+
+  /**
+   * @brief Append action to current transition
+   * @param action Action name
+   */
+  void addTransitionAction(std::string_view action);
+
+  /**
+   * @brief Coalesce pending instances of an event (redefining replaces the rule)
+   * @param event Event name
+   * @param key Event data field telling instances apart (empty = event name only)
+   */
+  void setCoalescing(std::string_view event, std::string_view key);
+
+  /**
+   * @brief Set explicit initial state
+   * @param name State name
+   */
+  void setInitialState(std::string_view name);
+
+  /**
+   * @brief Resolve references, validate and produce the compiled configuration
+   *
+   * Validation runs in one pass over the interned identifiers and collects every
+   * error before throwing.
+   *
+   * @return Compiled configuration; the builder must not be used afterwards
+   * @throws ConfigException listing every undeclared state reference and every
+   *         duplicate transition (same source state and event)
+   */
+  [[nodiscard]] std::unique_ptr<CompiledConfig> build();
+
+ private:
+  struct PendingState {
+    StringId name = INVALID_ID;
+    StringId on_enter = INVALID_ID;
+    StringId on_exit = INVALID_ID;
+    uint32_t actions_begin = 0;
+    uint32_t actions_end = 0;
+    uint32_t variables_begin = 0;
+    uint32_t variables_end = 0;
+  };
+
+  struct PendingTransition {
+    StringId from = INVALID_ID;
+    StringId to = INVALID_ID;
+    StringId event = INVALID_ID;
+    StringId guard = INVALID_ID;
+    StringId on_transition = INVALID_ID;
+    uint64_t after_ms = 0;
+    uint32_t actions_begin = 0;
+    uint32_t actions_end = 0;
+  };
+
+  [[nodiscard]] StringId optionalName(std::string_view name);
+  [[nodiscard]] CompiledVariable compileVariable(std::string_view name, const VariableValue& value);
+
+  std::unique_ptr<CompiledConfig> config_;
+
+  std::vector<std::string_view> strings_;
+  std::unordered_map<std::string_view, StringId> string_ids_;
+
+  std::vector<PendingState> states_;
+  std::unordered_map<StringId, StateId> state_ids_;
+  StateId current_state_ = INVALID_ID;
+  std::vector<StringId> state_actions_;
+  std::vector<CompiledVariable> state_variables_;
+
+  std::vector<PendingTransition> transitions_;
+  std::vector<StringId> transition_actions_;
+
+  std::vector<CompiledCoalescing> coalescing_;
+
+  std::vector<CompiledVariable> globals_;
+  std::unordered_map<StringId, size_t> global_ids_;
+
+  StringId initial_state_ = INVALID_ID;
+};
+
+}  // namespace fsmconfig
@@ -0,0 +1,235 @@
+#include "config_image.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "binary_io.hpp"
+#include "compiled_config_builder.hpp"
+#include "content_hash.hpp"
+#include "fsmconfig/types.hpp"
+#include "fsmconfig/version.hpp"
+
+namespace fsmconfig::detail {
+
+namespace {
+
+/// File signature
+constexpr uint32_t IMAGE_MAGIC = 0x434D5346;  // "FSMC"
+
+/// Layout version; bump when the encoding below changes
+constexpr uint32_t IMAGE_FORMAT = 3;
+
+void writeVariable(BinaryWriter& writer, const CompiledVariable& variable) {
+  writer.u32(variable.name);
+  writer.u8(static_cast<uint8_t>(variable.type));
+  switch (variable.type) {
+    case VariableType::INT:
+      writer.i32(variable.int_value);
+      break;
+    case VariableType::FLOAT:
+      writer.f32(variable.float_value);
+      break;
+    case VariableType::BOOL:
+      writer.u32(variable.bool_value ? 1 : 0);
+      break;
+    case VariableType::STRING:
+      writer.u32(variable.string_value);
+      break;
+  }
+}
+
+/**
+ * @brief Resolves string identifiers of the image being read
+ */
+class StringTable {
+ public:
+  explicit StringTable(BinaryReader& reader) {
+    const uint32_t count = reader.count(sizeof(uint32_t));
+    strings_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      strings_.push_back(reader.str());
+    }
+  }
+
+  [[nodiscard]] std::string_view at(StringId id) const {
+    if (id >= strings_.size()) {
+      throw ConfigException("Binary image references unknown string");
+    }
+    return strings_[id];
+  }
+
+  /// Like at(), but INVALID_ID maps to the empty "no callback" name
+  [[nodiscard]] std::string_view optional(StringId id) const { return id == INVALID_ID ? std::string_view() : at(id); }
+
+ private:
+  std::vector<std::string_view> strings_;
+};
+
+VariableValue readVariable(BinaryReader& reader, const StringTable& strings, std::string_view& name) {
+  name = strings.at(reader.u32());
+  switch (static_cast<VariableType>(reader.u8())) {
+    case VariableType::INT:
+      return VariableValue(reader.i32());
+    case VariableType::FLOAT:
+      return VariableValue(reader.f32());
+    case VariableType::BOOL:
+      return VariableValue(reader.u32() != 0);
+    case VariableType::STRING:
+      return VariableValue(std::string(strings.at(reader.u32())));
+  }
+  throw ConfigException("Binary image contains unknown variable type");
+}
+
+}  // namespace
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+std::string writeConfigImage(const CompiledConfig& config, const ConfigSource& source) {
+  BinaryWriter writer;
+  writer.u32(IMAGE_MAGIC);
+  writer.u32(IMAGE_FORMAT);
+  writer.str(VERSION_STRING);
+  writer.u64(source.hash);
+  writer.u64(source.size);
+
+  writer.u32(static_cast<uint32_t>(config.stringCount()));
+  for (StringId id = 0; id < config.stringCount(); ++id) {
+    writer.str(config.str(id));
+  }
+
+  const auto globals = config.globalVariables();
+  writer.u32(static_cast<uint32_t>(globals.size()));
+  for (const auto& variable : globals) {
+    writeVariable(writer, variable);
+  }
+
+  const auto states = config.states();
+  writer.u32(static_cast<uint32_t>(states.size()));
+  for (const auto& state : states) {
+    writer.u32(state.name);
+    writer.u32(state.on_enter);
+    writer.u32(state.on_exit);
+    writer.u32(static_cast<uint32_t>(state.actions.size()));
+    for (const StringId action : state.actions) {
+      writer.u32(action);
+    }
+    writer.u32(static_cast<uint32_t>(state.variables.size()));
+    for (const auto& variable : state.variables) {
+      writeVariable(writer, variable);
+    }
+  }
+
+  // Transitions keep declaration order, so events are renumbered identically
+  const auto transitions = config.transitions();
+  writer.u32(static_cast<uint32_t>(transitions.size()));
+  for (const auto& transition : transitions) {
+    writer.u32(states[transition.from].name);
+    writer.u32(states[transition.to].name);
+    writer.str(config.eventName(transition.event));
+    writer.u32(transition.guard);
+    writer.u32(transition.on_transition);
+    writer.u64(transition.after_ms);
+    writer.u32(static_cast<uint32_t>(transition.actions.size()));
+    for (const StringId action : transition.actions) {
+      writer.u32(action);
+    }
+  }
+
+  const auto coalescing = config.coalescedEvents();
+  writer.u32(static_cast<uint32_t>(coalescing.size()));
+  for (const auto& rule : coalescing) {
+    writer.u32(rule.event);
+    writer.u32(rule.key);
+  }
+
+  writer.str(config.initialStateName());
+  return writer.data();
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+std::unique_ptr<CompiledConfig> readConfigImage(std::string_view image, const ConfigSource& source) {
+  BinaryReader reader(image);
+  if (reader.u32() != IMAGE_MAGIC) {
+    throw ConfigException("Not a compiled configuration image");
+  }
+  if (reader.u32() != IMAGE_FORMAT || reader.str() != VERSION_STRING) {
+    return nullptr;
+  }
+  if (reader.u64() != source.hash || reader.u64() != source.size) {
+    return nullptr;
+  }
+
+  // The records are replayed through the builder, which rebuilds the lookup
+  // indices and re-checks every state reference
+  const StringTable strings(reader);
+  CompiledConfig::Builder builder;
+  std::string_view name;
+
+  const uint32_t global_count = reader.count(sizeof(uint32_t));
+  for (uint32_t i = 0; i < global_count; ++i) {
+    const VariableValue value = readVariable(reader, strings, name);
+    builder.setGlobalVariable(name, value);
+  }
+
+  const uint32_t state_count = reader.count(sizeof(uint32_t));
+  for (uint32_t i = 0; i < state_count; ++i) {
+    builder.beginState(strings.at(reader.u32()));
+    builder.setOnEnter(strings.optional(reader.u32()));
+    builder.setOnExit(strings.optional(reader.u32()));
+    const uint32_t action_count = reader.count(sizeof(uint32_t));
+    for (uint32_t j = 0; j < action_count; ++j) {
+      builder.addStateAction(strings.at(reader.u32()));
+    }
+    const uint32_t variable_count = reader.count(sizeof(uint32_t));
+    for (uint32_t j = 0; j < variable_count; ++j) {
+      const VariableValue value = readVariable(reader, strings, name);
+      builder.setStateVariable(name, value);
+    }
+  }
+
+  const uint32_t transition_count = reader.count(sizeof(uint32_t));
+  for (uint32_t i = 0; i < transition_count; ++i) {
+    const std::string_view from = strings.at(reader.u32());
+    const std::string_view to = strings.at(reader.u32());
+    builder.beginTransition(from, to, reader.str());
+    builder.setGuard(strings.optional(reader.u32()));
+    builder.setOnTransition(strings.optional(reader.u32()));
+    builder.setAfter(reader.u64());
+    const uint32_t action_count = reader.count(sizeof(uint32_t));
+    for (uint32_t j = 0; j < action_count; ++j) {
+      builder.addTransitionAction(strings.at(reader.u32()));
+    }
+  }
+
+  const uint32_t coalescing_count = reader.count(2 * sizeof(uint32_t));
+  for (uint32_t i = 0; i < coalescing_count; ++i) {
+    const std::string_view event = strings.at(reader.u32());
+    builder.setCoalescing(event, strings.optional(reader.u32()));
+  }
+
+  if (const std::string_view initial = reader.str(); !initial.empty()) {
+    builder.setInitialState(initial);
+  }
+  if (!reader.atEnd()) {
+    throw ConfigException("Binary image has trailing data");
+  }
+  return builder.build();
+}
+
+std::string configImageName(const ConfigSource& source) {
+  const uint64_t key = contentHash(VERSION_STRING, source.hash);
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.fsmc", static_cast<unsigned long long>(key));
+  return name;
+}
+
+}  // namespace fsmconfig::detail
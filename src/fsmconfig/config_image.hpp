@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "fsmconfig/compiled_config.hpp"
+
+namespace fsmconfig::detail {
+
+/**
+ * @file config_image.hpp
+ * @brief Binary images of compiled configurations for the on-disk cache (library internal)
+ */
+
+/**
+ * @brief Identity of the YAML source an image was compiled from
+ */
+struct ConfigSource {
+  uint64_t hash = 0;  ///< contentHash() of the YAML text
+  uint64_t size = 0;  ///< Size of the YAML text in bytes
+};
+
+/**
+ * @brief Encode compiled configuration
+ *
+ * The image records the library version and the source identity, so an image
+ * is only accepted for the same YAML text and the same library build.
+ *
+ * @param config Compiled configuration
+ * @param source Identity of the YAML text it was compiled from
+ * @return Image bytes
+ */
+std::string writeConfigImage(const CompiledConfig& config, const ConfigSource& source);
+
+/**
+ * @brief Decode compiled configuration
+ * @param image Image bytes
+ * @param source Expected identity of the YAML text
+ * @return Compiled configuration, or nullptr if the image belongs to another
+ *         source or library version
+ * @throws ConfigException if the image is malformed
+ */
+std::unique_ptr<CompiledConfig> readConfigImage(std::string_view image, const ConfigSource& source);
+
+/**
+ * @brief Cache file name for a YAML source
+ * @param source Identity of the YAML text
+ * @return File name keyed by source hash and library version
+ */
+std::string configImageName(const ConfigSource& source);
+
+}  // namespace fsmconfig::detail
@@ -3,14 +3,25 @@
 #include <yaml-cpp/yaml.h>
 
 #include <algorithm>
-#include <fstream>
+#include <filesystem>
+#include <istream>
 #include <map>
 #include <memory>
-#include <set>
+#include <optional>
+#include <mutex>
+#include <span>
+#include <spanstream>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "compiled_config_builder.hpp"
+#include "config_image.hpp"
+#include "config_stream.hpp"
+#include "content_hash.hpp"
+#include "file_io.hpp"
+#include "fsmconfig/compiled_config.hpp"
+#include "fsmconfig/state.hpp"
 #include "fsmconfig/types.hpp"
 
 namespace fsmconfig {
@@ -24,26 +35,75 @@ namespace fsmconfig {
  */
 class ConfigParser::Impl {
  public:
-  /// Global configuration variables
-  std::map<std::string, VariableValue> global_variables;
+  /**
+   * @brief std::map/std::vector form of the configuration for the legacy accessors
+   *
+   * Filled on first use, so code that only reads the compiled model never pays
+   * for it. std::call_once keeps this safe on a definition shared between threads.
+   */
+  struct LegacyModel {
+    std::once_flag once;
+    std::map<std::string, VariableValue> global_variables;
+    std::map<std::string, StateInfo> states;
+    std::vector<TransitionInfo> transitions;
+  };
+
+  /// Loaded configuration (never null; empty when nothing is loaded)
+  std::unique_ptr<CompiledConfig> compiled = std::make_unique<CompiledConfig>();
+
+  /// Lazily materialized legacy view of compiled
+  std::unique_ptr<LegacyModel> legacy = std::make_unique<LegacyModel>();
 
-  /// States map
-  std::map<std::string, StateInfo> states;
+  /// Directory of cached compiled images (empty = caching disabled)
+  std::string cache_directory;
 
-  /// Transitions vector
-  std::vector<TransitionInfo> transitions;
+  /// Read buffer of loadFromFile() (capacity is reused)
+  std::string file_buffer;
 
-  /// Initial state (empty if not explicitly set)
-  std::string initial_state;
+  /**
+   * @brief Get legacy view, building it on first call
+   */
+  const LegacyModel& getLegacy() const {
+    std::call_once(legacy->once, [this] { materializeLegacy(*legacy); });
+    return *legacy;
+  }
 
   /**
    * @brief Clear all configuration data
    */
   void clear() {
-    global_variables.clear();
-    states.clear();
-    transitions.clear();
-    initial_state.clear();
+    compiled = std::make_unique<CompiledConfig>();
+    legacy = std::make_unique<LegacyModel>();
+  }
+
+ private:
+  void materializeLegacy(LegacyModel& model) const {
+    const CompiledConfig& config = *compiled;
+
+    for (const auto& variable : config.globalVariables()) {
+      model.global_variables.emplace(config.str(variable.name), config.value(variable));
+    }
+
+    for (StateId id = 0; id < config.states().size(); ++id) {
+      StateInfo info = StateView(config, id).toStateInfo();
+      model.states.emplace(info.name, std::move(info));
+    }
+
+    model.transitions.reserve(config.transitions().size());
+    for (const auto& transition : config.transitions()) {
+      TransitionInfo info;
+      info.from_state = config.stateName(transition.from);
+      info.to_state = config.stateName(transition.to);
+      info.event_name = config.eventName(transition.event);
+      info.guard_callback = config.str(transition.guard);
+      info.transition_callback = config.str(transition.on_transition);
+      info.after_ms = transition.after_ms;
+      info.actions.reserve(transition.actions.size());
+      for (const StringId action : transition.actions) {
+        info.actions.emplace_back(config.str(action));
+      }
+      model.transitions.push_back(std::move(info));
+    }
   }
 };
 
@@ -69,76 +129,29 @@ ConfigParser& ConfigParser::operator=(ConfigParser&& other) noexcept {
 // ============================================================================
 
 void ConfigParser::loadFromFile(const std::string& file_path) {
-  try {
-    // Clear previous configuration
+  // The view into file_buffer stays valid for the whole load
+  detail::FileView file;
+  if (!file.open(file_path, impl_->file_buffer)) {
     impl_->clear();
-
-    // Load YAML from file
-    YAML::Node root = YAML::LoadFile(file_path);
-
-    // Parse global variables
-    if (root["variables"]) {
-      parseGlobalVariables(root["variables"]);
-    }
-
-    // Parse states
-    if (root["states"]) {
-      parseStates(root["states"]);
-    }
-
-    // Parse transitions
-    if (root["transitions"]) {
-      parseTransitions(root["transitions"]);
-    }
-
-    // Parse initial state
-    if (root["initial_state"] && root["initial_state"].IsScalar()) {
-      impl_->initial_state = root["initial_state"].Scalar();
-    }
-
-    // Validate configuration
-    validateConfig();
-
-  } catch (const YAML::Exception& e) {
-    impl_->clear();
-    throw ConfigException(std::string("YAML parsing error: ") + e.what());
-  } catch (const std::exception& e) {
-    impl_->clear();
-    throw ConfigException(std::string("Error loading configuration: ") + e.what());
+    throw ConfigException("Error loading configuration: cannot open file '" + file_path + "'");
   }
+  loadFromBuffer(file.data());
 }
 
-void ConfigParser::loadFromString(const std::string& yaml_content) {
+void ConfigParser::loadFromString(const std::string& yaml_content) { loadFromBuffer(yaml_content); }
+
+void ConfigParser::loadFromBuffer(std::string_view yaml_content) {
   try {
     // Clear previous configuration
     impl_->clear();
 
-    // Load YAML from string
-    YAML::Node root = YAML::Load(yaml_content);
-
-    // Parse global variables
-    if (root["variables"]) {
-      parseGlobalVariables(root["variables"]);
-    }
-
-    // Parse states
-    if (root["states"]) {
-      parseStates(root["states"]);
+    if (impl_->cache_directory.empty()) {
+      std::ispanstream stream(std::span<const char>(yaml_content.data(), yaml_content.size()));
+      loadStream(stream);
+    } else {
+      loadThroughCache(yaml_content);
     }
 
-    // Parse transitions
-    if (root["transitions"]) {
-      parseTransitions(root["transitions"]);
-    }
-
-    // Parse initial state
-    if (root["initial_state"] && root["initial_state"].IsScalar()) {
-      impl_->initial_state = root["initial_state"].Scalar();
-    }
-
-    // Validate configuration
-    validateConfig();
-
   } catch (const YAML::Exception& e) {
     impl_->clear();
     throw ConfigException(std::string("YAML parsing error: ") + e.what());
@@ -148,23 +161,32 @@ void ConfigParser::loadFromString(const std::string& yaml_content) {
   }
 }
 
+void ConfigParser::setCacheDirectory(const std::string& directory) { impl_->cache_directory = directory; }
+
+std::string ConfigParser::getCacheDirectory() const { return impl_->cache_directory; }
+
 // ============================================================================
 // Data access methods
 // ============================================================================
 
-const std::map<std::string, VariableValue>& ConfigParser::getGlobalVariables() const { return impl_->global_variables; }
+const CompiledConfig& ConfigParser::getCompiledConfig() const { return *impl_->compiled; }
 
-const std::map<std::string, StateInfo>& ConfigParser::getStates() const { return impl_->states; }
+const std::map<std::string, VariableValue>& ConfigParser::getGlobalVariables() const {
+  return impl_->getLegacy().global_variables;
+}
+
+const std::map<std::string, StateInfo>& ConfigParser::getStates() const { return impl_->getLegacy().states; }
 
-const std::vector<TransitionInfo>& ConfigParser::getTransitions() const { return impl_->transitions; }
+const std::vector<TransitionInfo>& ConfigParser::getTransitions() const { return impl_->getLegacy().transitions; }
 
 bool ConfigParser::hasState(const std::string& state_name) const {
-  return impl_->states.find(state_name) != impl_->states.end();
+  return impl_->compiled->findState(state_name) != INVALID_ID;
 }
 
 const StateInfo& ConfigParser::getState(const std::string& state_name) const {
-  auto it = impl_->states.find(state_name);
-  if (it == impl_->states.end()) {
+  const auto& states = impl_->getLegacy().states;
+  auto it = states.find(state_name);
+  if (it == states.end()) {
     throw ConfigException("State '" + state_name + "' not found");
   }
   return it->second;
@@ -172,7 +194,7 @@ const StateInfo& ConfigParser::getState(const std::string& state_name) const {
 
 std::vector<TransitionInfo> ConfigParser::getTransitionsFrom(const std::string& state_name) const {
   std::vector<TransitionInfo> result;
-  for (const auto& transition : impl_->transitions) {
+  for (const auto& transition : impl_->getLegacy().transitions) {
     if (transition.from_state == state_name) {
       result.push_back(transition);
     }
@@ -181,15 +203,16 @@ std::vector<TransitionInfo> ConfigParser::getTransitionsFrom(const std::string&
 }
 
 const TransitionInfo* ConfigParser::findTransition(const std::string& from_state, const std::string& event_name) const {
-  for (const auto& transition : impl_->transitions) {
-    if (transition.from_state == from_state && transition.event_name == event_name) {
-      return &transition;
-    }
+  const CompiledConfig& config = *impl_->compiled;
+  const CompiledTransition* transition =
+      config.findTransition(config.findState(from_state), config.findEvent(event_name));
+  if (!transition) {
+    return nullptr;
   }
-  return nullptr;
+  return &impl_->getLegacy().transitions[transition - config.transitions().data()];
 }
 
-std::string ConfigParser::getInitialState() const { return impl_->initial_state; }
+std::string ConfigParser::getInitialState() const { return std::string(impl_->compiled->initialStateName()); }
 
 void ConfigParser::clear() { impl_->clear(); }
 
@@ -204,188 +227,238 @@ VariableValue ConfigParser::parseVariable(const YAML::Node& node) const {
 
   // Check for scalar value
   if (node.IsScalar()) {
-    std::string value = node.Scalar();
-
-    // Try to recognize type from string representation
-    if (value == "true" || value == "false") {
-      return VariableValue(node.as<bool>());
-    }
-
-    // Check for integer (including negative)
-    try {
-      // Check that string consists of digits and optional minus sign at the beginning
-      bool is_integer = true;
-      for (size_t i = 0; i < value.size(); ++i) {
-        if (i == 0 && value[i] == '-') {
-          continue;  // Minus at the beginning is allowed
-        }
-        if (!std::isdigit(value[i])) {
-          is_integer = false;
-          break;
-        }
-      }
-      if (is_integer && !value.empty()) {
-        return VariableValue(node.as<int>());
-      }
-    } catch (...) {
-      // Ignore errors when trying to parse as int
-    }
-
-    // Check for floating point number
-    try {
-      return VariableValue(node.as<float>());
-    } catch (...) {
-      // Ignore errors when trying to parse as float
-    }
-
-    // Default to string
-    return VariableValue(value);
+    return detail::parseScalarVariable(node.Scalar());
   }
 
   throw ConfigException("Unsupported variable type in YAML");
 }
 
-StateInfo ConfigParser::parseState(const std::string& name, const YAML::Node& node) const {
-  StateInfo state_info(name);
+void ConfigParser::parseState(CompiledConfig::Builder& builder, const std::string& name,
+                              const YAML::Node& node) const {
+  builder.beginState(name);
 
   // Parse state variables
   if (node["variables"] && node["variables"].IsMap()) {
     for (const auto& var_pair : node["variables"]) {
-      std::string var_name = var_pair.first.Scalar();
-      state_info.variables[var_name] = parseVariable(var_pair.second);
+      builder.setStateVariable(var_pair.first.Scalar(), parseVariable(var_pair.second));
     }
   }
 
   // Parse on_enter callback
   if (node["on_enter"] && node["on_enter"].IsScalar()) {
-    state_info.on_enter_callback = node["on_enter"].Scalar();
+    builder.setOnEnter(node["on_enter"].Scalar());
   }
 
   // Parse on_exit callback
   if (node["on_exit"] && node["on_exit"].IsScalar()) {
-    state_info.on_exit_callback = node["on_exit"].Scalar();
+    builder.setOnExit(node["on_exit"].Scalar());
   }
 
   // Parse actions
   if (node["actions"] && node["actions"].IsSequence()) {
     for (const auto& action_node : node["actions"]) {
       if (action_node.IsScalar()) {
-        state_info.actions.push_back(action_node.Scalar());
+        builder.addStateAction(action_node.Scalar());
       }
     }
   }
-
-  return state_info;
 }
 
-TransitionInfo ConfigParser::parseTransition(const YAML::Node& node) const {
-  TransitionInfo transition_info;
-
+void ConfigParser::parseTransition(CompiledConfig::Builder& builder, const YAML::Node& node) const {
   // Required fields
   if (!node["from"] || !node["from"].IsScalar()) {
     throw ConfigException("Transition missing required field 'from'");
   }
-  transition_info.from_state = node["from"].Scalar();
 
   if (!node["to"] || !node["to"].IsScalar()) {
     throw ConfigException("Transition missing required field 'to'");
   }
-  transition_info.to_state = node["to"].Scalar();
 
-  if (!node["event"] || !node["event"].IsScalar()) {
+  // A timed transition ('after') may omit its event
+  const YAML::Node after = node["after"];
+  uint64_t after_ms = 0;
+  if (after) {
+    const auto duration = after.IsScalar() ? detail::parseDuration(after.Scalar()) : std::nullopt;
+    if (!duration) {
+      throw ConfigException("Transition has invalid 'after' duration" +
+                            (after.IsScalar() ? " '" + after.Scalar() + "'" : std::string()) +
+                            "; expected a positive count with unit ms, s, m or h");
+    }
+    after_ms = *duration;
+  }
+
+  if (node["event"] && node["event"].IsScalar()) {
+    builder.beginTransition(node["from"].Scalar(), node["to"].Scalar(), node["event"].Scalar());
+  } else if (after && !node["event"]) {
+    builder.beginTransition(node["from"].Scalar(), node["to"].Scalar(), detail::timeoutEventName(after.Scalar()));
+  } else {
     throw ConfigException("Transition missing required field 'event'");
   }
-  transition_info.event_name = node["event"].Scalar();
+  builder.setAfter(after_ms);
 
   // Optional fields
   if (node["guard"] && node["guard"].IsScalar()) {
-    transition_info.guard_callback = node["guard"].Scalar();
+    builder.setGuard(node["guard"].Scalar());
   }
 
   if (node["on_transition"] && node["on_transition"].IsScalar()) {
-    transition_info.transition_callback = node["on_transition"].Scalar();
+    builder.setOnTransition(node["on_transition"].Scalar());
   }
 
   // Parse transition actions
   if (node["actions"] && node["actions"].IsSequence()) {
     for (const auto& action_node : node["actions"]) {
       if (action_node.IsScalar()) {
-        transition_info.actions.push_back(action_node.Scalar());
+        builder.addTransitionAction(action_node.Scalar());
       }
     }
   }
+}
 
-  return transition_info;
+void ConfigParser::parseEvent(CompiledConfig::Builder& builder, const std::string& name,
+                              const YAML::Node& node) const {
+  if (node.IsNull()) {
+    return;
+  }
+  if (!node.IsMap()) {
+    throw ConfigException("Event '" + name + "' must be a map");
+  }
+
+  bool coalesce = false;
+  if (const YAML::Node flag = node["coalesce"]; flag && !YAML::convert<bool>::decode(flag, coalesce)) {
+    throw ConfigException("Event '" + name + "' has invalid 'coalesce' value; expected true or false");
+  }
+
+  const YAML::Node key = node["key"];
+  if (key && (!key.IsScalar() || !coalesce)) {
+    throw ConfigException("Event '" + name + "' 'key' must be a data field name and requires 'coalesce: true'");
+  }
+
+  if (coalesce) {
+    builder.setCoalescing(name, key ? key.Scalar() : std::string());
+  }
 }
 
 // ============================================================================
-// Configuration validation
+// Private helper methods
 // ============================================================================
 
-void ConfigParser::validateConfig() const {
-  // Check that all states referenced in transitions exist
-  for (const auto& transition : impl_->transitions) {
-    if (!hasState(transition.from_state)) {
-      throw ConfigException("Transition references non-existent source state: '" + transition.from_state + "'");
-    }
+void ConfigParser::loadDocument(const YAML::Node& root) {
+  CompiledConfig::Builder builder;
 
-    if (!hasState(transition.to_state)) {
-      throw ConfigException("Transition references non-existent target state: '" + transition.to_state + "'");
-    }
+  // Parse global variables
+  if (root["variables"]) {
+    parseGlobalVariables(builder, root["variables"]);
+  }
+
+  // Parse states
+  if (root["states"]) {
+    parseStates(builder, root["states"]);
+  }
+
+  // Parse transitions
+  if (root["transitions"]) {
+    parseTransitions(builder, root["transitions"]);
   }
 
-  // Check that there are no duplicate transitions (from_state, event)
-  std::map<std::string, std::set<std::string>> state_events;
-  for (const auto& transition : impl_->transitions) {
-    auto& events = state_events[transition.from_state];
-    if (events.find(transition.event_name) != events.end()) {
-      throw ConfigException("Duplicate transition from state '" + transition.from_state + "' with event '" +
-                            transition.event_name + "'");
+  // Parse event options
+  if (root["events"]) {
+    parseEvents(builder, root["events"]);
+  }
+
+  // Parse initial state (defaults to the first state)
+  if (root["initial_state"] && root["initial_state"].IsScalar()) {
+    builder.setInitialState(root["initial_state"].Scalar());
+  }
+
+  // Resolve references and validate (reports every error at once)
+  impl_->compiled = builder.build();
+}
+
+void ConfigParser::loadStream(std::istream& input) {
+  // Fast path: build the compiled model straight from parser events
+  {
+    CompiledConfig::Builder builder;
+    if (detail::streamConfig(input, builder)) {
+      impl_->compiled = builder.build();
+      return;
     }
-    events.insert(transition.event_name);
   }
+
+  // Aliases and unexpected layouts go through the node tree
+  input.clear();
+  input.seekg(0);
+  loadDocument(YAML::Load(input));
 }
 
-// ============================================================================
-// Private helper methods
-// ============================================================================
+void ConfigParser::loadThroughCache(std::string_view yaml_content) {
+  const detail::ConfigSource source{detail::contentHash(yaml_content), yaml_content.size()};
+  const std::filesystem::path image_path =
+      std::filesystem::path(impl_->cache_directory) / detail::configImageName(source);
 
-void ConfigParser::parseGlobalVariables(const YAML::Node& node) {
+  // Hit: use the image unless it is stale or damaged
+  // (yaml_content may live in file_buffer, so the image gets its own storage)
+  detail::FileView image;
+  std::string image_buffer;
+  if (image.open(image_path, image_buffer)) {
+    try {
+      if (auto compiled = detail::readConfigImage(image.data(), source)) {
+        impl_->compiled = std::move(compiled);
+        return;
+      }
+    } catch (const ConfigException&) {
+      // Fall back to parsing, which replaces the image
+    }
+  }
+
+  // Miss: parse, then store the validated result for the next load
+  std::ispanstream stream(std::span<const char>(yaml_content.data(), yaml_content.size()));
+  loadStream(stream);
+
+  std::error_code error;
+  std::filesystem::create_directories(impl_->cache_directory, error);
+  if (!error) {
+    detail::writeFileAtomically(image_path, detail::writeConfigImage(*impl_->compiled, source));
+  }
+}
+
+void ConfigParser::parseGlobalVariables(CompiledConfig::Builder& builder, const YAML::Node& node) {
   if (!node.IsMap()) {
     throw ConfigException("'variables' section must be a map");
   }
 
   for (const auto& var_pair : node) {
-    std::string var_name = var_pair.first.Scalar();
-    impl_->global_variables[var_name] = parseVariable(var_pair.second);
+    builder.setGlobalVariable(var_pair.first.Scalar(), parseVariable(var_pair.second));
   }
 }
 
-void ConfigParser::parseStates(const YAML::Node& node) {
+void ConfigParser::parseStates(CompiledConfig::Builder& builder, const YAML::Node& node) {
   if (!node.IsMap()) {
     throw ConfigException("'states' section must be a map");
   }
 
-  bool first_state = true;
   for (const auto& state_pair : node) {
-    std::string state_name = state_pair.first.Scalar();
-    impl_->states[state_name] = parseState(state_name, state_pair.second);
-
-    // If initial state is not explicitly set, use the first state
-    if (first_state && impl_->initial_state.empty()) {
-      impl_->initial_state = state_name;
-    }
-    first_state = false;
+    parseState(builder, state_pair.first.Scalar(), state_pair.second);
   }
 }
 
-void ConfigParser::parseTransitions(const YAML::Node& node) {
+void ConfigParser::parseTransitions(CompiledConfig::Builder& builder, const YAML::Node& node) {
   if (!node.IsSequence()) {
     throw ConfigException("'transitions' section must be a sequence");
   }
 
   for (const auto& transition_node : node) {
-    impl_->transitions.push_back(parseTransition(transition_node));
+    parseTransition(builder, transition_node);
+  }
+}
+
+void ConfigParser::parseEvents(CompiledConfig::Builder& builder, const YAML::Node& node) {
+  if (!node.IsMap()) {
+    throw ConfigException("'events' section must be a map");
+  }
+
+  for (const auto& event_pair : node) {
+    parseEvent(builder, event_pair.first.Scalar(), event_pair.second);
   }
 }
 
@@ -0,0 +1,455 @@
+#include "config_stream.hpp"
+
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/yaml.h>
+
+#include <cctype>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fsmconfig::detail {
+
+namespace {
+
+/// Thrown by the event handler to hand the document over to the node tree
+struct Declined {};
+
+/// Kind of the YAML node an event starts
+enum class NodeKind : uint8_t { Null, Scalar, Map, Sequence };
+
+/// Position in the configuration layout
+enum class Frame : uint8_t {
+  Document,
+  Root,
+  GlobalVariables,
+  States,
+  StateBody,
+  StateVariables,
+  StateActions,
+  Transitions,
+  TransitionBody,
+  TransitionActions,
+  Events,
+  EventBody,
+  Skip,
+};
+
+/**
+ * @brief Fields that appear at most once per map
+ *
+ * Node lookups (node["key"]) return the first matching key, so later
+ * duplicates of these fields are skipped to get the same result.
+ */
+enum Field : uint32_t {
+  VARIABLES = 1U << 0,
+  STATES = 1U << 1,
+  TRANSITIONS = 1U << 2,
+  INITIAL_STATE = 1U << 3,
+  ON_ENTER = 1U << 4,
+  ON_EXIT = 1U << 5,
+  ACTIONS = 1U << 6,
+  FROM = 1U << 7,
+  TO = 1U << 8,
+  EVENT = 1U << 9,
+  GUARD = 1U << 10,
+  ON_TRANSITION = 1U << 11,
+  AFTER = 1U << 12,
+  EVENTS = 1U << 13,
+  COALESCE = 1U << 14,
+  KEY = 1U << 15,
+};
+
+/**
+ * @brief Feeds yaml-cpp parser events into CompiledConfig::Builder
+ *
+ * Keeps a stack of open collections. Map entries alternate between key and
+ * value events; values are dispatched on the enclosing frame and key, and
+ * collections that carry nothing of interest are skipped as a whole.
+ */
+class ConfigEventHandler final : public YAML::EventHandler {
+ public:
+  explicit ConfigEventHandler(CompiledConfig::Builder& builder) : builder_(builder) {}
+
+  void OnDocumentStart(const YAML::Mark& /*mark*/) override { stack_.emplace_back(Frame::Document); }
+
+  void OnDocumentEnd() override {}
+
+  void OnNull(const YAML::Mark& /*mark*/, YAML::anchor_t /*anchor*/) override { node(NodeKind::Null, empty_); }
+
+  void OnAlias(const YAML::Mark& /*mark*/, YAML::anchor_t /*anchor*/) override { throw Declined{}; }
+
+  void OnScalar(const YAML::Mark& /*mark*/, const std::string& /*tag*/, YAML::anchor_t /*anchor*/,
+                const std::string& value) override {
+    node(NodeKind::Scalar, value);
+  }
+
+  void OnSequenceStart(const YAML::Mark& /*mark*/, const std::string& /*tag*/, YAML::anchor_t /*anchor*/,
+                       YAML::EmitterStyle::value /*style*/) override {
+    node(NodeKind::Sequence, empty_);
+  }
+
+  void OnSequenceEnd() override { end(); }
+
+  void OnMapStart(const YAML::Mark& /*mark*/, const std::string& /*tag*/, YAML::anchor_t /*anchor*/,
+                  YAML::EmitterStyle::value /*style*/) override {
+    node(NodeKind::Map, empty_);
+  }
+
+  void OnMapEnd() override { end(); }
+
+ private:
+  struct Level {
+    explicit Level(Frame kind) : frame(kind) {}
+
+    Frame frame;
+    bool at_key = true;  ///< Map frames: next node is a key
+    std::string key;     ///< Map frames: key of the value being read
+    uint32_t seen = 0;   ///< Fields already read (see Field)
+  };
+
+  struct PendingTransition {
+    std::optional<std::string> from;
+    std::optional<std::string> to;
+    std::optional<std::string> event;
+    std::optional<std::string> guard;
+    std::optional<std::string> on_transition;
+    std::optional<std::string> after;
+    std::vector<std::string> actions;
+  };
+
+  struct PendingEvent {
+    std::string name;
+    bool coalesce = false;
+    std::optional<std::string> key;
+  };
+
+  static bool isMap(Frame frame) {
+    return frame == Frame::Root || frame == Frame::GlobalVariables || frame == Frame::States ||
+           frame == Frame::StateBody || frame == Frame::StateVariables || frame == Frame::TransitionBody ||
+           frame == Frame::Events || frame == Frame::EventBody;
+  }
+
+  static void require(bool condition) {
+    if (!condition) {
+      throw Declined{};
+    }
+  }
+
+  static bool first(Level& level, Field field) {
+    const bool result = (level.seen & field) == 0;
+    level.seen |= field;
+    return result;
+  }
+
+  void push(Frame frame) { stack_.emplace_back(frame); }
+
+  void skip(NodeKind kind) {
+    if (kind == NodeKind::Map || kind == NodeKind::Sequence) {
+      push(Frame::Skip);
+    }
+  }
+
+  void node(NodeKind kind, const std::string& value) {
+    Level& level = stack_.back();
+    if (level.frame == Frame::Skip) {
+      skip(kind);
+      return;
+    }
+    if (isMap(level.frame)) {
+      if (level.at_key) {
+        require(kind == NodeKind::Scalar);
+        level.key = value;
+        level.at_key = false;
+        return;
+      }
+      level.at_key = true;
+    }
+    // Handlers may push, so they must not use level afterwards
+    switch (level.frame) {
+      case Frame::Document:
+        require(kind == NodeKind::Map || kind == NodeKind::Null);
+        if (kind == NodeKind::Map) {
+          push(Frame::Root);
+        }
+        break;
+      case Frame::Root:
+        rootValue(level, kind, value);
+        break;
+      case Frame::GlobalVariables:
+        require(kind == NodeKind::Scalar);
+        builder_.setGlobalVariable(level.key, parseScalarVariable(value));
+        break;
+      case Frame::States:
+        require(kind == NodeKind::Map || kind == NodeKind::Null);
+        builder_.beginState(level.key);
+        if (kind == NodeKind::Map) {
+          push(Frame::StateBody);
+        }
+        break;
+      case Frame::StateBody:
+        stateValue(level, kind, value);
+        break;
+      case Frame::StateVariables:
+        require(kind == NodeKind::Scalar);
+        builder_.setStateVariable(level.key, parseScalarVariable(value));
+        break;
+      case Frame::StateActions:
+        if (kind == NodeKind::Scalar) {
+          builder_.addStateAction(value);
+        } else {
+          skip(kind);
+        }
+        break;
+      case Frame::Transitions:
+        require(kind == NodeKind::Map);
+        transition_ = PendingTransition{};
+        push(Frame::TransitionBody);
+        break;
+      case Frame::TransitionBody:
+        transitionValue(level, kind, value);
+        break;
+      case Frame::TransitionActions:
+        if (kind == NodeKind::Scalar) {
+          transition_.actions.push_back(value);
+        } else {
+          skip(kind);
+        }
+        break;
+      case Frame::Events:
+        require(kind == NodeKind::Map || kind == NodeKind::Null);
+        if (kind == NodeKind::Map) {
+          event_ = PendingEvent{};
+          event_.name = level.key;
+          push(Frame::EventBody);
+        }
+        break;
+      case Frame::EventBody:
+        eventValue(level, kind, value);
+        break;
+      case Frame::Skip:
+        break;
+    }
+  }
+
+  void end() {
+    const Frame frame = stack_.back().frame;
+    stack_.pop_back();
+    if (frame == Frame::TransitionBody) {
+      require(transition_.from && transition_.to && (transition_.event || transition_.after));
+      const auto after = transition_.after ? parseDuration(*transition_.after) : std::optional<uint64_t>(0);
+      require(after.has_value());
+      builder_.beginTransition(*transition_.from, *transition_.to,
+                               transition_.event ? *transition_.event : timeoutEventName(*transition_.after));
+      builder_.setAfter(*after);
+      if (transition_.guard) {
+        builder_.setGuard(*transition_.guard);
+      }
+      if (transition_.on_transition) {
+        builder_.setOnTransition(*transition_.on_transition);
+      }
+      for (const auto& action : transition_.actions) {
+        builder_.addTransitionAction(action);
+      }
+    } else if (frame == Frame::EventBody) {
+      // Malformed options are reported by the node tree
+      require(event_.coalesce || !event_.key);
+      if (event_.coalesce) {
+        builder_.setCoalescing(event_.name, event_.key.value_or(std::string()));
+      }
+    }
+  }
+
+  void rootValue(Level& level, NodeKind kind, const std::string& value) {
+    const std::string& key = level.key;
+    if (key == "variables") {
+      if (!first(level, VARIABLES)) {
+        return skip(kind);
+      }
+      require(kind == NodeKind::Map);
+      push(Frame::GlobalVariables);
+    } else if (key == "states") {
+      if (!first(level, STATES)) {
+        return skip(kind);
+      }
+      require(kind == NodeKind::Map);
+      push(Frame::States);
+    } else if (key == "transitions") {
+      if (!first(level, TRANSITIONS)) {
+        return skip(kind);
+      }
+      require(kind == NodeKind::Sequence);
+      push(Frame::Transitions);
+    } else if (key == "events") {
+      if (!first(level, EVENTS)) {
+        return skip(kind);
+      }
+      require(kind == NodeKind::Map);
+      push(Frame::Events);
+    } else if (key == "initial_state" && first(level, INITIAL_STATE) && kind == NodeKind::Scalar) {
+      builder_.setInitialState(value);
+    } else {
+      skip(kind);
+    }
+  }
+
+  void stateValue(Level& level, NodeKind kind, const std::string& value) {
+    const std::string& key = level.key;
+    if (key == "variables" && first(level, VARIABLES) && kind == NodeKind::Map) {
+      push(Frame::StateVariables);
+    } else if (key == "on_enter" && first(level, ON_ENTER) && kind == NodeKind::Scalar) {
+      builder_.setOnEnter(value);
+    } else if (key == "on_exit" && first(level, ON_EXIT) && kind == NodeKind::Scalar) {
+      builder_.setOnExit(value);
+    } else if (key == "actions" && first(level, ACTIONS) && kind == NodeKind::Sequence) {
+      push(Frame::StateActions);
+    } else {
+      skip(kind);
+    }
+  }
+
+  void transitionValue(Level& level, NodeKind kind, const std::string& value) {
+    const std::string& key = level.key;
+    if (key == "from" || key == "to" || key == "event" || key == "after") {
+      const Field field = key == "from" ? FROM : key == "to" ? TO : key == "event" ? EVENT : AFTER;
+      if (!first(level, field)) {
+        return skip(kind);
+      }
+      require(kind == NodeKind::Scalar);
+      transitionField(field) = value;
+    } else if (key == "guard" && first(level, GUARD) && kind == NodeKind::Scalar) {
+      transition_.guard = value;
+    } else if (key == "on_transition" && first(level, ON_TRANSITION) && kind == NodeKind::Scalar) {
+      transition_.on_transition = value;
+    } else if (key == "actions" && first(level, ACTIONS) && kind == NodeKind::Sequence) {
+      push(Frame::TransitionActions);
+    } else {
+      skip(kind);
+    }
+  }
+
+  void eventValue(Level& level, NodeKind kind, const std::string& value) {
+    const std::string& key = level.key;
+    if (key == "coalesce" || key == "key") {
+      if (!first(level, key == "coalesce" ? COALESCE : KEY)) {
+        return skip(kind);
+      }
+      require(kind == NodeKind::Scalar);
+      if (key == "key") {
+        event_.key = value;
+      } else {
+        require(value == "true" || value == "false");
+        event_.coalesce = value == "true";
+      }
+    } else {
+      skip(kind);
+    }
+  }
+
+  std::optional<std::string>& transitionField(Field field) {
+    switch (field) {
+      case FROM:
+        return transition_.from;
+      case TO:
+        return transition_.to;
+      case EVENT:
+        return transition_.event;
+      default:
+        return transition_.after;
+    }
+  }
+
+  CompiledConfig::Builder& builder_;
+  std::vector<Level> stack_;
+  PendingTransition transition_;
+  PendingEvent event_;
+  const std::string empty_;
+};
+
+}  // namespace
+
+// ============================================================================
+// Scalar conversion
+// ============================================================================
+
+VariableValue parseScalarVariable(const std::string& value) {
+  // Try to recognize type from string representation
+  if (value == "true" || value == "false") {
+    return VariableValue(value == "true");
+  }
+
+  const YAML::Node node(value);
+
+  // Check for integer (including negative)
+  try {
+    // Check that string consists of digits and optional minus sign at the beginning
+    bool is_integer = true;
+    for (size_t i = 0; i < value.size(); ++i) {
+      if (i == 0 && value[i] == '-') {
+        continue;  // Minus at the beginning is allowed
+      }
+      if (!std::isdigit(static_cast<unsigned char>(value[i]))) {
+        is_integer = false;
+        break;
+      }
+    }
+    if (is_integer && !value.empty()) {
+      return VariableValue(node.as<int>());
+    }
+  } catch (...) {
+    // Ignore errors when trying to parse as int
+  }
+
+  // Check for floating point number
+  try {
+    return VariableValue(node.as<float>());
+  } catch (...) {
+    // Ignore errors when trying to parse as float
+  }
+
+  // Default to string
+  return VariableValue(value);
+}
+
+std::optional<uint64_t> parseDuration(std::string_view text) {
+  // Timers take std::chrono::milliseconds
+  constexpr auto MAX_DURATION = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+
+  size_t digits = 0;
+  uint64_t count = 0;
+  for (; digits < text.size() && std::isdigit(static_cast<unsigned char>(text[digits])); ++digits) {
+    if (count > MAX_DURATION / 10) {
+      return std::nullopt;
+    }
+    count = count * 10 + static_cast<uint64_t>(text[digits] - '0');
+  }
+
+  const std::string_view unit = text.substr(digits);
+  const uint64_t scale = unit == "ms" ? 1 : unit == "s" ? 1000 : unit == "m" ? 60'000 : unit == "h" ? 3'600'000 : 0;
+  if (digits == 0 || count == 0 || scale == 0 || count > MAX_DURATION / scale) {
+    return std::nullopt;
+  }
+  return count * scale;
+}
+
+std::string timeoutEventName(std::string_view after) { return "after " + std::string(after); }
+
+// ============================================================================
+// Streaming ingestion
+// ============================================================================
+
+bool streamConfig(std::istream& input, CompiledConfig::Builder& builder) {
+  YAML::Parser parser(input);
+  ConfigEventHandler handler(builder);
+  try {
+    parser.HandleNextDocument(handler);
+  } catch (const Declined&) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace fsmconfig::detail
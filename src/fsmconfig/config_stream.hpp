@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "compiled_config_builder.hpp"
+#include "fsmconfig/types.hpp"
+
+namespace fsmconfig::detail {
+
+/**
+ * @file config_stream.hpp
+ * @brief Event-based YAML ingestion into CompiledConfig::Builder (library internal)
+ */
+
+/**
+ * @brief Convert YAML scalar text to a variable value
+ *
+ * "true"/"false" become BOOL, optionally signed digit strings that fit become
+ * INT, other numbers FLOAT, and everything else STRING.
+ *
+ * @param value Scalar text
+ * @return Typed value
+ */
+VariableValue parseScalarVariable(const std::string& value);
+
+/**
+ * @brief Convert a transition timeout such as "500ms", "5s", "2m" or "1h" to milliseconds
+ * @param text Digits followed by a unit (ms, s, m or h)
+ * @return Milliseconds, or std::nullopt unless text is a positive duration
+ */
+std::optional<uint64_t> parseDuration(std::string_view text);
+
+/**
+ * @brief Event name of a timed transition declared without 'event'
+ * @param after Timeout text as written in the configuration
+ * @return "after <timeout>", e.g. "after 5s"
+ */
+std::string timeoutEventName(std::string_view after);
+
+/**
+ * @brief Stream the first YAML document of input into builder
+ *
+ * Sections are consumed as yaml-cpp reports them, without building a node
+ * tree, so memory stays proportional to the compiled model. Documents that use
+ * aliases or deviate from the expected layout are declined; the caller then
+ * loads them through the node tree, which handles (or reports) every case.
+ *
+ * @param input Stream positioned at the start of the document
+ * @param builder Builder to fill; unusable if the document was declined
+ * @return false if the document must be loaded through the node tree instead
+ * @throws YAML::Exception on malformed YAML
+ */
+bool streamConfig(std::istream& input, CompiledConfig::Builder& builder);
+
+}  // namespace fsmconfig::detail
@@ -0,0 +1,285 @@
+#include "fsmconfig/config_watcher.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "fsmconfig/machine_definition.hpp"
+#include "fsmconfig/state_machine.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace fsmconfig {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+}  // namespace
+
+/**
+ * @brief ConfigWatcher implementation (Pimpl idiom)
+ */
+class ConfigWatcher::Impl {
+ public:
+  Impl(std::string path, DefinitionHandler handler, ConfigWatcherOptions watcher_options)
+      : config_path(std::move(path)), on_reload(std::move(handler)), options(watcher_options) {
+    const std::filesystem::path fs_path(config_path);
+    directory = fs_path.has_parent_path() ? fs_path.parent_path().string() : std::string(".");
+    file_name = fs_path.filename().string();
+  }
+
+  ~Impl() { stop(); }
+
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+  Impl(Impl&&) = delete;
+  Impl& operator=(Impl&&) = delete;
+
+  std::string config_path;
+  std::string directory;
+  std::string file_name;
+  DefinitionHandler on_reload;
+  ConfigWatcherOptions options;
+
+  mutable std::mutex mutex;
+  ErrorHandler error_handler;
+
+  std::thread thread;
+  std::atomic<bool> running{false};
+  std::atomic<bool> stop_requested{false};
+  std::atomic<uint64_t> reload_count{0};
+  std::atomic<uint64_t> rejected_count{0};
+
+#ifdef __linux__
+  int inotify_fd = -1;
+  int wake_fd = -1;
+#else
+  std::condition_variable wake;
+  std::optional<std::filesystem::file_time_type> last_write_time;
+#endif
+
+  void start() {
+    if (running.load()) {
+      throw ConfigException("ConfigWatcher is already running");
+    }
+    openWatch();
+    stop_requested.store(false);
+    running.store(true);
+    thread = std::thread([this] { run(); });
+  }
+
+  void stop() {
+    if (!running.load()) {
+      return;
+    }
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      stop_requested.store(true);
+    }
+    wakeUp();
+    thread.join();
+    closeWatch();
+    running.store(false);
+  }
+
+  void report(const std::string& error) const {
+    ErrorHandler handler;
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      handler = error_handler;
+    }
+    if (handler) {
+      handler(error);
+    }
+  }
+
+ private:
+  /**
+   * @brief Watcher thread loop
+   *
+   * Every change pushes the reload deadline forward by the debounce period;
+   * the file is loaded once the deadline passes without further changes.
+   */
+  void run() {
+    std::optional<Clock::time_point> deadline;
+    while (!stop_requested.load()) {
+      std::optional<std::chrono::milliseconds> timeout;
+      if (deadline) {
+        timeout = std::max(std::chrono::milliseconds(0),
+                           std::chrono::ceil<std::chrono::milliseconds>(*deadline - Clock::now()));
+      }
+
+      const bool changed = waitForChange(timeout);
+      if (stop_requested.load()) {
+        break;
+      }
+      if (changed) {
+        deadline = Clock::now() + options.debounce;
+      } else if (deadline && Clock::now() >= *deadline) {
+        deadline.reset();
+        reload();
+      }
+    }
+  }
+
+  void reload() {
+    try {
+      auto definition = MachineDefinition::fromFile(config_path);
+      on_reload(std::move(definition));
+      reload_count.fetch_add(1, std::memory_order_relaxed);
+    } catch (const std::exception& e) {
+      rejected_count.fetch_add(1, std::memory_order_relaxed);
+      report("Config reload rejected for '" + config_path + "': " + e.what());
+    }
+  }
+
+#ifdef __linux__
+  void openWatch() {
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) {
+      throw ConfigException(std::string("Failed to initialize inotify: ") + std::strerror(errno));
+    }
+    // Watch the directory so editors replacing the file by rename are still seen
+    if (inotify_add_watch(inotify_fd, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) < 0) {
+      const std::string error = "Failed to watch directory '" + directory + "': " + std::strerror(errno);
+      closeWatch();
+      throw ConfigException(error);
+    }
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+      const std::string error = std::string("Failed to create eventfd: ") + std::strerror(errno);
+      closeWatch();
+      throw ConfigException(error);
+    }
+  }
+
+  void closeWatch() {
+    if (inotify_fd >= 0) {
+      close(inotify_fd);
+      inotify_fd = -1;
+    }
+    if (wake_fd >= 0) {
+      close(wake_fd);
+      wake_fd = -1;
+    }
+  }
+
+  void wakeUp() const {
+    const uint64_t one = 1;
+    static_cast<void>(write(wake_fd, &one, sizeof(one)));
+  }
+
+  bool waitForChange(std::optional<std::chrono::milliseconds> timeout) {
+    std::array<pollfd, 2> fds{{{inotify_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}}};
+    const int timeout_ms = timeout ? static_cast<int>(timeout->count()) : -1;
+    if (poll(fds.data(), fds.size(), timeout_ms) <= 0 || (fds[0].revents & POLLIN) == 0) {
+      return false;
+    }
+
+    bool changed = false;
+    alignas(inotify_event) std::array<char, 4096> buffer{};
+    ssize_t length = 0;
+    while ((length = read(inotify_fd, buffer.data(), buffer.size())) > 0) {
+      for (ssize_t offset = 0; offset < length;) {
+        const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);  // NOLINT
+        if (event->len > 0 && file_name == event->name) {
+          changed = true;
+        }
+        offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      }
+    }
+    return changed;
+  }
+#else
+  void openWatch() { last_write_time = currentWriteTime(); }
+
+  void closeWatch() {}
+
+  void wakeUp() { wake.notify_all(); }
+
+  [[nodiscard]] std::optional<std::filesystem::file_time_type> currentWriteTime() const {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(config_path, ec);
+    if (ec) {
+      return std::nullopt;
+    }
+    return time;
+  }
+
+  bool waitForChange(std::optional<std::chrono::milliseconds> timeout) {
+    const auto interval = timeout ? std::min(*timeout, options.poll_interval) : options.poll_interval;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait_for(lock, interval, [this] { return stop_requested.load(); });
+    }
+    auto time = currentWriteTime();
+    if (time == last_write_time) {
+      return false;
+    }
+    last_write_time = time;
+    return time.has_value();
+  }
+#endif
+};
+
+// ============================================================================
+// Constructors and destructor
+// ============================================================================
+
+ConfigWatcher::ConfigWatcher(std::string config_path, DefinitionHandler on_reload, ConfigWatcherOptions options)
+    : impl_(std::make_unique<Impl>(std::move(config_path), std::move(on_reload), options)) {}
+
+ConfigWatcher::ConfigWatcher(std::string config_path, StateMachine& machine, ConfigWatcherOptions options)
+    : ConfigWatcher(
+          std::move(config_path),
+          [&machine](std::shared_ptr<const MachineDefinition> definition) {
+            machine.scheduleDefinition(std::move(definition));
+          },
+          options) {}
+
+ConfigWatcher::~ConfigWatcher() = default;
+
+// ============================================================================
+// Lifecycle methods
+// ============================================================================
+
+void ConfigWatcher::start() { impl_->start(); }
+
+void ConfigWatcher::stop() { impl_->stop(); }
+
+bool ConfigWatcher::isRunning() const { return impl_->running.load(); }
+
+void ConfigWatcher::setErrorHandler(ErrorHandler handler) {
+  const std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->error_handler = std::move(handler);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+uint64_t ConfigWatcher::getReloadCount() const { return impl_->reload_count.load(std::memory_order_relaxed); }
+
+uint64_t ConfigWatcher::getRejectedCount() const { return impl_->rejected_count.load(std::memory_order_relaxed); }
+
+}  // namespace fsmconfig
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace fsmconfig::detail {
+
+/**
+ * @file content_hash.hpp
+ * @brief Stable content hashing (library internal)
+ */
+
+/**
+ * @brief 64-bit FNV-1a hash of a byte sequence
+ *
+ * Unlike std::hash, the value is the same across runs and platforms, so it can
+ * key persistent data.
+ *
+ * @param data Bytes to hash
+ * @param seed Initial value; pass an earlier result to hash several pieces
+ * @return Hash value
+ */
+constexpr uint64_t contentHash(std::string_view data, uint64_t seed = 14695981039346656037ULL) noexcept {
+  uint64_t hash = seed;
+  for (const char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace fsmconfig::detail
@@ -0,0 +1,193 @@
+#include "fsmconfig/definition_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "content_hash.hpp"
+#include "file_io.hpp"
+#include "fsmconfig/machine_definition.hpp"
+
+namespace fsmconfig {
+
+namespace {
+
+/// Identity of a file content
+struct ContentKey {
+  uint64_t hash = 0;
+  size_t size = 0;
+
+  bool operator==(const ContentKey&) const = default;
+};
+
+struct ContentKeyHash {
+  size_t operator()(const ContentKey& key) const noexcept { return static_cast<size_t>(key.hash ^ key.size); }
+};
+
+/**
+ * @brief Run task(i) for i in [0, count) on up to threads workers
+ *
+ * The calling thread takes part in the work, so threads == 1 runs inline.
+ */
+void parallelFor(size_t count, size_t threads, const std::function<void(size_t)>& task) {
+  std::atomic<size_t> next{0};
+  const auto worker = [&] {
+    for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+      task(i);
+    }
+  };
+
+  const size_t worker_count = std::min(threads, count);
+  std::vector<std::jthread> helpers;
+  helpers.reserve(worker_count > 0 ? worker_count - 1 : 0);
+  for (size_t i = 1; i < worker_count; ++i) {
+    helpers.emplace_back(worker);
+  }
+  worker();
+}
+
+}  // namespace
+
+/**
+ * @brief DefinitionCache implementation (Pimpl idiom)
+ */
+class DefinitionCache::Impl {
+ public:
+  mutable std::mutex mutex;
+
+  /// Definitions by content
+  std::unordered_map<ContentKey, std::shared_ptr<const MachineDefinition>, ContentKeyHash> by_content;
+
+  /// Definitions by path of the file they were last loaded from
+  std::unordered_map<std::string, std::shared_ptr<const MachineDefinition>> by_path;
+};
+
+// ============================================================================
+// Constructors and destructor
+// ============================================================================
+
+DefinitionCache::DefinitionCache() : impl_(std::make_unique<Impl>()) {}
+
+DefinitionCache::~DefinitionCache() = default;
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+std::vector<std::shared_ptr<const MachineDefinition>> DefinitionCache::loadAll(const std::vector<std::string>& paths,
+                                                                               size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  // Read and hash every file
+  std::vector<std::string> contents(paths.size());
+  std::vector<ContentKey> keys(paths.size());
+  std::vector<std::string> errors(paths.size());
+  parallelFor(paths.size(), threads, [&](size_t i) {
+    auto content = detail::readFile(paths[i]);
+    if (!content) {
+      errors[i] = "Failed to open configuration file";
+      return;
+    }
+    keys[i] = ContentKey{detail::contentHash(*content), content->size()};
+    contents[i] = std::move(*content);
+  });
+
+  // Pick one file per distinct content that still has to be parsed
+  std::vector<size_t> to_parse;
+  std::unordered_map<ContentKey, size_t, ContentKeyHash> first_with_key;
+  std::vector<std::shared_ptr<const MachineDefinition>> result(paths.size());
+  {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    for (size_t i = 0; i < paths.size(); ++i) {
+      if (!errors[i].empty()) {
+        continue;
+      }
+      if (auto it = impl_->by_content.find(keys[i]); it != impl_->by_content.end()) {
+        result[i] = it->second;
+      } else if (first_with_key.emplace(keys[i], i).second) {
+        to_parse.push_back(i);
+      }
+    }
+  }
+
+  // Parse and validate distinct contents in parallel
+  parallelFor(to_parse.size(), threads, [&](size_t job) {
+    const size_t i = to_parse[job];
+    try {
+      result[i] = MachineDefinition::fromString(contents[i]);
+    } catch (const std::exception& e) {
+      errors[i] = e.what();
+    }
+    contents[i] = std::string();
+  });
+
+  // Publish and resolve duplicates
+  std::ostringstream failures;
+  size_t failure_count = 0;
+  {
+    const std::lock_guard<std::mutex> lock(impl_->mutex);
+    for (const size_t i : to_parse) {
+      if (result[i]) {
+        // A concurrent loadAll() may have published the same content first
+        result[i] = impl_->by_content.emplace(keys[i], result[i]).first->second;
+      }
+    }
+    for (size_t i = 0; i < paths.size(); ++i) {
+      if (!result[i] && errors[i].empty()) {
+        const size_t first = first_with_key.at(keys[i]);
+        result[i] = result[first];
+        errors[i] = errors[first];
+      }
+      if (result[i]) {
+        impl_->by_path[paths[i]] = result[i];
+      } else {
+        failures << (failure_count++ > 0 ? "; " : "") << paths[i] << ": " << errors[i];
+      }
+    }
+  }
+
+  if (failure_count > 0) {
+    throw ConfigException("Failed to load " + std::to_string(failure_count) + " configuration file(s): " +
+                          failures.str());
+  }
+  return result;
+}
+
+std::shared_ptr<const MachineDefinition> DefinitionCache::load(const std::string& path) {
+  return loadAll({path}, 1).front();
+}
+
+// ============================================================================
+// Cache access
+// ============================================================================
+
+std::shared_ptr<const MachineDefinition> DefinitionCache::get(const std::string& path) const {
+  const std::lock_guard<std::mutex> lock(impl_->mutex);
+  auto it = impl_->by_path.find(path);
+  return it != impl_->by_path.end() ? it->second : nullptr;
+}
+
+size_t DefinitionCache::size() const {
+  const std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->by_content.size();
+}
+
+void DefinitionCache::clear() {
+  const std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->by_content.clear();
+  impl_->by_path.clear();
+}
+
+}  // namespace fsmconfig
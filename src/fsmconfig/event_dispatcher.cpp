@@ -1,15 +1,23 @@
 #include "fsmconfig/event_dispatcher.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 
+#include "fsmconfig/compiled_config.hpp"
 #include "fsmconfig/types.hpp"
+#include "mpsc_queue.hpp"
 
 namespace fsmconfig {
 
@@ -18,13 +26,34 @@ namespace fsmconfig {
  */
 class EventDispatcher::Impl {
  public:
-  /// Event queue: pair<event_name, event>
-  std::queue<std::pair<std::string, TransitionEvent>> event_queue;
+  /// Payload of a pending event that later dispatches may replace (guarded by coalesce_mutex)
+  struct PendingSlot {
+    std::string key;
+    TransitionEvent event;
+  };
+
+  /// Queued event; with a slot the payload lives in the slot instead of event
+  struct QueuedEvent {
+    std::string name;
+    TransitionEvent event;
+    std::shared_ptr<PendingSlot> slot;
+  };
+
+  /// Priority lane; producers push lock-free, the consumer pops under queue_mutex
+  struct Lane {
+    detail::MpscQueue<QueuedEvent> events;
+
+    /// Events in the lane; counted once they are linked into the queue
+    std::atomic<size_t> depth{0};
+  };
+
+  /// Lanes indexed by EventPriority
+  std::array<Lane, EVENT_PRIORITY_COUNT> lanes;
 
   /// Event handler
   EventHandler event_handler;
 
-  /// Mutex for queue protection
+  /// Mutex for consumer side and handler protection
   mutable std::mutex queue_mutex;
 
   /// Condition variable for waiting
@@ -33,14 +62,283 @@ class EventDispatcher::Impl {
   /// Dispatcher running flag
   std::atomic<bool> running;
 
+  /// Lane selection (guarded by queue_mutex)
+  DrainPolicy drain_policy = DrainPolicy::STRICT;
+  LaneWeights lane_weights = {8, 4, 2, 1};
+  size_t current_lane = 0;   ///< WEIGHTED: lane being served
+  uint32_t lane_credit = 8;  ///< WEIGHTED: events left for current_lane this round
+
+  /// Reserved queue entries: queued events plus dispatches still pushing theirs
+  std::atomic<size_t> size{0};
+
+  /// Capacity settings, read lock-free by producers (capacity 0 = unbounded)
+  std::atomic<size_t> capacity{0};
+  std::atomic<OverflowPolicy> overflow_policy{OverflowPolicy::REJECT};
+  std::atomic<int64_t> block_timeout_ms{100};
+
+  /// OverflowPolicy::BLOCK waiting
+  std::mutex space_mutex;
+  std::condition_variable space_cv;
+  std::atomic<size_t> blocked{0};  ///< Producers waiting on space_cv
+
+  /// Latest pending slot per coalescing key (lock order: queue_mutex before coalesce_mutex)
+  std::mutex coalesce_mutex;
+  std::unordered_map<std::string, std::shared_ptr<PendingSlot>> pending_slots;
+
+  /// Coalescing rules: event name -> key field (guarded by coalesce_mutex)
+  std::unordered_map<std::string, std::string> coalescing_rules;
+
+  /// Number of rules, so dispatches skip coalesce_mutex while there are none
+  std::atomic<size_t> rule_count{0};
+
+  /// Dispatch outcome counters
+  std::atomic<uint64_t> enqueued{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<uint64_t> coalesced{0};
+  std::atomic<uint64_t> rejected{0};
+  std::atomic<uint64_t> timed_out{0};
+
+  [[nodiscard]] size_t totalDepth() const {
+    size_t total = 0;
+    for (const Lane& lane : lanes) {
+      total += lane.depth.load(std::memory_order_acquire);
+    }
+    return total;
+  }
+
+  /**
+   * @brief Pick the lane to take the next event from (queue_mutex held)
+   * @return Lane index or std::nullopt if every lane is empty
+   */
+  std::optional<size_t> pickLane() {
+    if (drain_policy == DrainPolicy::STRICT) {
+      for (size_t i = 0; i < lanes.size(); ++i) {
+        if (lanes[i].depth.load(std::memory_order_acquire) > 0) {
+          return i;
+        }
+      }
+      return std::nullopt;
+    }
+
+    // WEIGHTED: serve the current lane until its credit runs out or it empties
+    for (size_t visited = 0; visited <= lanes.size(); ++visited) {
+      if (lane_credit > 0 && lanes[current_lane].depth.load(std::memory_order_acquire) > 0) {
+        --lane_credit;
+        return current_lane;
+      }
+      current_lane = (current_lane + 1) % lanes.size();
+      lane_credit = lane_weights[current_lane];
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Reserve one queue entry if below capacity
+   */
+  bool tryReserve() {
+    const size_t limit = capacity.load(std::memory_order_relaxed);
+    size_t current = size.load(std::memory_order_relaxed);
+    do {
+      if (limit != 0 && current >= limit) {
+        return false;
+      }
+    } while (!size.compare_exchange_weak(current, current + 1));
+    return true;
+  }
+
+  /**
+   * @brief Return one queue entry and wake a producer blocked on a full queue
+   */
+  void release() {
+    size.fetch_sub(1);
+    if (blocked.load() > 0) {
+      std::scoped_lock const lock(space_mutex);
+      space_cv.notify_all();
+    }
+  }
+
+  /**
+   * @brief Append event holding a reserved entry
+   */
+  void push(Lane& lane, QueuedEvent queued) {
+    lane.events.push(std::move(queued));
+    lane.depth.fetch_add(1, std::memory_order_acq_rel);
+    enqueued.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Take the oldest event of a lane known to be non-empty (queue_mutex held)
+   */
+  QueuedEvent pop(Lane& lane) {
+    auto event = lane.events.pop();
+    while (!event) {
+      // A producer ahead of the counted one has not linked its node yet
+      std::this_thread::yield();
+      event = lane.events.pop();
+    }
+    lane.depth.fetch_sub(1, std::memory_order_acq_rel);
+    if (event->slot) {
+      std::scoped_lock const lock(coalesce_mutex);
+      auto it = pending_slots.find(event->slot->key);
+      if (it != pending_slots.end() && it->second == event->slot) {
+        pending_slots.erase(it);
+      }
+      event->event = std::move(event->slot->event);
+      event->slot.reset();
+    }
+    release();
+    return std::move(*event);
+  }
+
+  /**
+   * @brief Reserve an entry for a dispatch finding the queue full
+   * @param lane Lane index of the new event
+   * @return ENQUEUED or DROPPED_OLDEST if an entry was reserved, otherwise why not
+   */
+  DispatchResult makeRoom(OverflowPolicy policy, size_t lane) {
+    if (policy == OverflowPolicy::BLOCK) {
+      const auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(block_timeout_ms.load(std::memory_order_relaxed));
+      blocked.fetch_add(1);
+      bool reserved = false;
+      {
+        std::unique_lock<std::mutex> lock(space_mutex);
+        reserved = space_cv.wait_until(lock, deadline, [this]() { return tryReserve(); });
+      }
+      blocked.fetch_sub(1);
+      if (reserved) {
+        return DispatchResult::ENQUEUED;
+      }
+      timed_out.fetch_add(1, std::memory_order_relaxed);
+      return DispatchResult::TIMED_OUT;
+    }
+
+    if (policy == OverflowPolicy::DROP_OLDEST) {
+      std::scoped_lock const lock(queue_mutex);
+      // Never shed a more urgent event for a less urgent one
+      for (size_t victim = lanes.size(); victim-- > lane;) {
+        while (lanes[victim].depth.load(std::memory_order_acquire) > 0) {
+          pop(lanes[victim]);
+          dropped.fetch_add(1, std::memory_order_relaxed);
+          if (tryReserve()) {
+            return DispatchResult::DROPPED_OLDEST;
+          }
+        }
+      }
+    }
+
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    return DispatchResult::REJECTED;
+  }
+
+  /**
+   * @brief Queue an event without coalescing
+   */
+  DispatchResult dispatchQueued(size_t lane, const std::string& event_name, const TransitionEvent& event,
+                                OverflowPolicy policy) {
+    DispatchResult result = DispatchResult::ENQUEUED;
+    if (!tryReserve()) {
+      result = makeRoom(policy, lane);
+      if (result != DispatchResult::ENQUEUED && result != DispatchResult::DROPPED_OLDEST) {
+        return result;
+      }
+    }
+    push(lanes[lane], QueuedEvent{event_name, event, nullptr});
+    return result;
+  }
+
+  /**
+   * @brief Coalescing key of an event with a rule
+   */
+  static std::string coalescingKey(const std::string& event_name, const std::string& key_field,
+                                   const TransitionEvent& event) {
+    std::string key = event_name;
+    if (const auto it = event.data.find(key_field); !key_field.empty() && it != event.data.end()) {
+      key += '\0';
+      key += static_cast<char>('0' + static_cast<int>(it->second.type));
+      key += it->second.toString();
+    }
+    return key;
+  }
+
+  /**
+   * @brief Replace the payload of the pending event with a key (coalesce_mutex held)
+   * @return false if no event with the key is pending
+   */
+  bool merge(const std::string& key, const TransitionEvent& event) {
+    const auto it = pending_slots.find(key);
+    if (it == pending_slots.end()) {
+      return false;
+    }
+    it->second->event = event;
+    coalesced.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief Dispatch an event that may be merged into a pending one
+   *
+   * Events with a coalescing rule are merged whenever an instance with the
+   * same key is pending. Under OverflowPolicy::COALESCE every queued event
+   * gets a slot registered under its key, so a dispatch finding the queue full
+   * can overwrite the latest pending event with the same name.
+   */
+  DispatchResult dispatchCoalescing(size_t lane, const std::string& event_name, const TransitionEvent& event,
+                                    OverflowPolicy policy) {
+    std::unique_lock<std::mutex> lock(coalesce_mutex);
+    const auto rule = coalescing_rules.find(event_name);
+    const bool has_rule = rule != coalescing_rules.end();
+    if (!has_rule && policy != OverflowPolicy::COALESCE) {
+      lock.unlock();
+      return dispatchQueued(lane, event_name, event, policy);
+    }
+
+    std::string key = has_rule ? coalescingKey(event_name, rule->second, event) : event_name;
+    if (has_rule && merge(key, event)) {
+      return DispatchResult::COALESCED;
+    }
+
+    DispatchResult result = DispatchResult::ENQUEUED;
+    if (!tryReserve()) {
+      if (policy == OverflowPolicy::COALESCE) {
+        if (merge(key, event)) {
+          return DispatchResult::COALESCED;
+        }
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        return DispatchResult::REJECTED;
+      }
+
+      // Waiting or dropping must not hold coalesce_mutex, the consumer needs it
+      lock.unlock();
+      result = makeRoom(policy, lane);
+      if (result != DispatchResult::ENQUEUED && result != DispatchResult::DROPPED_OLDEST) {
+        return result;
+      }
+      lock.lock();
+      if (merge(key, event)) {
+        // Another producer queued the same key meanwhile
+        release();
+        return DispatchResult::COALESCED;
+      }
+    }
+
+    auto slot = std::make_shared<PendingSlot>(PendingSlot{key, event});
+    pending_slots.insert_or_assign(std::move(key), slot);
+    push(lanes[lane], QueuedEvent{event_name, {}, std::move(slot)});
+    return result;
+  }
+
   /**
    * @brief Clear event queue
    */
   void clear() {
     std::scoped_lock const lock(queue_mutex);
-    while (!event_queue.empty()) {
-      event_queue.pop();
+    for (Lane& lane : lanes) {
+      while (lane.depth.load(std::memory_order_acquire) > 0) {
+        pop(lane);
+      }
     }
+    queue_cv.notify_all();
   }
 };
 
@@ -61,10 +359,14 @@ EventDispatcher& EventDispatcher::operator=(EventDispatcher&& other) noexcept {
   return *this;
 }
 
-void EventDispatcher::dispatchEvent(const std::string& event_name, const TransitionEvent& event) {
-  std::scoped_lock const lock(impl_->queue_mutex);
-  impl_->event_queue.emplace(event_name, event);
-  impl_->queue_cv.notify_one();
+DispatchResult EventDispatcher::dispatchEvent(const std::string& event_name, const TransitionEvent& event,
+                                              EventPriority priority) {
+  const size_t lane = static_cast<size_t>(priority) % EVENT_PRIORITY_COUNT;
+  const OverflowPolicy policy = impl_->overflow_policy.load(std::memory_order_relaxed);
+  if (policy == OverflowPolicy::COALESCE || impl_->rule_count.load(std::memory_order_acquire) > 0) {
+    return impl_->dispatchCoalescing(lane, event_name, event, policy);
+  }
+  return impl_->dispatchQueued(lane, event_name, event, policy);
 }
 
 void EventDispatcher::processEvents() {
@@ -76,32 +378,120 @@ void EventDispatcher::processEvents() {
 bool EventDispatcher::processOneEvent() {
   std::unique_lock<std::mutex> lock(impl_->queue_mutex);
 
-  if (impl_->event_queue.empty()) {
+  const auto lane = impl_->pickLane();
+  if (!lane) {
     return false;
   }
 
-  auto event_pair = std::move(impl_->event_queue.front());
-  impl_->event_queue.pop();
+  auto queued = impl_->pop(impl_->lanes[*lane]);
+  if (impl_->totalDepth() == 0) {
+    impl_->queue_cv.notify_all();
+  }
   lock.unlock();
 
   // Call event handler if set
   if (impl_->event_handler) {
-    impl_->event_handler(event_pair.first, event_pair.second);
+    impl_->event_handler(queued.name, queued.event);
   }
 
   return true;
 }
 
-size_t EventDispatcher::getEventQueueSize() const {
-  std::scoped_lock const lock(impl_->queue_mutex);
-  return impl_->event_queue.size();
+size_t EventDispatcher::getEventQueueSize() const { return impl_->totalDepth(); }
+
+size_t EventDispatcher::getEventQueueSize(EventPriority priority) const {
+  return impl_->lanes[static_cast<size_t>(priority) % EVENT_PRIORITY_COUNT].depth.load(std::memory_order_acquire);
 }
 
 void EventDispatcher::clearEventQueue() { impl_->clear(); }
 
-bool EventDispatcher::hasPendingEvents() const {
+bool EventDispatcher::hasPendingEvents() const { return impl_->totalDepth() > 0; }
+
+bool EventDispatcher::hasPendingEvents(EventPriority priority) const { return getEventQueueSize(priority) > 0; }
+
+void EventDispatcher::setDrainPolicy(DrainPolicy policy) {
   std::scoped_lock const lock(impl_->queue_mutex);
-  return !impl_->event_queue.empty();
+  impl_->drain_policy = policy;
+}
+
+DrainPolicy EventDispatcher::getDrainPolicy() const {
+  std::scoped_lock const lock(impl_->queue_mutex);
+  return impl_->drain_policy;
+}
+
+void EventDispatcher::setLaneWeights(const LaneWeights& weights) {
+  if (std::find(weights.begin(), weights.end(), 0U) != weights.end()) {
+    throw StateException("EventDispatcher lane weights must be positive");
+  }
+  std::scoped_lock const lock(impl_->queue_mutex);
+  impl_->lane_weights = weights;
+  impl_->lane_credit = std::min(impl_->lane_credit, weights[impl_->current_lane]);
+}
+
+LaneWeights EventDispatcher::getLaneWeights() const {
+  std::scoped_lock const lock(impl_->queue_mutex);
+  return impl_->lane_weights;
+}
+
+void EventDispatcher::setCapacity(size_t capacity) {
+  impl_->capacity.store(capacity);
+  std::scoped_lock const lock(impl_->space_mutex);
+  impl_->space_cv.notify_all();
+}
+
+size_t EventDispatcher::getCapacity() const { return impl_->capacity.load(); }
+
+void EventDispatcher::setOverflowPolicy(OverflowPolicy policy) { impl_->overflow_policy.store(policy); }
+
+OverflowPolicy EventDispatcher::getOverflowPolicy() const { return impl_->overflow_policy.load(); }
+
+void EventDispatcher::setBlockTimeout(std::chrono::milliseconds timeout) {
+  impl_->block_timeout_ms.store(std::max<int64_t>(timeout.count(), 0));
+}
+
+std::chrono::milliseconds EventDispatcher::getBlockTimeout() const {
+  return std::chrono::milliseconds(impl_->block_timeout_ms.load());
+}
+
+DispatchStats EventDispatcher::getDispatchStats() const {
+  DispatchStats stats;
+  stats.enqueued = impl_->enqueued.load(std::memory_order_relaxed);
+  stats.dropped = impl_->dropped.load(std::memory_order_relaxed);
+  stats.coalesced = impl_->coalesced.load(std::memory_order_relaxed);
+  stats.rejected = impl_->rejected.load(std::memory_order_relaxed);
+  stats.timed_out = impl_->timed_out.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void EventDispatcher::resetDispatchStats() {
+  impl_->enqueued.store(0, std::memory_order_relaxed);
+  impl_->dropped.store(0, std::memory_order_relaxed);
+  impl_->coalesced.store(0, std::memory_order_relaxed);
+  impl_->rejected.store(0, std::memory_order_relaxed);
+  impl_->timed_out.store(0, std::memory_order_relaxed);
+}
+
+void EventDispatcher::setCoalescing(const std::string& event_name, const std::string& key_field) {
+  std::scoped_lock const lock(impl_->coalesce_mutex);
+  impl_->coalescing_rules.insert_or_assign(event_name, key_field);
+  impl_->rule_count.store(impl_->coalescing_rules.size(), std::memory_order_release);
+}
+
+void EventDispatcher::clearCoalescing(const std::string& event_name) {
+  std::scoped_lock const lock(impl_->coalesce_mutex);
+  impl_->coalescing_rules.erase(event_name);
+  impl_->rule_count.store(impl_->coalescing_rules.size(), std::memory_order_release);
+}
+
+bool EventDispatcher::isCoalescing(const std::string& event_name) const {
+  std::scoped_lock const lock(impl_->coalesce_mutex);
+  return impl_->coalescing_rules.contains(event_name);
+}
+
+void EventDispatcher::loadCoalescing(const CompiledConfig& config) {
+  for (const CompiledCoalescing& rule : config.coalescedEvents()) {
+    setCoalescing(std::string(config.str(rule.event)), std::string(config.str(rule.key)));
+  }
 }
 
 void EventDispatcher::setEventHandler(EventHandler handler) {
@@ -125,7 +515,7 @@ bool EventDispatcher::isRunning() const { return impl_->running.load(); }
 
 void EventDispatcher::waitForEmptyQueue() const {
   std::unique_lock<std::mutex> lock(impl_->queue_mutex);
-  impl_->queue_cv.wait(lock, [this]() { return impl_->event_queue.empty() || !impl_->running; });
+  impl_->queue_cv.wait(lock, [this]() { return impl_->totalDepth() == 0 || !impl_->running; });
 }
 
 }  // namespace fsmconfig
@@ -0,0 +1,284 @@
+#include "fsmconfig/executor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "fsmconfig/state_machine.hpp"
+#include "mpsc_queue.hpp"
+
+namespace fsmconfig {
+
+namespace {
+
+/// Worker the current thread belongs to
+struct CurrentWorker {
+  const void* executor = nullptr;
+  size_t index = 0;
+};
+
+thread_local CurrentWorker current_worker;
+
+}  // namespace
+
+/**
+ * @brief Event queue of one attached machine
+ */
+class Executor::Mailbox {
+ public:
+  /// Event waiting for its machine
+  struct PostedEvent {
+    std::string name;
+    std::map<std::string, VariableValue> data;
+  };
+
+  explicit Mailbox(StateMachine& target) : machine(&target) {}
+
+  StateMachine* machine;
+  detail::MpscQueue<PostedEvent> events;
+
+  /// Posted events not processed yet; counted before they are pushed
+  std::atomic<size_t> pending{0};
+
+  /// Set while the mailbox waits on a worker deque or runs on a worker
+  std::atomic<bool> scheduled{false};
+};
+
+/**
+ * @brief Executor implementation (Pimpl idiom)
+ */
+class Executor::Impl {
+ public:
+  /// Scheduled mailboxes of one worker; the owner takes the front, thieves the back
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::shared_ptr<Mailbox>> tasks;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::jthread> threads;
+
+  /// Tasks in all deques; counted before they are pushed
+  std::atomic<size_t> queued{0};
+
+  /// Sleeping workers
+  std::atomic<size_t> sleepers{0};
+  std::atomic<bool> stopping{false};
+  std::mutex sleep_mutex;
+  std::condition_variable sleep_cv;
+
+  /// Mailboxes scheduled or running
+  std::atomic<size_t> active{0};
+  std::mutex idle_mutex;
+  std::condition_variable idle_cv;
+
+  /// Target worker of the next post from a non-worker thread
+  std::atomic<size_t> next_worker{0};
+
+  std::atomic<uint64_t> processed{0};
+  std::atomic<uint64_t> steals{0};
+
+  std::mutex handler_mutex;
+  ErrorHandler error_handler;
+
+  /**
+   * @brief Queue mailbox on the current worker, or round-robin from other threads
+   */
+  void schedule(std::shared_ptr<Mailbox> mailbox) {
+    const size_t index = current_worker.executor == this
+                             ? current_worker.index
+                             : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+    queued.fetch_add(1);
+    {
+      const std::scoped_lock lock(workers[index]->mutex);
+      workers[index]->tasks.push_back(std::move(mailbox));
+    }
+
+    if (sleepers.load() > 0) {
+      const std::scoped_lock lock(sleep_mutex);
+      sleep_cv.notify_one();
+    }
+  }
+
+  /**
+   * @brief Take a task from the own deque or steal one
+   * @return Mailbox or nullptr if no task was found
+   */
+  std::shared_ptr<Mailbox> take(size_t index) {
+    std::shared_ptr<Mailbox> task;
+    {
+      Worker& own = *workers[index];
+      const std::scoped_lock lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.front());
+        own.tasks.pop_front();
+      }
+    }
+
+    for (size_t offset = 1; !task && offset < workers.size(); ++offset) {
+      Worker& victim = *workers[(index + offset) % workers.size()];
+      const std::unique_lock lock(victim.mutex, std::try_to_lock);
+      if (lock.owns_lock() && !victim.tasks.empty()) {
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        steals.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    if (task) {
+      queued.fetch_sub(1);
+    }
+    return task;
+  }
+
+  /**
+   * @brief Process up to BATCH_SIZE events of a mailbox
+   */
+  void run(const std::shared_ptr<Mailbox>& mailbox) {
+    Mailbox& box = *mailbox;
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+      auto event = box.events.pop();
+      if (!event) {
+        break;
+      }
+      box.pending.fetch_sub(1);
+
+      try {
+        box.machine->triggerEvent(event->name, event->data);
+      } catch (const std::exception& e) {
+        report(e.what());
+      } catch (...) {
+        report("Event '" + event->name + "' failed with an unknown exception");
+      }
+      processed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // A producer that saw scheduled == true relies on this check to pick up its event
+    box.scheduled.store(false);
+    if (box.pending.load() > 0 && !box.scheduled.exchange(true)) {
+      schedule(mailbox);
+      return;
+    }
+
+    if (active.fetch_sub(1) == 1) {
+      const std::scoped_lock lock(idle_mutex);
+      idle_cv.notify_all();
+    }
+  }
+
+  void workerLoop(size_t index) {
+    current_worker = CurrentWorker{this, index};
+    while (true) {
+      if (auto task = take(index)) {
+        run(task);
+        continue;
+      }
+
+      std::unique_lock lock(sleep_mutex);
+      sleepers.fetch_add(1);
+      sleep_cv.wait(lock, [this] { return queued.load() > 0 || stopping.load(); });
+      sleepers.fetch_sub(1);
+      if (stopping.load() && queued.load() == 0) {
+        return;
+      }
+    }
+  }
+
+  void report(const std::string& error) {
+    ErrorHandler handler;
+    {
+      const std::scoped_lock lock(handler_mutex);
+      handler = error_handler;
+    }
+    if (handler) {
+      handler(error);
+    }
+  }
+
+  void waitIdle() {
+    std::unique_lock lock(idle_mutex);
+    idle_cv.wait(lock, [this] { return active.load() == 0; });
+  }
+};
+
+// ============================================================================
+// Constructors and destructor
+// ============================================================================
+
+Executor::Executor(size_t threads) : impl_(std::make_unique<Impl>()) {
+  if (threads == 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  impl_->workers.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    impl_->workers.push_back(std::make_unique<Impl::Worker>());
+  }
+  impl_->threads.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    impl_->threads.emplace_back([impl = impl_.get(), i] { impl->workerLoop(i); });
+  }
+}
+
+Executor::~Executor() {
+  impl_->waitIdle();
+  {
+    const std::scoped_lock lock(impl_->sleep_mutex);
+    impl_->stopping.store(true);
+  }
+  impl_->sleep_cv.notify_all();
+  impl_->threads.clear();
+}
+
+// ============================================================================
+// Machines and events
+// ============================================================================
+
+std::shared_ptr<Executor::Mailbox> Executor::attach(StateMachine& machine) {
+  return std::make_shared<Mailbox>(machine);
+}
+
+void Executor::post(const std::shared_ptr<Mailbox>& mailbox, std::string event_name,
+                    std::map<std::string, VariableValue> data) {
+  if (!mailbox) {
+    throw StateException("Executor mailbox must not be null");
+  }
+
+  mailbox->pending.fetch_add(1);
+  mailbox->events.push(Mailbox::PostedEvent{std::move(event_name), std::move(data)});
+  if (!mailbox->scheduled.exchange(true)) {
+    impl_->active.fetch_add(1);
+    impl_->schedule(mailbox);
+  }
+}
+
+void Executor::waitIdle() { impl_->waitIdle(); }
+
+void Executor::setErrorHandler(ErrorHandler handler) {
+  const std::scoped_lock lock(impl_->handler_mutex);
+  impl_->error_handler = std::move(handler);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+size_t Executor::getThreadCount() const { return impl_->threads.size(); }
+
+uint64_t Executor::getProcessedCount() const { return impl_->processed.load(std::memory_order_relaxed); }
+
+uint64_t Executor::getStealCount() const { return impl_->steals.load(std::memory_order_relaxed); }
+
+}  // namespace fsmconfig
@@ -0,0 +1,88 @@
+#include "file_io.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#define FSMCONFIG_HAS_POSIX_IO 1
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace fsmconfig::detail {
+
+// ============================================================================
+// FileView
+// ============================================================================
+
+#ifdef FSMCONFIG_HAS_POSIX_IO
+
+bool FileView::open(const std::filesystem::path& path, std::string& buffer) {
+  data_ = {};
+
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+
+  // Regular files are read in one call (plus the one reporting end of file); files that shrink or grow meanwhile
+  // are read as far as they go
+  struct stat info {};
+  size_t expected = 0;
+  if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+    expected = static_cast<size_t>(info.st_size) + 1;
+  }
+
+  buffer.clear();
+  size_t size = 0;
+  for (;;) {
+    if (buffer.size() - size < 4096) {
+      buffer.resize(std::max({buffer.capacity(), size + 65536, expected}));
+    }
+    const ssize_t count = ::read(fd, buffer.data() + size, buffer.size() - size);
+    if (count == 0) {
+      break;
+    }
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ::close(fd);
+      buffer.clear();
+      return false;
+    }
+    size += static_cast<size_t>(count);
+  }
+  ::close(fd);
+  buffer.resize(size);
+  data_ = buffer;
+  return true;
+}
+
+#else
+
+bool FileView::open(const std::filesystem::path& path, std::string& buffer) {
+  data_ = {};
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (file.bad()) {
+    return false;
+  }
+  data_ = buffer;
+  return true;
+}
+
+#endif
+
+}  // namespace fsmconfig::detail
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace fsmconfig::detail {
+
+/**
+ * @file file_io.hpp
+ * @brief Whole-file reading and atomic replacement (library internal)
+ */
+
+/**
+ * @class FileView
+ * @brief Read-only view of a whole file read into a reused buffer
+ *
+ * Files are read with a single read loop into a caller-provided buffer, which
+ * keeps its capacity between loads; regular files are sized up front. Files
+ * are not memory-mapped: a configuration truncated while it is parsed (an
+ * in-place save during a reload) would otherwise fault the process.
+ */
+class FileView {
+ public:
+  FileView() = default;
+  ~FileView() = default;
+
+  // Copy and move prohibition
+  FileView(const FileView&) = delete;
+  FileView& operator=(const FileView&) = delete;
+  FileView(FileView&&) = delete;
+  FileView& operator=(FileView&&) = delete;
+
+  /**
+   * @brief Open file
+   * @param path File path
+   * @param buffer Storage of the content
+   * @return false if the file cannot be read
+   */
+  bool open(const std::filesystem::path& path, std::string& buffer);
+
+  /**
+   * @brief Get file content (valid while buffer is neither modified nor destroyed)
+   */
+  [[nodiscard]] std::string_view data() const { return data_; }
+
+ private:
+  std::string_view data_;
+};
+
+/**
+ * @brief Read whole file
+ * @param path File path
+ * @return File content or std::nullopt if the file cannot be read
+ */
+inline std::optional<std::string> readFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (file.bad()) {
+    return std::nullopt;
+  }
+  return content;
+}
+
+/**
+ * @brief Replace file content atomically
+ *
+ * The data is written to a temporary file next to the target and renamed over
+ * it, so concurrent readers see either the old or the complete new content.
+ *
+ * @param path Target file path
+ * @param data New content
+ * @return true on success
+ */
+inline bool writeFileAtomically(const std::filesystem::path& path, std::string_view data) {
+  static std::atomic<unsigned> counter{0};
+  std::filesystem::path temporary = path;
+  temporary += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "." +
+               std::to_string(counter.fetch_add(1));
+
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    file.close();
+    if (!file) {
+      std::error_code ignored;
+      std::filesystem::remove(temporary, ignored);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace fsmconfig::detail
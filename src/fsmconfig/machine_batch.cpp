@@ -0,0 +1,449 @@
+#include "fsmconfig/machine_batch.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "binary_io.hpp"
+#include "fsmconfig/machine_definition.hpp"
+#include "fsmconfig/types.hpp"
+
+// The AVX2 kernel is compiled for the target with a function attribute and chosen at run time,
+// so the rest of the library does not require an AVX2 CPU
+#if defined(FSMCONFIG_ENABLE_AVX2) && (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define FSMCONFIG_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace fsmconfig {
+
+namespace {
+
+/// Snapshot signature
+constexpr uint32_t BATCH_SNAPSHOT_MAGIC = 0x424D5346;  // "FSMB"
+
+/// Layout version; bump when the encoding changes
+constexpr uint32_t BATCH_SNAPSHOT_FORMAT = 1;
+
+/**
+ * @brief Move instances through a transition table row
+ * @param states Current states, updated in place
+ * @param count Number of instances
+ * @param row Next state indexed by current state
+ * @param base Index of states[0] in the batch
+ * @param changed Receives the indices of the instances that moved
+ * @param from Receives the previous states of the instances that moved
+ * @return Number of instances that moved
+ */
+size_t stepScalar(StateId* states, size_t count, const StateId* row, size_t base, uint32_t* changed, StateId* from) {
+  // Branch-free: every instance is recorded, the slot is only kept if it moved (moved <= i, so it stays in bounds)
+  size_t moved = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const StateId state = states[i];
+    const StateId next = row[state];
+    states[i] = next;
+    changed[moved] = static_cast<uint32_t>(base + i);
+    from[moved] = state;
+    moved += static_cast<size_t>(next != state);
+  }
+  return moved;
+}
+
+#ifdef FSMCONFIG_AVX2_KERNEL
+/// Lane permutation moving the set lanes of an 8-bit mask to the front, in order
+struct alignas(32) LanePermutation {
+  std::array<uint32_t, 8> lanes;
+};
+
+constexpr std::array<LanePermutation, 256> COMPRESS_LANES = [] {
+  std::array<LanePermutation, 256> table{};
+  for (uint32_t mask = 0; mask < 256; ++mask) {
+    uint32_t next = 0;
+    for (uint32_t lane = 0; lane < 8; ++lane) {
+      if ((mask & (1U << lane)) != 0) {
+        table[mask].lanes[next++] = lane;
+      }
+    }
+  }
+  return table;
+}();
+
+/**
+ * @brief stepScalar() eight instances at a time
+ *
+ * Next states are gathered from the row; the indices and previous states of
+ * the lanes that moved are compressed to the front with a permutation and
+ * stored whole, which stays within the buffers since at most i lanes have
+ * moved before block i.
+ */
+__attribute__((target("avx2"))) size_t stepAvx2(StateId* states, size_t count, const StateId* row, uint32_t* changed,
+                                                StateId* from) {
+  const __m256i lane_offsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  size_t moved = 0;
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto* block = reinterpret_cast<__m256i*>(states + i);
+    const __m256i current = _mm256_loadu_si256(block);
+    const __m256i next = _mm256_i32gather_epi32(reinterpret_cast<const int*>(row), current, sizeof(StateId));
+    const __m256i same = _mm256_cmpeq_epi32(current, next);
+    const auto lanes = static_cast<uint32_t>(~_mm256_movemask_ps(_mm256_castsi256_ps(same))) & 0xFFU;
+    if (lanes == 0) {
+      continue;
+    }
+
+    _mm256_storeu_si256(block, next);
+    const __m256i order = _mm256_load_si256(reinterpret_cast<const __m256i*>(COMPRESS_LANES[lanes].lanes.data()));
+    const __m256i indices = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), lane_offsets);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(changed + moved), _mm256_permutevar8x32_epi32(indices, order));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(from + moved), _mm256_permutevar8x32_epi32(current, order));
+    moved += static_cast<size_t>(std::popcount(lanes));
+  }
+  return moved + stepScalar(states + i, count - i, row, i, changed + moved, from + moved);
+}
+
+bool cpuHasAvx2() {
+  static const bool supported = __builtin_cpu_supports("avx2") != 0;
+  return supported;
+}
+#endif
+
+}  // namespace
+
+class MachineBatch::Impl {
+ public:
+  Impl(std::shared_ptr<const MachineDefinition> batch_definition, size_t count)
+      : definition(std::move(batch_definition)) {
+    if (!definition) {
+      throw StateException("MachineBatch requires a definition");
+    }
+    if (count > std::numeric_limits<uint32_t>::max()) {
+      throw StateException("MachineBatch supports at most 2^32 - 1 instances");
+    }
+    const CompiledConfig& config = definition->getCompiledConfig();
+    const StateId initial = config.initialState();
+    if (initial == INVALID_ID) {
+      throw StateException("MachineBatch requires a definition with an initial state");
+    }
+
+    state_count = config.states().size();
+    event_count = config.eventCount();
+    buildTables(config);
+
+    states.assign(count, initial);
+    resizeBuffers();
+    guards.resize(config.transitions().size());
+    on_enter.resize(state_count);
+    on_exit.resize(state_count);
+  }
+
+  /**
+   * @brief Fill the (event, state) tables from the first declared transition of each pair
+   */
+  void buildTables(const CompiledConfig& config) {
+    next_state.resize(event_count * state_count);
+    transition_index.assign(event_count * state_count, INVALID_ID);
+    event_guarded.assign(event_count, false);
+
+    const CompiledTransition* first = config.transitions().data();
+    for (EventId event = 0; event < event_count; ++event) {
+      for (StateId state = 0; state < state_count; ++state) {
+        const size_t cell = (event * state_count) + state;
+        const CompiledTransition* transition = config.findTransition(state, event);
+        next_state[cell] = state;
+        if (transition == nullptr) {
+          continue;
+        }
+        transition_index[cell] = static_cast<uint32_t>(transition - first);
+        if (transition->guard != INVALID_ID) {
+          event_guarded[event] = true;
+        } else {
+          next_state[cell] = transition->to;
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Size the changed-instance buffers to the instance count
+   */
+  void resizeBuffers() {
+    changed.resize(states.size());
+    changed_from.resize(states.size());
+    changed_count = 0;
+  }
+
+  StateId stateOf(std::string_view state_name) const {
+    const StateId state = definition->getCompiledConfig().findState(state_name);
+    if (state == INVALID_ID) {
+      throw StateException("State '" + std::string(state_name) + "' does not exist");
+    }
+    return state;
+  }
+
+  void checkInstance(size_t instance) const {
+    if (instance >= states.size()) {
+      throw StateException("Instance " + std::to_string(instance) + " is out of range (batch has " +
+                           std::to_string(states.size()) + " instances)");
+    }
+  }
+
+  /**
+   * @brief Move every instance through the table row of an event without guards
+   */
+  void stepTable(EventId event) {
+    const StateId* row = next_state.data() + (event * state_count);
+#ifdef FSMCONFIG_AVX2_KERNEL
+    if (cpuHasAvx2()) {
+      changed_count = stepAvx2(states.data(), states.size(), row, changed.data(), changed_from.data());
+      return;
+    }
+#endif
+    changed_count = stepScalar(states.data(), states.size(), row, 0, changed.data(), changed_from.data());
+  }
+
+  /**
+   * @brief Move every instance one at a time, evaluating guards of guarded transitions
+   */
+  void stepGuarded(EventId event) {
+    const uint32_t* row = transition_index.data() + (event * state_count);
+    const std::span<const CompiledTransition> transitions = definition->getCompiledConfig().transitions();
+    size_t moved = 0;
+    for (size_t i = 0; i < states.size(); ++i) {
+      const StateId state = states[i];
+      const uint32_t index = row[state];
+      if (index == INVALID_ID || transitions[index].to == state) {
+        continue;
+      }
+      if (transitions[index].guard != INVALID_ID) {
+        const BatchGuardCallback& guard = guards[index];
+        if (!guard || !guard(static_cast<uint32_t>(i))) {
+          continue;
+        }
+      }
+      states[i] = transitions[index].to;
+      changed[moved] = static_cast<uint32_t>(i);
+      changed_from[moved] = state;
+      ++moved;
+    }
+    changed_count = moved;
+  }
+
+  /**
+   * @brief Group the changed instances by state and call the callback of each state once
+   * @param callbacks Callbacks indexed by state
+   * @param key_of State of the k-th changed instance
+   */
+  template <typename KeyOf>
+  void notify(const std::vector<BatchStateCallback>& callbacks, KeyOf key_of) {
+    // Counting sort keeps instances ascending within each state
+    group_offsets.assign(state_count + 1, 0);
+    for (size_t k = 0; k < changed_count; ++k) {
+      ++group_offsets[key_of(k) + 1];
+    }
+    for (size_t state = 0; state < state_count; ++state) {
+      group_offsets[state + 1] += group_offsets[state];
+    }
+    group_cursors.assign(group_offsets.begin(), group_offsets.end() - 1);
+    grouped.resize(changed_count);
+    for (size_t k = 0; k < changed_count; ++k) {
+      grouped[group_cursors[key_of(k)]++] = changed[k];
+    }
+
+    for (StateId state = 0; state < state_count; ++state) {
+      const uint32_t begin = group_offsets[state];
+      const uint32_t end = group_offsets[state + 1];
+      if (callbacks[state] && begin != end) {
+        callbacks[state](std::span<const uint32_t>(grouped.data() + begin, end - begin));
+      }
+    }
+  }
+
+  std::shared_ptr<const MachineDefinition> definition;
+  size_t state_count = 0;
+  size_t event_count = 0;
+
+  // Tables indexed by event * state_count + state
+  std::vector<StateId> next_state;         ///< Target of the unguarded transition, else the state itself
+  std::vector<uint32_t> transition_index;  ///< Index into transitions() or INVALID_ID
+  std::vector<bool> event_guarded;         ///< Event has a guarded transition (scalar pass)
+
+  std::vector<StateId> states;
+
+  // Instances moved by the last event
+  std::vector<uint32_t> changed;
+  std::vector<StateId> changed_from;
+  size_t changed_count = 0;
+
+  // Callbacks
+  std::vector<BatchGuardCallback> guards;  ///< Indexed by transition
+  std::vector<BatchStateCallback> on_enter;
+  std::vector<BatchStateCallback> on_exit;
+  bool has_on_enter = false;
+  bool has_on_exit = false;
+  bool dispatching = false;
+
+  // Scratch of notify()
+  std::vector<uint32_t> group_offsets;
+  std::vector<uint32_t> group_cursors;
+  std::vector<uint32_t> grouped;
+};
+
+MachineBatch::MachineBatch(std::shared_ptr<const MachineDefinition> definition, size_t count)
+    : impl_(std::make_unique<Impl>(std::move(definition), count)) {}
+
+MachineBatch::~MachineBatch() = default;
+
+MachineBatch::MachineBatch(MachineBatch&& other) noexcept = default;
+
+MachineBatch& MachineBatch::operator=(MachineBatch&& other) noexcept = default;
+
+size_t MachineBatch::size() const { return impl_->states.size(); }
+
+std::shared_ptr<const MachineDefinition> MachineBatch::getDefinition() const { return impl_->definition; }
+
+std::span<const StateId> MachineBatch::states() const { return impl_->states; }
+
+std::string_view MachineBatch::getState(size_t instance) const {
+  impl_->checkInstance(instance);
+  return impl_->definition->getCompiledConfig().stateName(impl_->states[instance]);
+}
+
+void MachineBatch::setState(size_t instance, std::string_view state_name) {
+  impl_->checkInstance(instance);
+  impl_->states[instance] = impl_->stateOf(state_name);
+}
+
+size_t MachineBatch::triggerEvent(std::string_view event_name) {
+  return triggerEvent(impl_->definition->getCompiledConfig().findEvent(event_name));
+}
+
+size_t MachineBatch::triggerEvent(EventId event) {
+  if (impl_->dispatching) {
+    throw StateException("MachineBatch::triggerEvent() called from a callback of the same batch");
+  }
+  impl_->changed_count = 0;
+  if (event >= impl_->event_count) {
+    return 0;
+  }
+
+  struct DispatchScope {
+    Impl& impl;
+    ~DispatchScope() { impl.dispatching = false; }
+  } const scope{*impl_};
+  impl_->dispatching = true;
+
+  if (impl_->event_guarded[event]) {
+    impl_->stepGuarded(event);
+  } else {
+    impl_->stepTable(event);
+  }
+
+  if (impl_->changed_count != 0) {
+    if (impl_->has_on_exit) {
+      impl_->notify(impl_->on_exit, [this](size_t k) { return impl_->changed_from[k]; });
+    }
+    if (impl_->has_on_enter) {
+      impl_->notify(impl_->on_enter, [this](size_t k) { return impl_->states[impl_->changed[k]]; });
+    }
+  }
+  return impl_->changed_count;
+}
+
+std::span<const uint32_t> MachineBatch::getChangedInstances() const {
+  return {impl_->changed.data(), impl_->changed_count};
+}
+
+bool MachineBatch::isVectorized() {
+#ifdef FSMCONFIG_AVX2_KERNEL
+  return cpuHasAvx2();
+#else
+  return false;
+#endif
+}
+
+std::string MachineBatch::snapshot() const {
+  detail::BinaryWriter writer;
+  writer.reserve(20 + (impl_->states.size() * sizeof(StateId)));
+  writer.u32(BATCH_SNAPSHOT_MAGIC);
+  writer.u32(BATCH_SNAPSHOT_FORMAT);
+  writer.u64(impl_->definition->getLayoutHash());
+  writer.u32(static_cast<uint32_t>(impl_->states.size()));
+  writer.u32s(impl_->states);
+  return writer.take();
+}
+
+void MachineBatch::restore(std::string_view snapshot) {
+  if (impl_->dispatching) {
+    throw StateException("MachineBatch::restore() called from a callback of the same batch");
+  }
+
+  std::vector<StateId> restored;
+  try {
+    detail::BinaryReader reader(snapshot);
+    if (reader.u32() != BATCH_SNAPSHOT_MAGIC) {
+      throw StateException("Data is not a MachineBatch snapshot");
+    }
+    if (const uint32_t format = reader.u32(); format != BATCH_SNAPSHOT_FORMAT) {
+      throw StateException("Unsupported snapshot format " + std::to_string(format));
+    }
+    if (reader.u64() != impl_->definition->getLayoutHash()) {
+      throw StateException("Snapshot was taken with a definition that has other states");
+    }
+    restored.resize(reader.count(sizeof(StateId)));
+    reader.u32s(restored);
+    if (!reader.atEnd()) {
+      throw StateException("Snapshot has trailing data");
+    }
+  } catch (const ConfigException&) {
+    throw StateException("Snapshot is truncated");
+  }
+
+  // Branch-free scan, so the check vectorizes
+  StateId invalid = 0;
+  for (const StateId state : restored) {
+    invalid |= static_cast<StateId>(state >= impl_->state_count);
+  }
+  if (invalid != 0) {
+    throw StateException("Snapshot holds an invalid state");
+  }
+
+  impl_->states = std::move(restored);
+  impl_->resizeBuffers();
+}
+
+void MachineBatch::registerStateCallback(const std::string& state_name, const std::string& callback_type,
+                                         BatchStateCallback callback) {
+  const StateId state = impl_->stateOf(state_name);
+  if (callback_type == "on_enter") {
+    impl_->on_enter[state] = std::move(callback);
+    impl_->has_on_enter = true;
+  } else if (callback_type == "on_exit") {
+    impl_->on_exit[state] = std::move(callback);
+    impl_->has_on_exit = true;
+  } else {
+    throw StateException("Unknown state callback type '" + callback_type + "'");
+  }
+}
+
+void MachineBatch::registerGuard(const std::string& from_state, const std::string& to_state,
+                                 const std::string& event_name, BatchGuardCallback callback) {
+  const CompiledConfig& config = impl_->definition->getCompiledConfig();
+  const StateId from = impl_->stateOf(from_state);
+  const StateId to = impl_->stateOf(to_state);
+  const EventId event = config.findEvent(event_name);
+  const CompiledTransition* transition = event == INVALID_ID ? nullptr : config.findTransition(from, event);
+  if (transition == nullptr || transition->to != to) {
+    throw StateException("No transition from '" + from_state + "' to '" + to_state + "' on '" + event_name + "'");
+  }
+  impl_->guards[static_cast<size_t>(transition - config.transitions().data())] = std::move(callback);
+}
+
+}  // namespace fsmconfig
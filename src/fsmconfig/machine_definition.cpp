@@ -0,0 +1,104 @@
+#include "fsmconfig/machine_definition.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "content_hash.hpp"
+#include "fsmconfig/compiled_config.hpp"
+#include "fsmconfig/config_parser.hpp"
+#include "fsmconfig/state.hpp"
+
+namespace fsmconfig {
+
+/**
+ * @brief MachineDefinition implementation (Pimpl idiom)
+ */
+class MachineDefinition::Impl {
+ public:
+  explicit Impl(ConfigParser config_parser)
+      : parser(std::move(config_parser)), initial_state(parser.getInitialState()) {
+    // Names are NUL-terminated so that {"ab", "c"} and {"a", "bc"} differ
+    const CompiledConfig& config = parser.getCompiledConfig();
+    for (const auto& state : config.states()) {
+      layout_hash = detail::contentHash(config.str(state.name), layout_hash);
+      layout_hash = detail::contentHash(std::string_view("", 1), layout_hash);
+    }
+  }
+
+  /// Parsed configuration, the only copy of the state records
+  ConfigParser parser;
+
+  /// Initial state (empty if configuration has no states)
+  std::string initial_state;
+
+  /// Hash of the state names in StateId order
+  uint64_t layout_hash = detail::contentHash({});
+};
+
+// ============================================================================
+// Factory methods
+// ============================================================================
+
+std::shared_ptr<const MachineDefinition> MachineDefinition::fromFile(const std::string& config_path) {
+  ConfigParser parser;
+  parser.loadFromFile(config_path);
+  return std::make_shared<const MachineDefinition>(std::move(parser));
+}
+
+std::shared_ptr<const MachineDefinition> MachineDefinition::fromString(const std::string& yaml_content) {
+  ConfigParser parser;
+  parser.loadFromString(yaml_content);
+  return std::make_shared<const MachineDefinition>(std::move(parser));
+}
+
+// ============================================================================
+// Constructors and destructor
+// ============================================================================
+
+MachineDefinition::MachineDefinition(ConfigParser parser) : impl_(std::make_unique<Impl>(std::move(parser))) {}
+
+MachineDefinition::~MachineDefinition() = default;
+
+// ============================================================================
+// Data access methods
+// ============================================================================
+
+const ConfigParser& MachineDefinition::getConfig() const { return impl_->parser; }
+
+const CompiledConfig& MachineDefinition::getCompiledConfig() const { return impl_->parser.getCompiledConfig(); }
+
+bool MachineDefinition::hasState(const std::string& state_name) const {
+  return getCompiledConfig().findState(state_name) != INVALID_ID;
+}
+
+std::optional<StateView> MachineDefinition::findState(const std::string& state_name) const {
+  const CompiledConfig& config = getCompiledConfig();
+  const StateId id = config.findState(state_name);
+  if (id == INVALID_ID) {
+    return std::nullopt;
+  }
+  return StateView(config, id);
+}
+
+std::vector<std::string> MachineDefinition::getStateNames() const {
+  const CompiledConfig& config = getCompiledConfig();
+  std::vector<std::string> result;
+  result.reserve(config.states().size());
+  for (const auto& state : config.states()) {
+    result.emplace_back(config.str(state.name));
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+const std::string& MachineDefinition::getInitialState() const { return impl_->initial_state; }
+
+uint64_t MachineDefinition::getLayoutHash() const { return impl_->layout_hash; }
+
+}  // namespace fsmconfig
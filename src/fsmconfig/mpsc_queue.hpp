@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace fsmconfig::detail {
+
+/**
+ * @file mpsc_queue.hpp
+ * @brief Lock-free multi-producer single-consumer queue (library internal)
+ */
+
+/**
+ * @brief Intrusive multi-producer single-consumer queue
+ *
+ * Vyukov's algorithm: push() is one atomic exchange and never waits, pop()
+ * and empty() must only be called by the single consumer. While a producer
+ * is between its exchange and linking its node, pop() returns nothing even
+ * though empty() is false; the consumer retries later.
+ *
+ * @tparam T Value type (default constructible)
+ */
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() = default;
+
+  ~MpscQueue() {
+    while (pop()) {
+    }
+  }
+
+  // Copy and move prohibition (nodes point into the queue)
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+  MpscQueue(MpscQueue&&) = delete;
+  MpscQueue& operator=(MpscQueue&&) = delete;
+
+  /**
+   * @brief Append value (any thread)
+   * @param value Value to append
+   */
+  void push(T value) {
+    auto* node = new Node;
+    node->value = std::move(value);
+    pushNode(node);
+  }
+
+  /**
+   * @brief Take the oldest value (consumer only)
+   * @return Value or std::nullopt if nothing is ready
+   */
+  std::optional<T> pop() {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return std::nullopt;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next == nullptr) {
+      if (tail != head_.load(std::memory_order_acquire)) {
+        // A producer has taken its place but not linked it yet
+        return std::nullopt;
+      }
+      // tail is the last node: re-insert the stub behind it so it can be unlinked
+      pushNode(&stub_);
+      next = tail->next.load(std::memory_order_acquire);
+      if (next == nullptr) {
+        return std::nullopt;
+      }
+    }
+
+    tail_ = next;
+    std::optional<T> value(std::move(tail->value));
+    delete tail;
+    return value;
+  }
+
+  /**
+   * @brief Check if no value is queued or being pushed (consumer only)
+   */
+  [[nodiscard]] bool empty() const { return tail_ == &stub_ && head_.load() == &stub_; }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    T value{};
+  };
+
+  void pushNode(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  Node stub_;
+  std::atomic<Node*> head_{&stub_};  ///< Last pushed node (producers)
+  Node* tail_ = &stub_;              ///< Oldest node (consumer)
+};
+
+}  // namespace fsmconfig::detail
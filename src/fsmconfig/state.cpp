@@ -1,8 +1,11 @@
 #include "fsmconfig/state.hpp"
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -71,4 +74,58 @@ void State::setVariable(const std::string& name, const VariableValue& value) { i
 
 const std::map<std::string, VariableValue>& State::getAllVariables() const { return impl_->variables; }
 
+// ============================================================================
+// StateView implementation
+// ============================================================================
+
+StateView::StateView(const CompiledConfig& config, StateId id) noexcept : config_(&config), id_(id) {}
+
+StateId StateView::getId() const noexcept { return id_; }
+
+const CompiledState& StateView::record() const { return config_->states()[id_]; }
+
+std::string_view StateView::getName() const { return config_->str(record().name); }
+
+std::string_view StateView::getOnEnterCallback() const { return config_->str(record().on_enter); }
+
+std::string_view StateView::getOnExitCallback() const { return config_->str(record().on_exit); }
+
+std::span<const StringId> StateView::getActions() const { return record().actions; }
+
+std::span<const CompiledVariable> StateView::getVariables() const { return record().variables; }
+
+const CompiledVariable* StateView::findVariable(std::string_view name) const {
+  const auto variables = record().variables;
+  auto it = std::lower_bound(
+      variables.begin(), variables.end(), name,
+      [this](const CompiledVariable& variable, std::string_view key) { return config_->str(variable.name) < key; });
+  return it != variables.end() && config_->str(it->name) == name ? &*it : nullptr;
+}
+
+bool StateView::hasVariable(std::string_view name) const { return findVariable(name) != nullptr; }
+
+VariableValue StateView::getVariable(std::string_view name) const {
+  const CompiledVariable* variable = findVariable(name);
+  if (!variable) {
+    throw StateException("Variable '" + std::string(name) + "' not found in state '" + std::string(getName()) + "'");
+  }
+  return config_->value(*variable);
+}
+
+StateInfo StateView::toStateInfo() const {
+  StateInfo info{std::string(getName())};
+  for (const auto& variable : getVariables()) {
+    info.variables.emplace(config_->str(variable.name), config_->value(variable));
+  }
+  info.on_enter_callback = getOnEnterCallback();
+  info.on_exit_callback = getOnExitCallback();
+  info.actions.reserve(getActions().size());
+  for (const StringId action : getActions()) {
+    info.actions.emplace_back(config_->str(action));
+  }
+  return info;
+}
+
+const CompiledConfig& StateView::getConfig() const noexcept { return *config_; }
+
 }  // namespace fsmconfig
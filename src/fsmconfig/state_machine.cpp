@@ -1,123 +1,674 @@
 #include "fsmconfig/state_machine.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <map>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "fsmconfig/callback_registry.hpp"
-#include "fsmconfig/config_parser.hpp"
+#include "fsmconfig/compiled_config.hpp"
 #include "fsmconfig/event_dispatcher.hpp"
-#include "fsmconfig/state.hpp"
+#include "fsmconfig/machine_definition.hpp"
+#include "fsmconfig/timer_service.hpp"
+#include "fsmconfig/tracer.hpp"
 #include "fsmconfig/variable_manager.hpp"
+#include "binary_io.hpp"
+#include "mpsc_queue.hpp"
 
 namespace fsmconfig {
 
+namespace {
+
+/// Data of batch events given without any
+const std::map<std::string, VariableValue> NO_EVENT_DATA;
+
+/// Snapshot signature
+constexpr uint32_t SNAPSHOT_MAGIC = 0x534D5346;  // "FSMS"
+
+/// Layout version; bump when the encoding below changes
+constexpr uint32_t SNAPSHOT_FORMAT = 1;
+
+void writeVariables(detail::BinaryWriter& writer, const std::map<std::string, VariableValue>& variables) {
+  writer.u32(static_cast<uint32_t>(variables.size()));
+  for (const auto& [name, value] : variables) {
+    writer.str(name);
+    writer.u8(static_cast<uint8_t>(value.type));
+    switch (value.type) {
+      case VariableType::INT:
+        writer.i32(value.int_value);
+        break;
+      case VariableType::FLOAT:
+        writer.f32(value.float_value);
+        break;
+      case VariableType::BOOL:
+        writer.u8(value.bool_value ? 1 : 0);
+        break;
+      case VariableType::STRING:
+        writer.str(value.string_value);
+        break;
+    }
+  }
+}
+
+VariableValue readValue(detail::BinaryReader& reader) {
+  switch (static_cast<VariableType>(reader.u8())) {
+    case VariableType::INT:
+      return VariableValue(reader.i32());
+    case VariableType::FLOAT:
+      return VariableValue(reader.f32());
+    case VariableType::BOOL:
+      return VariableValue(reader.u8() != 0);
+    case VariableType::STRING:
+      return VariableValue(std::string(reader.str()));
+  }
+  throw StateException("Snapshot contains unknown variable type");
+}
+
+}  // namespace
+
 /**
  * @brief StateMachine implementation (Pimpl idiom)
  */
 struct StateMachine::Impl {
-  std::unique_ptr<ConfigParser> config_parser;
+  /// Owning machine; timer callbacks re-enter through it (updated when the machine is moved)
+  StateMachine* self;
+
+  /// Current definition; replaced atomically by reload() while events keep flowing
+  std::atomic<std::shared_ptr<const MachineDefinition>> definition;
+
+  /// Definition published from another thread, adopted at the next event boundary
+  std::atomic<std::shared_ptr<const MachineDefinition>> pending_definition;
+  std::atomic<bool> has_pending_definition{false};
+
   std::unique_ptr<CallbackRegistry> callback_registry;
   std::unique_ptr<VariableManager> variable_manager;
   std::unique_ptr<EventDispatcher> event_dispatcher;
 
-  std::map<std::string, std::unique_ptr<State>> states;
   std::string current_state;
-  std::string initial_state;
   bool started = false;
 
+  /// Bumped whenever current_state, started or the definition changes (lets triggerEvents() skip re-resolving)
+  uint64_t state_version = 0;
+
   std::vector<std::weak_ptr<StateObserver>> observers;
   ErrorHandler error_handler;
 
-  void clear() {
-    current_state.clear();
-    initial_state.clear();
-    started = false;
+  /**
+   * @brief Callbacks of one definition resolved against the registry
+   *
+   * Callbacks are indexed by StateId and transition index, so events call
+   * through plain pointers instead of building string keys. The action lists
+   * of all states and then all transitions are stored back to back; offsets
+   * index them. Unbound callbacks are null or left out of the action lists.
+   */
+  struct CallbackTable {
+    std::shared_ptr<const MachineDefinition> definition;
+    uint64_t generation = 0;
+    std::vector<std::shared_ptr<const void>> owned;        ///< Keeps callbacks alive across re-registration
+    std::vector<const StateCallback*> on_enter;            ///< Per state
+    std::vector<const StateCallback*> on_exit;             ///< Per state
+    std::vector<const GuardCallback*> guards;              ///< Per transition declaring a guard
+    std::vector<const TransitionCallback*> on_transition;  ///< Per transition declaring on_transition
+    std::vector<const ActionCallback*> calls;
+    std::vector<uint32_t> state_offsets;       ///< states + 1 entries
+    std::vector<uint32_t> transition_offsets;  ///< transitions + 1 entries
+    std::vector<std::string> unbound_actions;  ///< Sorted names of unregistered actions
+    std::vector<std::string> unbound;          ///< Every configured callback that is not registered
+  };
+
+  /// Resolved callbacks; shared so a callback that re-enters the machine cannot free the running table
+  std::shared_ptr<const CallbackTable> callbacks;
+
+  /// Sorted names of unbound actions as of the last reported bindCallbacks()
+  std::vector<std::string> reported_actions;
+
+  /// Set by seal(): registrations are frozen and every configured callback is bound
+  bool sealed = false;
+
+  /// Event posted to the strand by a thread that found the machine busy
+  struct StrandEvent {
+    std::string name;
+    std::map<std::string, VariableValue> data;
+    uint64_t timer_epoch = 0;             ///< Timeouts: epoch the timer was armed in
+    EventId timeout_event = INVALID_ID;   ///< Timeouts: event of the 'after' transition
+    StateAwaitable* state_waiter = nullptr;  ///< untilState(): waiter to register instead of an event
+    EventAwaitable* event_waiter = nullptr;  ///< postEvent(): coroutine to resume after the event
+  };
+
+  bool strand = false;
+  detail::MpscQueue<StrandEvent> strand_mailbox;
+
+  /// Strand events not processed yet; the thread raising it from zero drains the strand
+  std::atomic<size_t> strand_pending{0};
+
+  TimerService* timers = nullptr;
+
+  /// Timers of the current state's 'after' transitions
+  std::vector<TimerId> state_timers;
+
+  /// Bumped whenever the armed timers are cancelled; expiries of older epochs are dropped
+  uint64_t timer_epoch = 0;
+
+  /// Coroutines suspended in untilState(), touched only by the thread processing events
+  std::vector<StateAwaitable*> state_waiters;
+
+  /// Set while triggerEvents() runs: observers were pruned for the whole batch
+  bool observers_pruned = false;
+
+  Impl(StateMachine* owner, std::shared_ptr<const MachineDefinition> initial_definition)
+      : self(owner),
+        definition(std::move(initial_definition)),
+        callback_registry(std::make_unique<CallbackRegistry>()),
+        variable_manager(std::make_unique<VariableManager>()),
+        event_dispatcher(std::make_unique<EventDispatcher>()) {
+    seedVariables(*definition.load());
   }
-};
 
-// Constructors and destructor
+  ~Impl() { cancelTimers(); }
+
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+  Impl(Impl&&) = delete;
+  Impl& operator=(Impl&&) = delete;
+
+  /**
+   * @brief Copy configured variables into VariableManager
+   *
+   * Variables that already have a value are kept, so values set at runtime
+   * survive a configuration reload.
+   */
+  void seedVariables(const MachineDefinition& def) const {
+    const CompiledConfig& config = def.getCompiledConfig();
+    for (const auto& variable : config.globalVariables()) {
+      const std::string name(config.str(variable.name));
+      if (!variable_manager->hasGlobalVariable(name)) {
+        variable_manager->setGlobalVariable(name, config.value(variable));
+      }
+    }
+    for (const auto& state : config.states()) {
+      if (state.variables.empty()) {
+        continue;
+      }
+      const std::string state_name(config.str(state.name));
+      for (const auto& variable : state.variables) {
+        const std::string var_name(config.str(variable.name));
+        if (!variable_manager->hasStateVariable(state_name, var_name)) {
+          variable_manager->setStateVariable(state_name, var_name, config.value(variable));
+        }
+      }
+    }
+  }
 
-StateMachine::StateMachine(const std::string& config_path) : impl_(std::make_unique<Impl>()) {
-  impl_->config_parser = std::make_unique<ConfigParser>();
-  impl_->callback_registry = std::make_unique<CallbackRegistry>();
-  impl_->variable_manager = std::make_unique<VariableManager>();
-  impl_->event_dispatcher = std::make_unique<EventDispatcher>();
+  /**
+   * @brief Adopt a definition published by scheduleDefinition()
+   *
+   * Runs on the thread driving the machine. A definition without the current
+   * state, or with unregistered callbacks once sealed, is dropped and reported
+   * through the error handler instead of failing the event that picked it up.
+   */
+  void adoptPendingDefinition() {
+    if (!has_pending_definition.load(std::memory_order_acquire)) {
+      return;
+    }
+    has_pending_definition.store(false, std::memory_order_relaxed);
+    auto pending = pending_definition.exchange(nullptr);
+    if (!pending) {
+      return;
+    }
 
-  // Load configuration from file
-  impl_->config_parser->loadFromFile(config_path);
+    std::string error;
+    if (started && !pending->hasState(current_state)) {
+      error = "Reloaded configuration has no state '" + current_state + "'";
+    } else {
+      error = checkSealed(pending);
+    }
+    if (!error.empty()) {
+      if (error_handler) {
+        error_handler(error);
+      }
+      return;
+    }
 
-  // Copy global variables to VariableManager
-  const auto& global_vars = impl_->config_parser->getGlobalVariables();
-  for (const auto& [name, value] : global_vars) {
-    impl_->variable_manager->setGlobalVariable(name, value);
+    seedVariables(*pending);
+    definition.store(std::move(pending));
+    ++state_version;
+    if (started) {
+      restartTimers();
+    }
   }
 
-  // Create states from configuration
-  const auto& states_info = impl_->config_parser->getStates();
-  for (const auto& [name, info] : states_info) {
-    auto state = std::make_unique<State>(info);
+  /**
+   * @brief Keep callback alive in table
+   * @return Raw callback pointer (nullptr if callback is null)
+   */
+  template <typename Callback>
+  static const Callback* keep(CallbackTable& table, std::shared_ptr<const Callback> callback) {
+    const Callback* raw = callback.get();
+    if (raw != nullptr) {
+      table.owned.push_back(std::move(callback));
+    }
+    return raw;
+  }
 
-    // Copy state variables to VariableManager
-    for (const auto& [var_name, var_value] : info.variables) {
-      impl_->variable_manager->setStateVariable(name, var_name, var_value);
+  /**
+   * @brief Resolve every callback def refers to against the registry
+   *
+   * on_enter and on_exit callbacks are resolved for every state, like start()
+   * and stop() always did, and reported unbound only where the configuration
+   * declares them; the other callbacks are resolved only where declared.
+   */
+  std::shared_ptr<CallbackTable> resolveCallbacks(const std::shared_ptr<const MachineDefinition>& def) const {
+    const CompiledConfig& config = def->getCompiledConfig();
+    auto table = std::make_shared<CallbackTable>();
+    table->definition = def;
+    table->generation = callback_registry->getGeneration();
+
+    table->on_enter.reserve(config.states().size());
+    table->on_exit.reserve(config.states().size());
+    for (const auto& state : config.states()) {
+      const std::string name(config.str(state.name));
+      table->on_enter.push_back(keep(*table, callback_registry->resolveStateCallback(name, "on_enter")));
+      if (state.on_enter != INVALID_ID && table->on_enter.back() == nullptr) {
+        table->unbound.push_back("on_enter callback '" + std::string(config.str(state.on_enter)) + "' of state '" +
+                                 name + "' is not registered");
+      }
+
+      table->on_exit.push_back(keep(*table, callback_registry->resolveStateCallback(name, "on_exit")));
+      if (state.on_exit != INVALID_ID && table->on_exit.back() == nullptr) {
+        table->unbound.push_back("on_exit callback '" + std::string(config.str(state.on_exit)) + "' of state '" +
+                                 name + "' is not registered");
+      }
     }
 
-    impl_->states[name] = std::move(state);
+    table->guards.reserve(config.transitions().size());
+    table->on_transition.reserve(config.transitions().size());
+    for (const auto& transition : config.transitions()) {
+      const std::string from(config.stateName(transition.from));
+      const std::string to(config.stateName(transition.to));
+      const std::string description = "of transition '" + from + "' -> '" + to + "'";
+
+      const GuardCallback* guard = nullptr;
+      if (transition.guard != INVALID_ID) {
+        const std::string event(config.eventName(transition.event));
+        guard = keep(*table, callback_registry->resolveGuard(from, to, event));
+        if (guard == nullptr) {
+          table->unbound.push_back("Guard '" + std::string(config.str(transition.guard)) + "' " + description +
+                                   " on '" + event + "' is not registered");
+        }
+      }
+      table->guards.push_back(guard);
+
+      const TransitionCallback* on_transition = nullptr;
+      if (transition.on_transition != INVALID_ID) {
+        on_transition = keep(*table, callback_registry->resolveTransitionCallback(from, to));
+        if (on_transition == nullptr) {
+          table->unbound.push_back("on_transition callback '" + std::string(config.str(transition.on_transition)) +
+                                   "' " + description + " is not registered");
+        }
+      }
+      table->on_transition.push_back(on_transition);
+    }
+
+    // Each distinct action name is looked up once
+    std::vector<const ActionCallback*> resolved(config.stringCount());
+    std::vector<bool> looked_up(config.stringCount());
+    const auto append = [&](std::span<const StringId> names) {
+      for (const StringId name : names) {
+        if (!looked_up[name]) {
+          looked_up[name] = true;
+          resolved[name] = keep(*table, callback_registry->resolveAction(std::string(config.str(name))));
+          if (resolved[name] == nullptr) {
+            table->unbound_actions.emplace_back(config.str(name));
+          }
+        }
+        if (resolved[name] != nullptr) {
+          table->calls.push_back(resolved[name]);
+        }
+      }
+    };
+
+    table->state_offsets.reserve(config.states().size() + 1);
+    table->state_offsets.push_back(0);
+    for (const auto& state : config.states()) {
+      append(state.actions);
+      table->state_offsets.push_back(static_cast<uint32_t>(table->calls.size()));
+    }
+    table->transition_offsets.reserve(config.transitions().size() + 1);
+    table->transition_offsets.push_back(static_cast<uint32_t>(table->calls.size()));
+    for (const auto& transition : config.transitions()) {
+      append(transition.actions);
+      table->transition_offsets.push_back(static_cast<uint32_t>(table->calls.size()));
+    }
+
+    std::sort(table->unbound_actions.begin(), table->unbound_actions.end());
+    for (const auto& name : table->unbound_actions) {
+      table->unbound.push_back("Action '" + name + "' is not registered");
+    }
+    return table;
   }
 
-  // Find initial state from configuration
-  const std::string initial_state = impl_->config_parser->getInitialState();
-  impl_->initial_state = initial_state;  // Save even if empty
-}
+  /**
+   * @brief Combine unbound callback messages into one error
+   * @return Error message, empty if every callback is bound
+   */
+  static std::string describeUnbound(const std::vector<std::string>& unbound) {
+    if (unbound.size() == 1) {
+      return unbound.front();
+    }
+    std::string error;
+    if (!unbound.empty()) {
+      error = std::to_string(unbound.size()) + " unbound callbacks";
+      for (const auto& message : unbound) {
+        error += "; " + message;
+      }
+    }
+    return error;
+  }
 
-StateMachine::StateMachine(const std::string& yaml_content, bool is_content) : impl_(std::make_unique<Impl>()) {
-  if (!is_content) {
-    throw ConfigException("Second constructor argument must be true when passing YAML content");
+  /**
+   * @brief Check that def can replace the definition of a sealed machine
+   * @return Error message, empty if def may be used
+   */
+  [[nodiscard]] std::string checkSealed(const std::shared_ptr<const MachineDefinition>& def) const {
+    return sealed ? describeUnbound(resolveCallbacks(def)->unbound) : std::string();
   }
 
-  impl_->config_parser = std::make_unique<ConfigParser>();
-  impl_->callback_registry = std::make_unique<CallbackRegistry>();
-  impl_->variable_manager = std::make_unique<VariableManager>();
-  impl_->event_dispatcher = std::make_unique<EventDispatcher>();
+  /**
+   * @brief Make callbacks match def and the current registrations
+   *
+   * Rebuilds only when the definition changed or, unless sealed, the registry
+   * generation moved. Actions that became unbound are reported through the
+   * error handler once, by the first binding that reports.
+   *
+   * @param report false to leave reporting to the next binding that runs actions
+   */
+  void bindCallbacks(const std::shared_ptr<const MachineDefinition>& def, bool report = true) {
+    if (!callbacks || callbacks->definition != def ||
+        (!sealed && callbacks->generation != callback_registry->getGeneration())) {
+      callbacks = resolveCallbacks(def);
+    }
+    if (!report || reported_actions == callbacks->unbound_actions) {
+      return;
+    }
 
-  // Load configuration from string
-  impl_->config_parser->loadFromString(yaml_content);
+    if (error_handler) {
+      for (const auto& name : callbacks->unbound_actions) {
+        if (!std::binary_search(reported_actions.begin(), reported_actions.end(), name)) {
+          error_handler("Action '" + name + "' is not registered");
+        }
+      }
+    }
+    reported_actions = callbacks->unbound_actions;
+  }
 
-  // Copy global variables to VariableManager
-  const auto& global_vars = impl_->config_parser->getGlobalVariables();
-  for (const auto& [name, value] : global_vars) {
-    impl_->variable_manager->setGlobalVariable(name, value);
+  /**
+   * @brief Run one action list
+   * @param config Definition snapshot of the current event
+   * @param names Action names of the list (used if config is not the bound definition)
+   * @param offsets CallbackTable::state_offsets or CallbackTable::transition_offsets
+   * @param index State identifier or transition index
+   */
+  void runActions(const CompiledConfig& config, std::span<const StringId> names,
+                  std::vector<uint32_t> CallbackTable::*offsets, size_t index) const {
+    const auto table = callbacks;
+    if (table && &table->definition->getCompiledConfig() == &config) {
+      const auto& range = (*table).*offsets;
+      for (uint32_t i = range[index]; i < range[index + 1]; ++i) {
+        (*table->calls[i])();
+      }
+      return;
+    }
+
+    // An action replaced the definition mid-event: resolve the rest by name
+    for (const StringId name : names) {
+      callback_registry->callAction(std::string(config.str(name)));
+    }
   }
 
-  // Create states from configuration
-  const auto& states_info = impl_->config_parser->getStates();
-  for (const auto& [name, info] : states_info) {
-    auto state = std::make_unique<State>(info);
+  /**
+   * @brief Throw if callbacks can no longer be registered
+   * @throws StateException if the machine is sealed
+   */
+  void rejectIfSealed() const {
+    if (sealed) {
+      const std::string error = "StateMachine is sealed; callbacks can no longer be registered";
+      if (error_handler) {
+        error_handler(error);
+      }
+      throw StateException(error);
+    }
+  }
+
+  /**
+   * @brief Arm timers of the current state's 'after' transitions in the current definition
+   */
+  void armTimers() {
+    if (timers == nullptr) {
+      return;
+    }
+    const auto def = definition.load();
+    const CompiledConfig& config = def->getCompiledConfig();
+    for (const uint32_t index : config.transitionsFrom(config.findState(current_state))) {
+      const CompiledTransition& transition = config.transitions()[index];
+      if (transition.after_ms == 0) {
+        continue;
+      }
+      const auto delay = std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(transition.after_ms));
+      state_timers.push_back(timers->schedule(
+          delay, [this, epoch = timer_epoch, event = transition.event] { deliverTimeout(epoch, event); }));
+    }
+  }
+
+  /**
+   * @brief Cancel armed timers; expiries already in flight are dropped by the epoch check
+   */
+  void cancelTimers() {
+    ++timer_epoch;
+    if (timers != nullptr) {
+      for (const TimerId id : state_timers) {
+        timers->cancel(id);
+      }
+    }
+    state_timers.clear();
+  }
 
-    // Copy state variables to VariableManager
-    for (const auto& [var_name, var_value] : info.variables) {
-      impl_->variable_manager->setStateVariable(name, var_name, var_value);
+  void restartTimers() {
+    cancelTimers();
+    armTimers();
+  }
+
+  /**
+   * @brief Timer callback: process the timeout like triggerEvent() would
+   */
+  void deliverTimeout(uint64_t epoch, EventId event) {
+    if (!strand) {
+      self->processTimeout(epoch, event);
+      return;
     }
 
-    impl_->states[name] = std::move(state);
+    size_t idle = 0;
+    if (strand_pending.compare_exchange_strong(idle, 1)) {
+      self->processTimeout(epoch, event);
+      if (strand_pending.fetch_sub(1) == 1) {
+        return;
+      }
+    } else {
+      strand_mailbox.push(StrandEvent{{}, {}, epoch, event});
+      if (strand_pending.fetch_add(1) != 0) {
+        return;
+      }
+    }
+    drainStrand();
   }
 
-  // Find initial state from configuration
-  const std::string initial_state = impl_->config_parser->getInitialState();
-  impl_->initial_state = initial_state;  // Save even if empty
+  /**
+   * @brief Process queued strand events; the caller owns the strand until the pending count drops to zero
+   */
+  void drainStrand() {
+    do {
+      auto event = strand_mailbox.pop();
+      while (!event) {
+        // Counted before it is linked into the queue
+        std::this_thread::yield();
+        event = strand_mailbox.pop();
+      }
+      if (event->state_waiter != nullptr) {
+        if (!self->addStateWaiter(*event->state_waiter)) {
+          event->state_waiter->handle_.resume();
+        }
+      } else if (event->timeout_event != INVALID_ID) {
+        self->processTimeout(event->timer_epoch, event->timeout_event);
+      } else {
+        self->processStrandEvent(event->name, event->data);
+        if (EventAwaitable* waiter = event->event_waiter) {
+          waiter->state_ = current_state;
+          waiter->handle_.resume();
+        }
+      }
+    } while (strand_pending.fetch_sub(1) > 1);
+  }
+
+  /**
+   * @brief Remove observers that no longer exist
+   */
+  void pruneObservers() {
+    std::erase_if(observers, [](const std::weak_ptr<StateObserver>& weak_obs) { return weak_obs.expired(); });
+  }
+
+  /**
+   * @brief Append the snapshot record of this machine
+   */
+  void writeSnapshot(detail::BinaryWriter& writer) const {
+    const auto def = definition.load();
+    const CompiledConfig& config = def->getCompiledConfig();
+    writer.u64(def->getLayoutHash());
+    writer.u8(started ? 1 : 0);
+    writer.u32(current_state.empty() ? INVALID_ID : config.findState(current_state));
+    writeVariables(writer, variable_manager->getGlobalVariables());
+
+    std::vector<std::pair<StateId, std::map<std::string, VariableValue>>> scopes;
+    for (StateId state = 0; state < config.states().size(); ++state) {
+      auto variables = variable_manager->getStateVariables(std::string(config.stateName(state)));
+      if (!variables.empty()) {
+        scopes.emplace_back(state, std::move(variables));
+      }
+    }
+    writer.u32(static_cast<uint32_t>(scopes.size()));
+    for (const auto& [state, variables] : scopes) {
+      writer.u32(state);
+      writeVariables(writer, variables);
+    }
+  }
+
+  /**
+   * @brief Read a snapshot record written by writeSnapshot()
+   * @param reader Reader positioned at the record
+   * @param apply Replace state and variables; otherwise the record is only validated
+   * @throws StateException if the record does not fit the current definition
+   */
+  void readSnapshot(detail::BinaryReader& reader, bool apply) {
+    const auto def = definition.load();
+    const CompiledConfig& config = def->getCompiledConfig();
+    if (reader.u64() != def->getLayoutHash()) {
+      throw StateException("Snapshot was taken with a definition that has other states");
+    }
+    const bool was_started = reader.u8() != 0;
+    const StateId state = reader.u32();
+    if (state == INVALID_ID ? was_started : state >= config.states().size()) {
+      throw StateException("Snapshot holds an invalid current state");
+    }
+
+    if (apply) {
+      variable_manager->clear();
+    }
+    const uint32_t globals = reader.count(sizeof(uint32_t) + 1);
+    for (uint32_t i = 0; i < globals; ++i) {
+      const std::string_view name = reader.str();
+      VariableValue value = readValue(reader);
+      if (apply) {
+        variable_manager->setGlobalVariable(std::string(name), value);
+      }
+    }
+    const uint32_t scopes = reader.count(2 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < scopes; ++i) {
+      const StateId scope = reader.u32();
+      if (scope >= config.states().size()) {
+        throw StateException("Snapshot holds variables of an invalid state");
+      }
+      const std::string scope_name(config.stateName(scope));
+      const uint32_t variables = reader.count(sizeof(uint32_t) + 1);
+      for (uint32_t j = 0; j < variables; ++j) {
+        const std::string_view name = reader.str();
+        VariableValue value = readValue(reader);
+        if (apply) {
+          variable_manager->setStateVariable(scope_name, std::string(name), value);
+        }
+      }
+    }
+
+    if (apply) {
+      cancelTimers();
+      current_state = state == INVALID_ID ? std::string() : std::string(config.stateName(state));
+      started = was_started;
+      ++state_version;
+      if (started) {
+        armTimers();
+      }
+    }
+  }
+
+  void clear() {
+    current_state.clear();
+    started = false;
+    ++state_version;
+  }
+};
+
+// Constructors and destructor
+
+StateMachine::StateMachine(const std::string& config_path)
+    : impl_(std::make_unique<Impl>(this, MachineDefinition::fromFile(config_path))) {}
+
+StateMachine::StateMachine(const std::string& yaml_content, bool is_content) {
+  if (!is_content) {
+    throw ConfigException("Second constructor argument must be true when passing YAML content");
+  }
+  impl_ = std::make_unique<Impl>(this, MachineDefinition::fromString(yaml_content));
+}
+
+StateMachine::StateMachine(std::shared_ptr<const MachineDefinition> definition) {
+  if (!definition) {
+    throw ConfigException("StateMachine definition must not be null");
+  }
+  impl_ = std::make_unique<Impl>(this, std::move(definition));
 }
 
 StateMachine::~StateMachine() = default;
 
-StateMachine::StateMachine(StateMachine&& other) noexcept = default;
+StateMachine::StateMachine(StateMachine&& other) noexcept : impl_(std::move(other.impl_)) {
+  if (impl_) {
+    impl_->self = this;
+  }
+}
 
-StateMachine& StateMachine::operator=(StateMachine&& other) noexcept = default;
+StateMachine& StateMachine::operator=(StateMachine&& other) noexcept {
+  impl_ = std::move(other.impl_);
+  if (impl_) {
+    impl_->self = this;
+  }
+  return *this;
+}
 
 // Lifecycle methods
 
@@ -130,7 +681,11 @@ void StateMachine::start() {
     throw StateException(error);
   }
 
-  if (impl_->initial_state.empty()) {
+  impl_->adoptPendingDefinition();
+  const auto definition = impl_->definition.load();
+  const std::string& initial_state = definition->getInitialState();
+
+  if (initial_state.empty()) {
     const std::string error = "No initial state found in configuration";
     if (impl_->error_handler) {
       impl_->error_handler(error);
@@ -138,8 +693,8 @@ void StateMachine::start() {
     throw StateException(error);
   }
 
-  if (!impl_->config_parser->hasState(impl_->initial_state)) {
-    const std::string error = "Initial state '" + impl_->initial_state + "' not found";
+  if (!definition->hasState(initial_state)) {
+    const std::string error = "Initial state '" + initial_state + "' not found";
     if (impl_->error_handler) {
       impl_->error_handler(error);
     }
@@ -147,16 +702,20 @@ void StateMachine::start() {
   }
 
   // Transition to initial state
-  impl_->current_state = impl_->initial_state;
+  impl_->current_state = initial_state;
+
+  impl_->bindCallbacks(definition);
+  const auto callbacks = impl_->callbacks;
+  const CompiledConfig& config = definition->getCompiledConfig();
+  const StateId initial = config.findState(impl_->current_state);
 
   // Call on_enter callback of initial state
-  // Check for callback in registry, not just in configuration
-  if (impl_->callback_registry->hasStateCallback(impl_->current_state, "on_enter")) {
-    impl_->callback_registry->callStateCallback(impl_->current_state, "on_enter");
+  if (const StateCallback* on_enter = callbacks->on_enter[initial]) {
+    (*on_enter)();
   }
 
   // Execute initial state actions
-  executeStateActions(impl_->current_state);
+  executeStateActions(config, initial);
 
   // Notify observers about entering initial state
   // Clean up expired observers first
@@ -173,6 +732,12 @@ void StateMachine::start() {
   }
 
   impl_->started = true;
+  ++impl_->state_version;
+
+  // Armed last: a timer expiring on another thread must see the started machine
+  impl_->armTimers();
+
+  resumeStateWaiters();
 }
 
 void StateMachine::stop() {
@@ -184,9 +749,18 @@ void StateMachine::stop() {
     throw StateException(error);
   }
 
+  impl_->cancelTimers();
+
   // Call on_exit callback of current state
   if (!impl_->current_state.empty()) {
-    impl_->callback_registry->callStateCallback(impl_->current_state, "on_exit");
+    const auto definition = impl_->definition.load();
+    impl_->bindCallbacks(definition, false);  // stop() runs no actions
+    const auto callbacks = impl_->callbacks;
+    const StateId state = definition->getCompiledConfig().findState(impl_->current_state);
+    if (const StateCallback* on_exit = state != INVALID_ID ? callbacks->on_exit[state] : nullptr) {
+      FSMCONFIG_TRACE_SPAN("fsm.on_exit");
+      (*on_exit)();
+    }
 
     // Notify observers about exiting state
     // Clean up expired observers first
@@ -204,17 +778,14 @@ void StateMachine::stop() {
   }
 
   impl_->started = false;
+  ++impl_->state_version;
 }
 
 void StateMachine::reset() {
   if (impl_->started) {
     stop();
   }
-  // Save initial state
-  std::string saved_initial_state = impl_->initial_state;
   impl_->clear();
-  // Restore initial state
-  impl_->initial_state = saved_initial_state;
 }
 
 // State query methods
@@ -222,23 +793,79 @@ void StateMachine::reset() {
 std::string StateMachine::getCurrentState() const { return impl_->current_state; }
 
 bool StateMachine::hasState(const std::string& state_name) const {
-  return impl_->states.find(state_name) != impl_->states.end();
+  return impl_->definition.load()->hasState(state_name);
 }
 
-std::vector<std::string> StateMachine::getAllStates() const {
-  std::vector<std::string> result;
-  result.reserve(impl_->states.size());
-  for (const auto& [name, state] : impl_->states) {
-    result.push_back(name);
-  }
-  return result;
-}
+std::vector<std::string> StateMachine::getAllStates() const { return impl_->definition.load()->getStateNames(); }
 
 // Event handling methods
 
 void StateMachine::triggerEvent(const std::string& event_name) { triggerEvent(event_name, {}); }
 
 void StateMachine::triggerEvent(const std::string& event_name, const std::map<std::string, VariableValue>& data) {
+  if (!impl_->strand) {
+    processEvent(event_name, data);
+    return;
+  }
+
+  // Uncontended: process the event in place
+  size_t idle = 0;
+  if (impl_->strand_pending.compare_exchange_strong(idle, 1)) {
+    processStrandEvent(event_name, data);
+    if (impl_->strand_pending.fetch_sub(1) == 1) {
+      return;
+    }
+  } else {
+    // Busy: leave the event to the running thread, unless it finished meanwhile
+    impl_->strand_mailbox.push(Impl::StrandEvent{event_name, data});
+    if (impl_->strand_pending.fetch_add(1) != 0) {
+      return;
+    }
+  }
+
+  // This thread owns the strand until the pending count drops to zero
+  impl_->drainStrand();
+}
+
+void StateMachine::setStrandMode(bool enabled) { impl_->strand = enabled; }
+
+bool StateMachine::isStrandMode() const { return impl_->strand; }
+
+void StateMachine::setTimerService(TimerService* timers) {
+  impl_->cancelTimers();
+  impl_->timers = timers;
+  if (impl_->started) {
+    impl_->armTimers();
+  }
+}
+
+void StateMachine::processStrandEvent(const std::string& event_name,
+                                      const std::map<std::string, VariableValue>& data) {
+  try {
+    processEvent(event_name, data);
+  } catch (const StateException&) {
+    // Already reported where it was thrown
+  } catch (const std::exception& e) {
+    if (impl_->error_handler) {
+      impl_->error_handler(e.what());
+    }
+  } catch (...) {
+    if (impl_->error_handler) {
+      impl_->error_handler("Event '" + event_name + "' failed with an unknown exception");
+    }
+  }
+}
+
+void StateMachine::processTimeout(uint64_t epoch, EventId event) {
+  // The state was left (or the definition replaced) after the timer expired
+  if (!impl_->started || epoch != impl_->timer_epoch) {
+    return;
+  }
+  const auto definition = impl_->definition.load();
+  processStrandEvent(std::string(definition->getCompiledConfig().eventName(event)), {});
+}
+
+void StateMachine::processEvent(const std::string& event_name, const std::map<std::string, VariableValue>& data) {
   if (!impl_->started) {
     const std::string error = "StateMachine is not started";
     if (impl_->error_handler) {
@@ -255,33 +882,351 @@ void StateMachine::triggerEvent(const std::string& event_name, const std::map<st
     throw StateException(error);
   }
 
+  // The whole event is processed on one definition snapshot, even if reload() publishes a new one meanwhile
+  impl_->adoptPendingDefinition();
+  const auto definition = impl_->definition.load();
+  StateId state = definition->getCompiledConfig().findState(impl_->current_state);
+  applyEvent(definition, state, event_name, data);
+}
+
+EventOutcome StateMachine::applyEvent(const std::shared_ptr<const MachineDefinition>& definition, StateId& state,
+                                      std::string_view event_name, const std::map<std::string, VariableValue>& data) {
   // Look for transition for event from current state
-  const TransitionInfo* transition = impl_->config_parser->findTransition(impl_->current_state, event_name);
+  const CompiledConfig& config = definition->getCompiledConfig();
+  const CompiledTransition* transition = config.findTransition(state, config.findEvent(event_name));
   if (!transition) {
     // Ignore event if transition not found
-    return;
-  }
-
-  // Check guard condition
-  if (!transition->guard_callback.empty()) {
-    if (!evaluateGuard(transition->from_state, transition->to_state, event_name)) {
-      // Guard returned false - don't perform transition
-      return;
-    }
+    return EventOutcome::IGNORED;
   }
 
   // Create transition event
   TransitionEvent event;
   event.event_name = event_name;
   event.from_state = impl_->current_state;
-  event.to_state = transition->to_state;
+  event.to_state = config.stateName(transition->to);
+
+  // Check guard condition; an unregistered guard denies the transition
+  impl_->bindCallbacks(definition);
+  if (transition->guard != INVALID_ID) {
+    const auto index = static_cast<size_t>(transition - config.transitions().data());
+    const GuardCallback* guard = impl_->callbacks->guards[index];
+    if (guard == nullptr || !(*guard)()) {
+      // Guard returned false - don't perform transition
+      return EventOutcome::GUARD_REJECTED;
+    }
+  }
+
   event.data = data;
   event.timestamp = std::chrono::system_clock::now();
 
   // Perform transition
-  performTransition(event);
+  performTransition(config, *transition, event);
+  state = transition->to;
+  return EventOutcome::TRANSITIONED;
+}
+
+size_t StateMachine::triggerEvents(std::span<const EventRef> events, std::span<EventOutcome> outcomes) {
+  if (!outcomes.empty() && outcomes.size() < events.size()) {
+    const std::string error = "triggerEvents() needs one outcome slot per event";
+    if (impl_->error_handler) {
+      impl_->error_handler(error);
+    }
+    throw StateException(error);
+  }
+
+  if (!impl_->strand) {
+    return processBatch(events, outcomes);
+  }
+
+  size_t idle = 0;
+  size_t transitions = 0;
+  if (impl_->strand_pending.compare_exchange_strong(idle, 1)) {
+    try {
+      transitions = processBatch(events, outcomes);
+    } catch (const StateException&) {
+      // Already reported where it was thrown
+    }
+    if (impl_->strand_pending.fetch_sub(1) == 1) {
+      return transitions;
+    }
+  } else {
+    for (size_t i = 0; i < events.size(); ++i) {
+      const EventRef& ref = events[i];
+      impl_->strand_mailbox.push(Impl::StrandEvent{std::string(ref.name), ref.data ? *ref.data : NO_EVENT_DATA});
+      if (!outcomes.empty()) {
+        outcomes[i] = EventOutcome::QUEUED;
+      }
+    }
+    if (events.empty() || impl_->strand_pending.fetch_add(events.size()) != 0) {
+      return 0;
+    }
+  }
+  impl_->drainStrand();
+  return transitions;
+}
+
+size_t StateMachine::processBatch(std::span<const EventRef> events, std::span<EventOutcome> outcomes) {
+  // Observers are pruned once for the batch; restored however the batch ends
+  struct PruneScope {
+    Impl& impl;
+    bool previous;
+    ~PruneScope() { impl.observers_pruned = previous; }
+  } const prune_scope{*impl_, impl_->observers_pruned};
+  impl_->pruneObservers();
+  impl_->observers_pruned = true;
+
+  std::shared_ptr<const MachineDefinition> definition;
+  StateId state = INVALID_ID;
+  uint64_t version = impl_->state_version - 1;
+  size_t transitions = 0;
+
+  for (size_t i = 0; i < events.size(); ++i) {
+    impl_->adoptPendingDefinition();
+
+    // Re-resolved only if something but this loop's own transitions changed the machine (callbacks may stop,
+    // reload or re-enter it)
+    if (impl_->state_version != version) {
+      if (!impl_->started || impl_->current_state.empty()) {
+        const std::string error = impl_->started ? "No current state" : "StateMachine is not started";
+        if (impl_->error_handler) {
+          impl_->error_handler(error);
+        }
+        // Filled before throwing too: the strand path reports the error through outcomes only
+        if (!outcomes.empty()) {
+          std::fill(outcomes.begin() + static_cast<std::ptrdiff_t>(i),
+                    outcomes.begin() + static_cast<std::ptrdiff_t>(events.size()), EventOutcome::FAILED);
+        }
+        if (i == 0) {
+          throw StateException(error);
+        }
+        break;
+      }
+      definition = impl_->definition.load();
+      state = definition->getCompiledConfig().findState(impl_->current_state);
+      version = impl_->state_version;
+    }
+
+    const EventRef& ref = events[i];
+    EventOutcome outcome = EventOutcome::FAILED;
+    try {
+      outcome = applyEvent(definition, state, ref.name, ref.data ? *ref.data : NO_EVENT_DATA);
+    } catch (const StateException&) {
+      // Already reported where it was thrown
+    } catch (const std::exception& e) {
+      if (impl_->error_handler) {
+        impl_->error_handler(e.what());
+      }
+    } catch (...) {
+      if (impl_->error_handler) {
+        impl_->error_handler("Event '" + std::string(ref.name) + "' failed with an unknown exception");
+      }
+    }
+
+    if (outcome == EventOutcome::TRANSITIONED) {
+      ++transitions;
+      if (impl_->state_version == version + 1) {
+        version = impl_->state_version;
+      }
+    } else if (outcome == EventOutcome::FAILED) {
+      version = impl_->state_version - 1;
+    }
+    if (!outcomes.empty()) {
+      outcomes[i] = outcome;
+    }
+  }
+  return transitions;
+}
+
+// Coroutine support
+
+StateAwaitable StateMachine::untilState(std::string state_name) {
+  return {*this, std::vector<std::string>{std::move(state_name)}};
+}
+
+StateAwaitable StateMachine::untilState(std::vector<std::string> state_names) {
+  return {*this, std::move(state_names)};
+}
+
+EventAwaitable StateMachine::postEvent(std::string event_name, std::map<std::string, VariableValue> data) {
+  return {*this, std::move(event_name), std::move(data)};
 }
 
+bool StateMachine::suspendUntilState(StateAwaitable& waiter) {
+  if (!impl_->strand) {
+    return addStateWaiter(waiter);
+  }
+
+  // The waiter list belongs to the strand; the waiter may be resumed before this returns
+  size_t idle = 0;
+  bool suspended = true;
+  if (impl_->strand_pending.compare_exchange_strong(idle, 1)) {
+    suspended = addStateWaiter(waiter);
+    if (impl_->strand_pending.fetch_sub(1) == 1) {
+      return suspended;
+    }
+  } else {
+    impl_->strand_mailbox.push(Impl::StrandEvent{{}, {}, 0, INVALID_ID, &waiter});
+    if (impl_->strand_pending.fetch_add(1) != 0) {
+      return true;
+    }
+  }
+  impl_->drainStrand();
+  return suspended;
+}
+
+bool StateMachine::suspendForEvent(EventAwaitable& waiter) {
+  if (!impl_->strand) {
+    processEvent(waiter.event_name_, waiter.data_);
+    waiter.state_ = impl_->current_state;
+    return false;
+  }
+
+  size_t idle = 0;
+  bool suspended = false;
+  if (impl_->strand_pending.compare_exchange_strong(idle, 1)) {
+    processStrandEvent(waiter.event_name_, waiter.data_);
+    waiter.state_ = impl_->current_state;
+    if (impl_->strand_pending.fetch_sub(1) == 1) {
+      return false;
+    }
+  } else {
+    // Resumed by the thread that processes the event
+    suspended = true;
+    impl_->strand_mailbox.push(
+        Impl::StrandEvent{std::move(waiter.event_name_), std::move(waiter.data_), 0, INVALID_ID, nullptr, &waiter});
+    if (impl_->strand_pending.fetch_add(1) != 0) {
+      return true;
+    }
+  }
+  impl_->drainStrand();
+  return suspended;
+}
+
+bool StateMachine::addStateWaiter(StateAwaitable& waiter) {
+  if (impl_->started && std::find(waiter.state_names_.begin(), waiter.state_names_.end(), impl_->current_state) !=
+                            waiter.state_names_.end()) {
+    waiter.entered_ = impl_->current_state;
+    return false;
+  }
+  impl_->state_waiters.push_back(&waiter);
+  return true;
+}
+
+void StateMachine::resumeStateWaiters() {
+  if (impl_->state_waiters.empty()) {
+    return;
+  }
+
+  // Resumed coroutines may wait again or trigger events, so take the ready ones out first
+  std::vector<StateAwaitable*> ready;
+  std::erase_if(impl_->state_waiters, [this, &ready](StateAwaitable* waiter) {
+    const auto& names = waiter->state_names_;
+    if (std::find(names.begin(), names.end(), impl_->current_state) == names.end()) {
+      return false;
+    }
+    waiter->entered_ = impl_->current_state;
+    ready.push_back(waiter);
+    return true;
+  });
+  for (StateAwaitable* waiter : ready) {
+    waiter->handle_.resume();
+  }
+}
+
+StateAwaitable::StateAwaitable(StateMachine& machine, std::vector<std::string> state_names)
+    : machine_(&machine), state_names_(std::move(state_names)) {}
+
+bool StateAwaitable::await_suspend(std::coroutine_handle<> handle) {
+  handle_ = handle;
+  return machine_->suspendUntilState(*this);
+}
+
+EventAwaitable::EventAwaitable(StateMachine& machine, std::string event_name,
+                               std::map<std::string, VariableValue> data)
+    : machine_(&machine), event_name_(std::move(event_name)), data_(std::move(data)) {}
+
+bool EventAwaitable::await_suspend(std::coroutine_handle<> handle) {
+  handle_ = handle;
+  return machine_->suspendForEvent(*this);
+}
+
+// Configuration reload methods
+
+void StateMachine::reload(const std::string& config_path) {
+  // Parse and validate before touching the running machine
+  swapDefinition(MachineDefinition::fromFile(config_path));
+}
+
+void StateMachine::reloadFromString(const std::string& yaml_content) {
+  swapDefinition(MachineDefinition::fromString(yaml_content));
+}
+
+void StateMachine::swapDefinition(std::shared_ptr<const MachineDefinition> definition) {
+  if (!definition) {
+    const std::string error = "StateMachine definition must not be null";
+    if (impl_->error_handler) {
+      impl_->error_handler(error);
+    }
+    throw ConfigException(error);
+  }
+
+  // Running machines migrate by state name; a definition without the current state is rejected
+  if (impl_->started && !definition->hasState(impl_->current_state)) {
+    const std::string error = "Reloaded configuration has no state '" + impl_->current_state + "'";
+    if (impl_->error_handler) {
+      impl_->error_handler(error);
+    }
+    throw StateException(error);
+  }
+
+  // Sealed machines only accept definitions whose callbacks are all registered
+  if (const std::string error = impl_->checkSealed(definition); !error.empty()) {
+    if (impl_->error_handler) {
+      impl_->error_handler(error);
+    }
+    throw StateException(error);
+  }
+
+  impl_->seedVariables(*definition);
+  impl_->definition.store(std::move(definition));
+  ++impl_->state_version;
+  if (impl_->started) {
+    impl_->restartTimers();
+  }
+}
+
+void StateMachine::scheduleDefinition(std::shared_ptr<const MachineDefinition> definition) {
+  if (!definition) {
+    throw ConfigException("StateMachine definition must not be null");
+  }
+  impl_->pending_definition.store(std::move(definition));
+  impl_->has_pending_definition.store(true, std::memory_order_release);
+}
+
+std::shared_ptr<const MachineDefinition> StateMachine::getDefinition() const { return impl_->definition.load(); }
+
+// Callback binding methods
+
+void StateMachine::bind() {
+  impl_->adoptPendingDefinition();
+  impl_->callbacks = impl_->resolveCallbacks(impl_->definition.load());
+
+  const std::string error = Impl::describeUnbound(impl_->callbacks->unbound);
+  if (!error.empty()) {
+    if (impl_->error_handler) {
+      impl_->error_handler(error);
+    }
+    throw StateException(error);
+  }
+}
+
+void StateMachine::seal() {
+  bind();
+  impl_->sealed = true;
+}
+
+bool StateMachine::isSealed() const { return impl_->sealed; }
+
 // Variable management methods
 
 void StateMachine::setVariable(const std::string& name, const VariableValue& value) {
@@ -310,6 +1255,77 @@ bool StateMachine::hasVariable(const std::string& name) const {
   return impl_->variable_manager->hasVariable(impl_->current_state, name);
 }
 
+// Snapshot methods
+
+std::string StateMachine::snapshot() const {
+  const StateMachine* const self = this;
+  return snapshotAll(std::span<const StateMachine* const>(&self, 1));
+}
+
+void StateMachine::restore(std::string_view snapshot) {
+  StateMachine* const self = this;
+  restoreAll(std::span<StateMachine* const>(&self, 1), snapshot);
+}
+
+std::string StateMachine::snapshotAll(std::span<const StateMachine* const> machines) {
+  detail::BinaryWriter writer;
+  writer.reserve(12 + (machines.size() * 25));
+  writer.u32(SNAPSHOT_MAGIC);
+  writer.u32(SNAPSHOT_FORMAT);
+  writer.u32(static_cast<uint32_t>(machines.size()));
+  for (const StateMachine* machine : machines) {
+    machine->impl_->writeSnapshot(writer);
+  }
+  return writer.take();
+}
+
+void StateMachine::restoreAll(std::span<StateMachine* const> machines, std::string_view snapshot) {
+  for (StateMachine* machine : machines) {
+    machine->impl_->adoptPendingDefinition();
+  }
+
+  // First pass validates every record, the second one applies them
+  for (const bool apply : {false, true}) {
+    detail::BinaryReader reader(snapshot);
+    StateMachine* current = machines.empty() ? nullptr : machines.front();
+    std::string error;
+    try {
+      if (reader.u32() != SNAPSHOT_MAGIC) {
+        throw StateException("Data is not a StateMachine snapshot");
+      }
+      if (const uint32_t format = reader.u32(); format != SNAPSHOT_FORMAT) {
+        throw StateException("Unsupported snapshot format " + std::to_string(format));
+      }
+      if (const uint32_t count = reader.u32(); count != machines.size()) {
+        throw StateException("Snapshot holds " + std::to_string(count) + " machines, " +
+                             std::to_string(machines.size()) + " given");
+      }
+      for (StateMachine* machine : machines) {
+        current = machine;
+        machine->impl_->readSnapshot(reader, apply);
+      }
+      if (!reader.atEnd()) {
+        throw StateException("Snapshot has trailing data");
+      }
+    } catch (const ConfigException&) {
+      error = "Snapshot is truncated";
+    } catch (const StateException& e) {
+      error = e.what();
+    }
+
+    if (!error.empty()) {
+      if (current != nullptr && current->impl_->error_handler) {
+        current->impl_->error_handler(error);
+      }
+      throw StateException(error);
+    }
+  }
+
+  for (StateMachine* machine : machines) {
+    machine->resumeStateWaiters();
+  }
+}
+
 // Observer methods
 
 void StateMachine::registerStateObserver(const std::shared_ptr<StateObserver>& observer) {
@@ -349,128 +1365,133 @@ void StateMachine::setErrorHandler(ErrorHandler handler) { impl_->error_handler
 
 // Helper methods
 
-void StateMachine::performTransition(const TransitionEvent& event) {
-  const std::string old_state = impl_->current_state;
-  const std::string new_state = event.to_state;
+void StateMachine::performTransition(const CompiledConfig& config, const CompiledTransition& transition,
+                                     const TransitionEvent& event) {
+  FSMCONFIG_TRACE_SPAN("fsm.transition");
 
-  // Check if target state exists
-  if (!hasState(new_state)) {
-    const std::string error = "Target state '" + new_state + "' does not exist";
-    if (impl_->error_handler) {
-      impl_->error_handler(error);
-    }
-    throw StateException(error);
+  // Target state always exists: transitions are resolved to state identifiers at load time
+  const std::string& old_state = event.from_state;
+  const std::string& new_state = event.to_state;
+
+  // Bound to config by triggerEvent(); kept alive while callbacks run
+  const auto callbacks = impl_->callbacks;
+  const auto index = static_cast<size_t>(&transition - config.transitions().data());
+
+  // Leaving the state cancels its timeouts
+  impl_->cancelTimers();
+
+  // Expired observers are skipped below; the list is pruned once per transition (once per batch in triggerEvents())
+  if (!impl_->observers_pruned) {
+    impl_->pruneObservers();
   }
 
   // Call on_exit callback of current state
-  const auto& old_state_info = impl_->config_parser->getState(old_state);
-  if (!old_state_info.on_exit_callback.empty()) {
-    impl_->callback_registry->callStateCallback(old_state, "on_exit");
+  if (config.states()[transition.from].on_exit != INVALID_ID) {
+    FSMCONFIG_TRACE_SPAN("fsm.on_exit");
+    if (const StateCallback* on_exit = callbacks->on_exit[transition.from]) {
+      (*on_exit)();
+    }
   }
 
   // Notify observers about exiting state
-  // Clean up expired observers first
-  impl_->observers.erase(
-      std::remove_if(impl_->observers.begin(), impl_->observers.end(),
-                     [](const std::weak_ptr<StateObserver>& weak_obs) { return weak_obs.expired(); }),
-      impl_->observers.end());
+  {
+    FSMCONFIG_TRACE_SPAN("fsm.observers.exit");
 
-  // Notify remaining valid observers
-  for (const auto& weak_obs : impl_->observers) {
-    if (auto observer = weak_obs.lock()) {
-      observer->onStateExit(old_state);
+    // Notify remaining valid observers
+    for (const auto& weak_obs : impl_->observers) {
+      if (auto observer = weak_obs.lock()) {
+        observer->onStateExit(old_state);
+      }
     }
   }
 
   // Execute transition actions
-  const TransitionInfo* transition = impl_->config_parser->findTransition(old_state, event.event_name);
-  if (transition && !transition->actions.empty()) {
-    executeTransitionActions(transition->actions);
+  if (!transition.actions.empty()) {
+    FSMCONFIG_TRACE_SPAN("fsm.transition_actions");
+    executeTransitionActions(config, transition);
   }
 
   // Call transition callback
-  if (transition && !transition->transition_callback.empty()) {
-    impl_->callback_registry->callTransitionCallback(old_state, new_state, event);
+  if (const TransitionCallback* on_transition = callbacks->on_transition[index]) {
+    FSMCONFIG_TRACE_SPAN("fsm.on_transition");
+    (*on_transition)(event);
   }
 
   // Switch to new state
   impl_->current_state = new_state;
+  ++impl_->state_version;
+  impl_->armTimers();
 
   // Call on_enter callback of new state
-  // Check for callback in registry, not just in configuration
-  if (impl_->callback_registry->hasStateCallback(new_state, "on_enter")) {
-    impl_->callback_registry->callStateCallback(new_state, "on_enter");
+  if (const StateCallback* on_enter = callbacks->on_enter[transition.to]) {
+    FSMCONFIG_TRACE_SPAN("fsm.on_enter");
+    (*on_enter)();
   }
 
   // Execute new state actions
-  executeStateActions(new_state);
+  executeStateActions(config, transition.to);
 
   // Notify observers about entering new state
-  // Clean up expired observers first
-  impl_->observers.erase(
-      std::remove_if(impl_->observers.begin(), impl_->observers.end(),
-                     [](const std::weak_ptr<StateObserver>& weak_obs) { return weak_obs.expired(); }),
-      impl_->observers.end());
+  {
+    FSMCONFIG_TRACE_SPAN("fsm.observers.enter");
 
-  // Notify remaining valid observers
-  for (const auto& weak_obs : impl_->observers) {
-    if (auto observer = weak_obs.lock()) {
-      observer->onStateEnter(new_state);
+    // Notify remaining valid observers
+    for (const auto& weak_obs : impl_->observers) {
+      if (auto observer = weak_obs.lock()) {
+        observer->onStateEnter(new_state);
+      }
     }
   }
 
   // Notify observers about transition
-  // Clean up expired observers first
-  impl_->observers.erase(
-      std::remove_if(impl_->observers.begin(), impl_->observers.end(),
-                     [](const std::weak_ptr<StateObserver>& weak_obs) { return weak_obs.expired(); }),
-      impl_->observers.end());
+  {
+    FSMCONFIG_TRACE_SPAN("fsm.observers.transition");
 
-  // Notify remaining valid observers
-  for (const auto& weak_obs : impl_->observers) {
-    if (auto observer = weak_obs.lock()) {
-      observer->onTransition(event);
+    // Notify remaining valid observers
+    for (const auto& weak_obs : impl_->observers) {
+      if (auto observer = weak_obs.lock()) {
+        observer->onTransition(event);
+      }
     }
   }
-}
 
-bool StateMachine::evaluateGuard(const std::string& from_state, const std::string& to_state,
-                                 const std::string& event_name) {
-  return impl_->callback_registry->callGuard(from_state, to_state, event_name);
+  resumeStateWaiters();
 }
 
-void StateMachine::executeStateActions(const std::string& state_name) {
-  const auto& state_info = impl_->config_parser->getState(state_name);
-  for (const auto& action_name : state_info.actions) {
-    impl_->callback_registry->callAction(action_name);
-  }
+void StateMachine::executeStateActions(const CompiledConfig& config, StateId state) {
+  FSMCONFIG_TRACE_SPAN("fsm.state_actions");
+
+  impl_->runActions(config, config.states()[state].actions, &Impl::CallbackTable::state_offsets, state);
 }
 
-void StateMachine::executeTransitionActions(const std::vector<std::string>& actions) {
-  for (const auto& action_name : actions) {
-    impl_->callback_registry->callAction(action_name);
-  }
+void StateMachine::executeTransitionActions(const CompiledConfig& config, const CompiledTransition& transition) {
+  const auto index = static_cast<size_t>(&transition - config.transitions().data());
+  impl_->runActions(config, transition.actions, &Impl::CallbackTable::transition_offsets, index);
 }
 
 // Helper methods for callback registration (for template methods)
 
 void StateMachine::registerStateCallbackImpl(const std::string& state_name, const std::string& callback_type,
-                                             std::function<void()> callback) {
-  impl_->callback_registry->registerStateCallback(state_name, callback_type, callback);
+                                             Delegate<void()> callback) {
+  impl_->rejectIfSealed();
+  impl_->callback_registry->registerStateCallback(state_name, callback_type, std::move(callback));
 }
 
 void StateMachine::registerTransitionCallbackImpl(const std::string& from_state, const std::string& to_state,
-                                                  std::function<void(const TransitionEvent&)> callback) {
-  impl_->callback_registry->registerTransitionCallback(from_state, to_state, callback);
+                                                  Delegate<void(const TransitionEvent&)> callback) {
+  impl_->rejectIfSealed();
+  impl_->callback_registry->registerTransitionCallback(from_state, to_state, std::move(callback));
 }
 
 void StateMachine::registerGuardImpl(const std::string& from_state, const std::string& to_state,
-                                     const std::string& event_name, std::function<bool()> callback) {
-  impl_->callback_registry->registerGuard(from_state, to_state, event_name, callback);
+                                     const std::string& event_name, Delegate<bool()> callback) {
+  impl_->rejectIfSealed();
+  impl_->callback_registry->registerGuard(from_state, to_state, event_name, std::move(callback));
 }
 
-void StateMachine::registerActionImpl(const std::string& action_name, std::function<void()> callback) {
-  impl_->callback_registry->registerAction(action_name, callback);
+void StateMachine::registerActionImpl(const std::string& action_name, Delegate<void()> callback) {
+  impl_->rejectIfSealed();
+  impl_->callback_registry->registerAction(action_name, std::move(callback));
 }
 
 }  // namespace fsmconfig
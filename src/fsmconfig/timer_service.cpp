@@ -0,0 +1,450 @@
+#include "fsmconfig/timer_service.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "fsmconfig/types.hpp"
+
+namespace fsmconfig {
+
+namespace {
+
+/// Level 0 resolves single ticks
+constexpr uint32_t ROOT_BITS = 8;
+constexpr uint32_t ROOT_SLOTS = 1U << ROOT_BITS;
+
+/// Each higher level covers LEVEL_SLOTS slots of the level below
+constexpr uint32_t LEVEL_BITS = 6;
+constexpr uint32_t LEVEL_SLOTS = 1U << LEVEL_BITS;
+constexpr uint32_t LEVELS = 5;
+
+constexpr uint32_t SLOT_COUNT = ROOT_SLOTS + ((LEVELS - 1) * LEVEL_SLOTS);
+
+/// Largest distance the wheel represents; later deadlines are re-cascaded from the top level
+constexpr uint64_t MAX_DELTA = (uint64_t{1} << (ROOT_BITS + ((LEVELS - 1) * LEVEL_BITS))) - 1;
+
+/// Longest sleep of the background thread, in ticks
+constexpr uint64_t MAX_SLEEP_TICKS = uint64_t{1} << 20;
+
+/// End of list / no node
+constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Wheel slot of a deadline, relative to the next tick to process
+ *
+ * Level n > 0 holds deadlines less than 2^(8 + 6n) ticks away, in slots of
+ * 2^(8 + 6(n - 1)) ticks; a slot is cascaded into the levels below when the
+ * wheel reaches its first tick.
+ */
+uint32_t slotOf(uint64_t expires, uint64_t next_tick) {
+  uint64_t delta = expires - next_tick;
+  if (delta < ROOT_SLOTS) {
+    return static_cast<uint32_t>(expires & (ROOT_SLOTS - 1));
+  }
+  if (delta > MAX_DELTA) {
+    delta = MAX_DELTA;
+    expires = next_tick + MAX_DELTA;
+  }
+
+  uint32_t level = 1;
+  while (level < LEVELS - 1 && delta >= (uint64_t{1} << (ROOT_BITS + (level * LEVEL_BITS)))) {
+    ++level;
+  }
+  const uint32_t shift = ROOT_BITS + ((level - 1) * LEVEL_BITS);
+  return ROOT_SLOTS + ((level - 1) * LEVEL_SLOTS) + static_cast<uint32_t>((expires >> shift) & (LEVEL_SLOTS - 1));
+}
+
+}  // namespace
+
+/**
+ * @brief TimerService implementation (Pimpl idiom)
+ */
+class TimerService::Impl {
+ public:
+  enum class NodeState : uint8_t { Free, Armed, Due };
+
+  /// Timer; linked into a wheel slot while armed, into the free list while free
+  struct Node {
+    uint64_t expires = 0;
+    uint32_t prev = NIL;
+    uint32_t next = NIL;
+    uint32_t slot = NIL;
+    uint32_t generation = 1;
+    NodeState state = NodeState::Free;
+    TimerCallback callback;
+  };
+
+  explicit Impl(std::chrono::milliseconds resolution) : tick(resolution) {
+    heads.fill(NIL);
+    tails.fill(NIL);
+  }
+
+  std::chrono::milliseconds tick;
+
+  mutable std::mutex mutex;
+  std::condition_variable wakeup;         ///< Background thread: timers or stop request changed
+  std::condition_variable callback_done;  ///< cancel(): running callback returned
+
+  std::vector<Node> nodes;
+  uint32_t free_head = NIL;
+  std::array<uint32_t, SLOT_COUNT> heads{};
+  std::array<uint32_t, SLOT_COUNT> tails{};
+  std::array<uint64_t, SLOT_COUNT / 64> occupied{};  ///< Non-empty slots; one word per 64 slots
+
+  /// Next tick to process; the current time is next_tick - 1
+  uint64_t next_tick = 1;
+  std::chrono::milliseconds carry{0};
+
+  /// Armed and due timers
+  size_t pending = 0;
+
+  /// Expired timers of the tick being processed
+  std::vector<TimerId> due;
+
+  TimerId running = INVALID_TIMER;
+  std::thread::id running_thread;
+
+  bool thread_running = false;
+  bool stopping = false;
+  Clock::time_point origin;  ///< Wall time of tick 0 while the thread runs
+  std::jthread thread;
+
+  static TimerId makeId(uint32_t index, uint32_t generation) { return (uint64_t{generation} << 32) | index; }
+
+  [[nodiscard]] Node* find(TimerId id) {
+    const auto index = static_cast<uint32_t>(id);
+    if (index >= nodes.size() || nodes[index].generation != static_cast<uint32_t>(id >> 32)) {
+      return nullptr;
+    }
+    return &nodes[index];
+  }
+
+  [[nodiscard]] uint64_t wallTick() const { return static_cast<uint64_t>((Clock::now() - origin) / tick); }
+
+  uint32_t allocate() {
+    if (free_head != NIL) {
+      const uint32_t index = free_head;
+      free_head = nodes[index].next;
+      return index;
+    }
+    nodes.emplace_back();
+    return static_cast<uint32_t>(nodes.size() - 1);
+  }
+
+  void release(uint32_t index) {
+    Node& node = nodes[index];
+    node.callback = nullptr;
+    node.state = NodeState::Free;
+    node.slot = NIL;
+    node.prev = NIL;
+    node.next = free_head;
+    if (++node.generation == 0) {
+      node.generation = 1;
+    }
+    free_head = index;
+    --pending;
+  }
+
+  void link(uint32_t index) {
+    Node& node = nodes[index];
+    const uint32_t slot = slotOf(node.expires, next_tick);
+    node.slot = slot;
+    node.prev = tails[slot];
+    node.next = NIL;
+    if (tails[slot] == NIL) {
+      heads[slot] = index;
+    } else {
+      nodes[tails[slot]].next = index;
+    }
+    tails[slot] = index;
+    occupied[slot / 64] |= uint64_t{1} << (slot % 64);
+  }
+
+  void unlink(uint32_t index) {
+    const Node& node = nodes[index];
+    (node.prev == NIL ? heads[node.slot] : nodes[node.prev].next) = node.next;
+    (node.next == NIL ? tails[node.slot] : nodes[node.next].prev) = node.prev;
+    if (heads[node.slot] == NIL) {
+      occupied[node.slot / 64] &= ~(uint64_t{1} << (node.slot % 64));
+    }
+  }
+
+  /// Detach the list of a slot
+  uint32_t take(uint32_t slot) {
+    const uint32_t head = heads[slot];
+    heads[slot] = NIL;
+    tails[slot] = NIL;
+    occupied[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    return head;
+  }
+
+  /**
+   * @brief Process tick next_tick: cascade higher levels on wrap-around, collect expired timers
+   */
+  void step() {
+    const auto index = static_cast<uint32_t>(next_tick & (ROOT_SLOTS - 1));
+    if (index == 0) {
+      for (uint32_t level = 1; level < LEVELS; ++level) {
+        const uint32_t shift = ROOT_BITS + ((level - 1) * LEVEL_BITS);
+        const auto slot = static_cast<uint32_t>((next_tick >> shift) & (LEVEL_SLOTS - 1));
+        for (uint32_t node = take(ROOT_SLOTS + ((level - 1) * LEVEL_SLOTS) + slot); node != NIL;) {
+          const uint32_t next = nodes[node].next;
+          link(node);
+          node = next;
+        }
+        if (slot != 0) {
+          break;
+        }
+      }
+    }
+
+    ++next_tick;
+    for (uint32_t node = take(index); node != NIL; node = nodes[node].next) {
+      nodes[node].state = NodeState::Due;
+      nodes[node].slot = NIL;
+      due.push_back(makeId(node, nodes[node].generation));
+    }
+  }
+
+  /**
+   * @brief Run callbacks of due timers, releasing the lock around each call
+   */
+  size_t fire(std::unique_lock<std::mutex>& lock) {
+    std::vector<TimerId> batch;
+    batch.swap(due);
+
+    size_t fired = 0;
+    for (const TimerId id : batch) {
+      Node* node = find(id);
+      if (node == nullptr || node->state != NodeState::Due) {
+        continue;  // Cancelled after expiring
+      }
+      TimerCallback callback = std::move(node->callback);
+      release(static_cast<uint32_t>(id));
+
+      running = id;
+      running_thread = std::this_thread::get_id();
+      lock.unlock();
+      callback();
+      lock.lock();
+      running = INVALID_TIMER;
+      callback_done.notify_all();
+      ++fired;
+    }
+
+    batch.clear();
+    if (due.empty()) {
+      due.swap(batch);  // Keep the capacity
+    }
+    return fired;
+  }
+
+  /**
+   * @brief Process ticks up to and including target, skipping ticks without timers
+   */
+  size_t runUntil(std::unique_lock<std::mutex>& lock, uint64_t target) {
+    size_t fired = 0;
+    while (next_tick <= target) {
+      const uint64_t next_event = pending == 0 ? target + 1 : nextEventTick();
+      if (next_event > target) {
+        next_tick = target + 1;
+        break;
+      }
+      next_tick = next_event;
+      step();
+      fired += fire(lock);
+    }
+    return fired;
+  }
+
+  /**
+   * @brief First tick that may fire or cascade timers
+   *
+   * Scans the occupied bitmaps: level 0 up to the next wrap-around and, once
+   * level 0 is empty, the next cascade of a non-empty slot on each higher
+   * level, so time advances over idle stretches in a few steps.
+   */
+  [[nodiscard]] uint64_t nextEventTick() const {
+    const auto index = static_cast<uint32_t>(next_tick & (ROOT_SLOTS - 1));
+    if (index == 0) {
+      return next_tick;  // Cascades run on this tick
+    }
+    for (uint32_t slot = index; slot < ROOT_SLOTS; slot = ((slot / 64) + 1) * 64) {
+      const uint64_t bits = occupied[slot / 64] >> (slot % 64);
+      if (bits != 0) {
+        return next_tick + (slot - index) + static_cast<uint32_t>(std::countr_zero(bits));
+      }
+    }
+
+    const bool root_empty = std::all_of(occupied.begin(), occupied.begin() + (ROOT_SLOTS / 64),
+                                        [](uint64_t bits) { return bits == 0; });
+    if (!root_empty) {
+      return (next_tick | (ROOT_SLOTS - 1)) + 1;
+    }
+
+    // Level n slot s cascades on the ticks that are multiples of its span and have s in the level's bits
+    uint64_t result = std::numeric_limits<uint64_t>::max();
+    for (uint32_t level = 1; level < LEVELS; ++level) {
+      const uint64_t bits = occupied[(ROOT_SLOTS / 64) + level - 1];
+      if (bits == 0) {
+        continue;
+      }
+      const uint32_t shift = ROOT_BITS + ((level - 1) * LEVEL_BITS);
+      const uint64_t block = (next_tick + (uint64_t{1} << shift) - 1) >> shift;
+      const auto first = static_cast<int>(block & (LEVEL_SLOTS - 1));
+      const auto distance = static_cast<uint64_t>(std::countr_zero(std::rotr(bits, first)));
+      result = std::min(result, (block + distance) << shift);
+    }
+    return result;
+  }
+
+  void threadLoop() {
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+      if (pending == 0) {
+        wakeup.wait(lock, [this] { return stopping || pending > 0; });
+        continue;
+      }
+
+      const uint64_t now = wallTick();
+      if (now >= next_tick) {
+        runUntil(lock, now);
+        continue;
+      }
+      // Capped so distant deadlines cannot overflow the clock
+      const uint64_t ahead = std::min<uint64_t>(nextEventTick() - now, MAX_SLEEP_TICKS);
+      wakeup.wait_until(lock, origin + (tick * static_cast<int64_t>(now + ahead)));
+    }
+  }
+};
+
+// ============================================================================
+// Constructors and destructor
+// ============================================================================
+
+TimerService::TimerService(std::chrono::milliseconds tick) {
+  if (tick.count() <= 0) {
+    throw StateException("TimerService tick must be positive");
+  }
+  impl_ = std::make_unique<Impl>(tick);
+}
+
+TimerService::~TimerService() { stop(); }
+
+// ============================================================================
+// Timers
+// ============================================================================
+
+TimerId TimerService::schedule(std::chrono::milliseconds delay, TimerCallback callback) {
+  const uint64_t ticks =
+      delay.count() <= 0 ? 1 : std::max<uint64_t>(1, (delay.count() + impl_->tick.count() - 1) / impl_->tick.count());
+
+  const std::scoped_lock lock(impl_->mutex);
+  uint64_t now = impl_->next_tick - 1;
+  if (impl_->thread_running) {
+    // The wheel time lags while the thread sleeps through empty ticks
+    now = std::max(now, impl_->wallTick());
+    if (impl_->pending == 0) {
+      impl_->next_tick = now + 1;
+    }
+  }
+
+  const uint32_t index = impl_->allocate();
+  Impl::Node& node = impl_->nodes[index];
+  node.expires = now + ticks;
+  node.state = Impl::NodeState::Armed;
+  node.callback = std::move(callback);
+  impl_->link(index);
+  ++impl_->pending;
+
+  if (impl_->thread_running) {
+    impl_->wakeup.notify_one();
+  }
+  return Impl::makeId(index, node.generation);
+}
+
+bool TimerService::cancel(TimerId id) {
+  std::unique_lock lock(impl_->mutex);
+  if (Impl::Node* node = impl_->find(id); node != nullptr && node->state != Impl::NodeState::Free) {
+    if (node->state == Impl::NodeState::Armed) {
+      impl_->unlink(static_cast<uint32_t>(id));
+    }
+    impl_->release(static_cast<uint32_t>(id));
+    return true;
+  }
+
+  if (id != INVALID_TIMER && impl_->running == id && impl_->running_thread != std::this_thread::get_id()) {
+    impl_->callback_done.wait(lock, [this, id] { return impl_->running != id; });
+  }
+  return false;
+}
+
+size_t TimerService::advance(std::chrono::milliseconds elapsed) {
+  std::unique_lock lock(impl_->mutex);
+  if (impl_->thread_running) {
+    throw StateException("TimerService::advance() requires the background thread to be stopped");
+  }
+
+  impl_->carry += std::max(elapsed, std::chrono::milliseconds(0));
+  const auto ticks = static_cast<uint64_t>(impl_->carry / impl_->tick);
+  impl_->carry %= impl_->tick;
+  return impl_->runUntil(lock, impl_->next_tick - 1 + ticks);
+}
+
+// ============================================================================
+// Background thread
+// ============================================================================
+
+void TimerService::start() {
+  const std::scoped_lock lock(impl_->mutex);
+  if (impl_->thread_running) {
+    return;
+  }
+  impl_->origin = Clock::now() - (impl_->tick * static_cast<int64_t>(impl_->next_tick - 1));
+  impl_->carry = std::chrono::milliseconds(0);
+  impl_->stopping = false;
+  impl_->thread_running = true;
+  impl_->thread = std::jthread([impl = impl_.get()] { impl->threadLoop(); });
+}
+
+void TimerService::stop() {
+  {
+    const std::scoped_lock lock(impl_->mutex);
+    if (!impl_->thread_running) {
+      return;
+    }
+    impl_->stopping = true;
+  }
+  impl_->wakeup.notify_all();
+  impl_->thread.join();
+
+  const std::scoped_lock lock(impl_->mutex);
+  impl_->thread_running = false;
+}
+
+bool TimerService::isRunning() const {
+  const std::scoped_lock lock(impl_->mutex);
+  return impl_->thread_running;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+size_t TimerService::getPendingCount() const {
+  const std::scoped_lock lock(impl_->mutex);
+  return impl_->pending;
+}
+
+std::chrono::milliseconds TimerService::getTick() const { return impl_->tick; }
+
+}  // namespace fsmconfig
@@ -0,0 +1,266 @@
+#include "fsmconfig/tracer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fsmconfig {
+
+namespace {
+
+/**
+ * @brief Record buffer owned by a single writer thread
+ *
+ * Only the owning thread writes records and advances count. Readers load
+ * count with acquire semantics and read the records published before it.
+ */
+struct ThreadBuffer {
+  explicit ThreadBuffer(size_t buffer_capacity, std::uint32_t thread_id)
+      : records(std::make_unique<TraceRecord[]>(buffer_capacity)), capacity(buffer_capacity), tid(thread_id) {}
+
+  std::unique_ptr<TraceRecord[]> records;  ///< Record storage
+  size_t capacity;                         ///< Number of record slots
+  std::atomic<size_t> count{0};            ///< Number of published records
+  std::uint32_t tid;                       ///< Sequential thread id used in the trace
+
+  // Owner thread only (and clear()). Spans nest and the buffer only fills up,
+  // so the kept spans are always the outermost open ones; each of them has a
+  // slot reserved for its END.
+  size_t open = 0;  ///< Spans begun and not yet ended
+  size_t kept = 0;  ///< Open spans whose BEGIN is in the buffer
+};
+
+/**
+ * @brief Process-wide tracer state
+ */
+struct TracerState {
+  std::atomic<bool> enabled{false};
+  std::atomic<size_t> buffer_capacity{Tracer::DEFAULT_BUFFER_CAPACITY};
+  std::atomic<size_t> dropped{0};
+  std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+  /// Registered buffers; kept alive after their threads exit so the trace stays complete
+  std::mutex buffers_mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::uint32_t next_tid = 1;
+};
+
+TracerState& tracerState() {
+  static TracerState state;
+  return state;
+}
+
+/**
+ * @brief Get the calling thread's buffer, creating and registering it on first use
+ * @param create false to return nullptr instead of creating the buffer
+ * @return Buffer, or nullptr if it could not be allocated (retried on the next record)
+ */
+ThreadBuffer* threadBuffer(bool create = true) noexcept {
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (buffer || !create) {
+    return buffer.get();
+  }
+
+  auto& state = tracerState();
+  try {
+    auto created = std::make_shared<ThreadBuffer>(state.buffer_capacity.load(std::memory_order_relaxed), 0);
+    const std::scoped_lock lock(state.buffers_mutex);
+    state.buffers.push_back(created);
+    created->tid = state.next_tid++;
+    buffer = std::move(created);
+  } catch (...) {
+    return nullptr;
+  }
+  return buffer.get();
+}
+
+void append(ThreadBuffer& buffer, size_t index, const char* name, TracePhase phase,
+            std::chrono::steady_clock::duration now) noexcept {
+  buffer.records[index] = TraceRecord{
+      name, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()), phase};
+  buffer.count.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Record a span begin
+ * @return true if the span was opened and its END must be recorded
+ */
+bool recordBegin(const char* name) noexcept {
+  auto& state = tracerState();
+  if (!state.enabled.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  const auto now = std::chrono::steady_clock::now() - state.epoch;
+  ThreadBuffer* buffer = threadBuffer();
+  if (buffer == nullptr) {
+    // The END is lost with the BEGIN
+    state.dropped.fetch_add(2, std::memory_order_relaxed);
+    return false;
+  }
+  const size_t index = buffer->count.load(std::memory_order_relaxed);
+
+  // Keep the span only if its END fits as well, next to the ENDs already reserved
+  ++buffer->open;
+  if (buffer->kept + 1 != buffer->open || index + buffer->kept + 2 > buffer->capacity) {
+    state.dropped.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  ++buffer->kept;
+  append(*buffer, index, name, TracePhase::BEGIN, now);
+  return true;
+}
+
+/**
+ * @brief Record a span end
+ *
+ * The END of an open span is recorded (or dropped with its BEGIN) whatever the
+ * enabled flag says now; an END without an open span only while enabled.
+ */
+void recordEnd(const char* name) noexcept {
+  auto& state = tracerState();
+  const bool enabled = state.enabled.load(std::memory_order_relaxed);
+  ThreadBuffer* buffer = threadBuffer(enabled);
+  if (buffer == nullptr || (buffer->open == 0 && !enabled)) {
+    if (enabled) {
+      state.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  const auto now = std::chrono::steady_clock::now() - state.epoch;
+  const size_t index = buffer->count.load(std::memory_order_relaxed);
+
+  // END of a dropped span is dropped too; an END without any open span is recorded if it fits
+  if (buffer->open > buffer->kept || (buffer->open == 0 && index >= buffer->capacity)) {
+    buffer->open -= buffer->open > 0 ? 1 : 0;
+    state.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (buffer->open > 0) {
+    --buffer->open;
+    --buffer->kept;
+  }
+  append(*buffer, index, name, TracePhase::END, now);
+}
+
+void writeJsonString(std::ostream& out, const char* text) {
+  out << '"';
+  for (const char* p = text; *p != '\0'; ++p) {
+    const char c = *p;
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xF] << "0123456789abcdef"[c & 0xF];
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+}  // namespace
+
+// ============================================================================
+// Recording control
+// ============================================================================
+
+void Tracer::enable() { tracerState().enabled.store(true, std::memory_order_relaxed); }
+
+void Tracer::disable() { tracerState().enabled.store(false, std::memory_order_relaxed); }
+
+bool Tracer::isEnabled() { return tracerState().enabled.load(std::memory_order_relaxed); }
+
+bool Tracer::beginSpan(const char* name) noexcept { return recordBegin(name); }
+
+void Tracer::endSpan(const char* name) noexcept { recordEnd(name); }
+
+void Tracer::setBufferCapacity(size_t records) {
+  tracerState().buffer_capacity.store(records, std::memory_order_relaxed);
+}
+
+void Tracer::clear() {
+  auto& state = tracerState();
+  const std::scoped_lock lock(state.buffers_mutex);
+  for (const auto& buffer : state.buffers) {
+    // Spans still open lost their BEGIN: their ENDs are dropped like those of spans that did not fit
+    buffer->kept = 0;
+    buffer->count.store(0, std::memory_order_release);
+  }
+  state.dropped.store(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+size_t Tracer::getRecordCount() {
+  auto& state = tracerState();
+  const std::scoped_lock lock(state.buffers_mutex);
+  size_t total = 0;
+  for (const auto& buffer : state.buffers) {
+    total += buffer->count.load(std::memory_order_acquire);
+  }
+  return total;
+}
+
+size_t Tracer::getDroppedCount() { return tracerState().dropped.load(std::memory_order_relaxed); }
+
+// ============================================================================
+// Chrome trace export
+// ============================================================================
+
+void Tracer::writeChromeTrace(std::ostream& out) {
+  auto& state = tracerState();
+  const std::scoped_lock lock(state.buffers_mutex);
+
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& buffer : state.buffers) {
+    const size_t count = buffer->count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+      const auto& rec = buffer->records[i];
+      if (!first) {
+        out << ',';
+      }
+      first = false;
+
+      // Chrome trace timestamps are microseconds; keep nanosecond precision as fraction
+      out << "{\"name\":";
+      writeJsonString(out, rec.name);
+      out << ",\"cat\":\"fsmconfig\",\"ph\":\"" << (rec.phase == TracePhase::BEGIN ? 'B' : 'E') << "\",\"ts\":"
+          << rec.timestamp_ns / 1000 << '.' << static_cast<char>('0' + (rec.timestamp_ns / 100) % 10)
+          << static_cast<char>('0' + (rec.timestamp_ns / 10) % 10) << static_cast<char>('0' + rec.timestamp_ns % 10)
+          << ",\"pid\":1,\"tid\":" << buffer->tid << '}';
+    }
+  }
+  out << "],\"displayTimeUnit\":\"ns\"}";
+}
+
+std::string Tracer::toChromeTrace() {
+  std::ostringstream out;
+  writeChromeTrace(out);
+  return out.str();
+}
+
+}  // namespace fsmconfig
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <fsmconfig/codegen.hpp>
+#include <fsmconfig/config_parser.hpp>
+#include <fsmconfig/types.hpp>
+
+#include "turnstile_fsm.hpp"
+
+using namespace fsmconfig;
+
+/**
+ * @file test_codegen.cpp
+ * @brief Tests for static state machine generation
+ */
+
+namespace {
+
+/// Handler for the generated turnstile machine, records hook calls
+struct TurnstileHandler {
+  std::vector<std::string> calls;
+  bool accept_coin = true;
+
+  void on_locked_enter() { calls.emplace_back("on_locked_enter"); }
+  void lock_arm() { calls.emplace_back("lock_arm"); }
+  void on_unlocked_enter() { calls.emplace_back("on_unlocked_enter"); }
+  void on_unlocked_exit() { calls.emplace_back("on_unlocked_exit"); }
+  void call_service() { calls.emplace_back("call_service"); }
+  bool coin_valid() {
+    calls.emplace_back("coin_valid");
+    return accept_coin;
+  }
+  void count_coin() { calls.emplace_back("count_coin"); }
+  void on_pass() { calls.emplace_back("on_pass"); }
+};
+
+}  // namespace
+
+// Compile-time properties of the generated header
+static_assert(turnstile::state_count == 3);
+static_assert(turnstile::event_count == 5);
+static_assert(turnstile::initial_state == turnstile::State::locked);
+static_assert(turnstile::transitions.size() == 5);
+static_assert(turnstile::transitions[0].from == turnstile::State::locked);
+static_assert(turnstile::transitions[0].event == turnstile::Event::coin);
+static_assert(turnstile::transitions[0].to == turnstile::State::unlocked);
+static_assert(turnstile::transitions[0].guarded);
+static_assert(turnstile::timeouts.size() == 2);
+static_assert(turnstile::timeouts[0].from == turnstile::State::unlocked);
+static_assert(turnstile::timeouts[0].to == turnstile::State::locked);
+static_assert(turnstile::timeouts[0].after_ms == 5000);
+static_assert(!turnstile::timeouts[0].guarded);
+static_assert(turnstile::transitions[4].event == turnstile::Event::reboot);
+static_assert(turnstile::timeouts[1].from == turnstile::State::broken);
+static_assert(turnstile::timeouts[1].after_ms == 60000);
+static_assert(turnstile::toString(turnstile::State::broken) == "broken");
+static_assert(turnstile::toString(turnstile::Event::repair) == "repair");
+
+TEST(CodegenTest, StartEntersInitialState) {
+  TurnstileHandler handler;
+  turnstile::Machine<TurnstileHandler> machine(handler);
+
+  machine.start();
+
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+  EXPECT_EQ(handler.calls, (std::vector<std::string>{"on_locked_enter", "lock_arm"}));
+}
+
+TEST(CodegenTest, DispatchRunsHooksInRuntimeOrder) {
+  TurnstileHandler handler;
+  turnstile::Machine<TurnstileHandler> machine(handler);
+  machine.start();
+  handler.calls.clear();
+
+  EXPECT_TRUE(machine.dispatch(turnstile::Event::coin));
+  EXPECT_EQ(machine.state(), turnstile::State::unlocked);
+  EXPECT_EQ(handler.calls, (std::vector<std::string>{"coin_valid", "count_coin", "on_unlocked_enter"}));
+
+  handler.calls.clear();
+  EXPECT_TRUE(machine.dispatch(turnstile::Event::push));
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+  EXPECT_EQ(handler.calls, (std::vector<std::string>{"on_unlocked_exit", "on_pass", "on_locked_enter", "lock_arm"}));
+}
+
+TEST(CodegenTest, GuardRejectsTransition) {
+  TurnstileHandler handler;
+  handler.accept_coin = false;
+  turnstile::Machine<TurnstileHandler> machine(handler);
+  machine.start();
+
+  EXPECT_FALSE(machine.dispatch(turnstile::Event::coin));
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+}
+
+TEST(CodegenTest, UnknownEventIsIgnored) {
+  TurnstileHandler handler;
+  turnstile::Machine<TurnstileHandler> machine(handler);
+  machine.start();
+
+  EXPECT_FALSE(machine.dispatch(turnstile::Event::push));
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+}
+
+TEST(CodegenTest, ExpireTakesTimeoutInSourceStateOnly) {
+  TurnstileHandler handler;
+  turnstile::Machine<TurnstileHandler> machine(handler);
+  machine.start();
+
+  EXPECT_FALSE(machine.expire(0));
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+
+  ASSERT_TRUE(machine.dispatch(turnstile::Event::coin));
+  handler.calls.clear();
+  EXPECT_TRUE(machine.expire(0));
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+  EXPECT_EQ(handler.calls, (std::vector<std::string>{"on_unlocked_exit", "on_locked_enter", "lock_arm"}));
+
+  EXPECT_FALSE(machine.expire(turnstile::timeouts.size()));
+}
+
+TEST(CodegenTest, TimeoutWithEventIsAlsoDispatched) {
+  TurnstileHandler handler;
+  turnstile::Machine<TurnstileHandler> machine(handler);
+  machine.start();
+
+  ASSERT_TRUE(machine.dispatch(turnstile::Event::kick));
+  EXPECT_TRUE(machine.dispatch(turnstile::Event::reboot));
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+
+  ASSERT_TRUE(machine.dispatch(turnstile::Event::kick));
+  EXPECT_TRUE(machine.expire(1));
+  EXPECT_EQ(machine.state(), turnstile::State::locked);
+}
+
+TEST(CodegenTest, GeneratesEnumsAndTable) {
+  ConfigParser parser;
+  parser.loadFromString(R"(
+states:
+  idle:
+  busy:
+transitions:
+  - from: idle
+    to: busy
+    event: go
+)");
+
+  CodegenOptions options;
+  options.namespace_name = "app::fsm";
+  const std::string header = generateStaticMachine(parser, options);
+
+  EXPECT_NE(header.find("namespace app::fsm {"), std::string::npos);
+  EXPECT_NE(header.find("enum class State : std::uint8_t"), std::string::npos);
+  EXPECT_NE(header.find("enum class Event : std::uint8_t"), std::string::npos);
+  EXPECT_NE(header.find("{State::idle, Event::go, State::busy, false}"), std::string::npos);
+  EXPECT_NE(header.find("inline constexpr State initial_state = State::idle;"), std::string::npos);
+}
+
+TEST(CodegenTest, TimeoutTransitionsGetOwnTable) {
+  ConfigParser parser;
+  parser.loadFromString(R"(
+states:
+  idle:
+  busy:
+transitions:
+  - from: idle
+    to: busy
+    event: go
+  - from: busy
+    to: idle
+    after: 250ms
+    guard: may_rest
+  - from: idle
+    to: idle
+    event: ping
+    after: 1s
+)");
+
+  const std::string header = generateStaticMachine(parser, CodegenOptions{});
+
+  // Timeouts without an event are not events; a timeout with an event is in both tables
+  EXPECT_EQ(header.find("after"), header.find("after_ms"));
+  EXPECT_NE(header.find("inline constexpr std::size_t event_count = 2;"), std::string::npos);
+  EXPECT_NE(header.find("std::array<Transition, 2> transitions"), std::string::npos);
+  EXPECT_NE(header.find("{State::idle, Event::ping, State::idle, false}"), std::string::npos);
+  EXPECT_NE(header.find("std::array<Timeout, 2> timeouts"), std::string::npos);
+  EXPECT_NE(header.find("{State::busy, State::idle, 250, true}"), std::string::npos);
+  EXPECT_NE(header.find("{State::idle, State::idle, 1000, false}"), std::string::npos);
+  EXPECT_NE(header.find("bool expire(std::size_t timeout)"), std::string::npos);
+  EXPECT_NE(header.find("if (!handler_.may_rest())"), std::string::npos);
+}
+
+TEST(CodegenTest, SanitizesIdentifiers) {
+  ConfigParser parser;
+  parser.loadFromString(R"(
+states:
+  "delete":
+  2nd-state:
+transitions:
+  - from: "delete"
+    to: 2nd-state
+    event: go.now
+)");
+
+  const std::string header = generateStaticMachine(parser, CodegenOptions{});
+
+  EXPECT_NE(header.find("delete_,"), std::string::npos);
+  EXPECT_NE(header.find("n2nd_state,"), std::string::npos);
+  EXPECT_NE(header.find("go_now,"), std::string::npos);
+  EXPECT_NE(header.find("\"2nd-state\""), std::string::npos);
+}
+
+TEST(CodegenTest, IdentifierCollisionThrows) {
+  ConfigParser parser;
+  parser.loadFromString(R"(
+states:
+  a-b:
+  a_b:
+)");
+
+  EXPECT_THROW(static_cast<void>(generateStaticMachine(parser, CodegenOptions{})), ConfigException);
+}
+
+TEST(CodegenTest, InvalidNamespaceThrows) {
+  ConfigParser parser;
+  parser.loadFromString(R"(
+states:
+  idle:
+)");
+
+  CodegenOptions options;
+  options.namespace_name = "bad-name";
+  EXPECT_THROW(static_cast<void>(generateStaticMachine(parser, options)), ConfigException);
+
+  options.namespace_name = "a::::b";
+  EXPECT_THROW(static_cast<void>(generateStaticMachine(parser, options)), ConfigException);
+}
+
+TEST(CodegenTest, EmptyConfigurationThrows) {
+  const ConfigParser parser;
+
+  EXPECT_THROW(static_cast<void>(generateStaticMachine(parser, CodegenOptions{})), ConfigException);
+}
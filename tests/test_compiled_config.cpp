@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <fsmconfig/compiled_config.hpp>
+#include <fsmconfig/config_parser.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_compiled_config.cpp
+ * @brief Tests for CompiledConfig
+ */
+
+namespace {
+
+const char* const kConfig = R"(
+variables:
+  retries: 3
+  name: "door"
+  ratio: 0.5
+
+states:
+  closed:
+    on_enter: on_closed
+    actions:
+      - lock
+      - log
+  open:
+    on_exit: on_leave
+    variables:
+      timeout: 10
+      auto_close: true
+    actions:
+      - log
+  broken:
+
+transitions:
+  - from: closed
+    to: open
+    event: push
+    guard: can_open
+    actions:
+      - log
+  - from: open
+    to: closed
+    event: pull
+    on_transition: on_close
+  - from: closed
+    to: broken
+    event: kick
+  - from: open
+    to: broken
+    event: kick
+)";
+
+}  // namespace
+
+TEST(CompiledConfigTest, EmptyByDefault) {
+  const ConfigParser parser;
+  const CompiledConfig& config = parser.getCompiledConfig();
+
+  EXPECT_TRUE(config.states().empty());
+  EXPECT_TRUE(config.transitions().empty());
+  EXPECT_EQ(config.eventCount(), 0);
+  EXPECT_EQ(config.initialState(), INVALID_ID);
+  EXPECT_EQ(config.findState("anything"), INVALID_ID);
+  EXPECT_EQ(config.findTransition(0, 0), nullptr);
+}
+
+TEST(CompiledConfigTest, NamesAreInternedOnce) {
+  ConfigParser parser;
+  parser.loadFromString(kConfig);
+  const CompiledConfig& config = parser.getCompiledConfig();
+
+  const auto closed = config.states()[config.findState("closed")];
+  const auto open = config.states()[config.findState("open")];
+  ASSERT_EQ(closed.actions.size(), 2);
+  ASSERT_EQ(open.actions.size(), 1);
+  EXPECT_EQ(closed.actions[1], open.actions[0]);
+  EXPECT_EQ(config.str(open.actions[0]), "log");
+  EXPECT_EQ(config.str(INVALID_ID), "");
+  EXPECT_GT(config.arenaBytes(), 0);
+}
+
+TEST(CompiledConfigTest, StatesAndEventsAreNumbered) {
+  ConfigParser parser;
+  parser.loadFromString(kConfig);
+  const CompiledConfig& config = parser.getCompiledConfig();
+
+  ASSERT_EQ(config.states().size(), 3);
+  EXPECT_EQ(config.stateName(0), "closed");
+  EXPECT_EQ(config.stateName(1), "open");
+  EXPECT_EQ(config.stateName(2), "broken");
+  EXPECT_EQ(config.initialState(), 0);
+  EXPECT_EQ(config.initialStateName(), "closed");
+
+  ASSERT_EQ(config.eventCount(), 3);
+  EXPECT_EQ(config.eventName(0), "push");
+  EXPECT_EQ(config.eventName(1), "pull");
+  EXPECT_EQ(config.eventName(2), "kick");
+  EXPECT_EQ(config.findEvent("kick"), 2);
+  EXPECT_EQ(config.findEvent("missing"), INVALID_ID);
+}
+
+TEST(CompiledConfigTest, FindTransitionById) {
+  ConfigParser parser;
+  parser.loadFromString(kConfig);
+  const CompiledConfig& config = parser.getCompiledConfig();
+
+  const StateId closed = config.findState("closed");
+  const StateId open = config.findState("open");
+
+  const CompiledTransition* push = config.findTransition(closed, config.findEvent("push"));
+  ASSERT_NE(push, nullptr);
+  EXPECT_EQ(push->to, open);
+  EXPECT_EQ(config.str(push->guard), "can_open");
+  EXPECT_EQ(push->on_transition, INVALID_ID);
+  ASSERT_EQ(push->actions.size(), 1);
+
+  const CompiledTransition* kick = config.findTransition(open, config.findEvent("kick"));
+  ASSERT_NE(kick, nullptr);
+  EXPECT_EQ(config.stateName(kick->to), "broken");
+
+  EXPECT_EQ(config.findTransition(open, config.findEvent("push")), nullptr);
+  EXPECT_EQ(config.findTransition(INVALID_ID, 0), nullptr);
+
+  const auto from_closed = config.transitionsFrom(closed);
+  ASSERT_EQ(from_closed.size(), 2);
+  EXPECT_EQ(config.transitions()[from_closed[0]].event, config.findEvent("push"));
+  EXPECT_EQ(config.transitions()[from_closed[1]].event, config.findEvent("kick"));
+}
+
+TEST(CompiledConfigTest, VariablesAreTypedAndSorted) {
+  ConfigParser parser;
+  parser.loadFromString(kConfig);
+  const CompiledConfig& config = parser.getCompiledConfig();
+
+  const auto globals = config.globalVariables();
+  ASSERT_EQ(globals.size(), 3);
+  EXPECT_EQ(config.str(globals[0].name), "name");
+  EXPECT_EQ(config.value(globals[0]).asString(), "door");
+  EXPECT_EQ(config.str(globals[1].name), "ratio");
+  EXPECT_FLOAT_EQ(config.value(globals[1]).asFloat(), 0.5F);
+  EXPECT_EQ(config.value(globals[2]).asInt(), 3);
+
+  const auto open_vars = config.states()[config.findState("open")].variables;
+  ASSERT_EQ(open_vars.size(), 2);
+  EXPECT_EQ(config.str(open_vars[0].name), "auto_close");
+  EXPECT_TRUE(config.value(open_vars[0]).asBool());
+}
+
+TEST(CompiledConfigTest, ExplicitInitialState) {
+  ConfigParser parser;
+  parser.loadFromString(R"(
+initial_state: b
+states:
+  a:
+  b:
+)");
+
+  EXPECT_EQ(parser.getCompiledConfig().initialState(), 1);
+  EXPECT_EQ(parser.getInitialState(), "b");
+}
+
+TEST(CompiledConfigTest, LegacyViewsMatchCompiledModel) {
+  ConfigParser parser;
+  parser.loadFromString(kConfig);
+
+  const auto& states = parser.getStates();
+  ASSERT_EQ(states.size(), 3);
+  EXPECT_EQ(states.at("closed").on_enter_callback, "on_closed");
+  EXPECT_EQ(states.at("closed").actions, (std::vector<std::string>{"lock", "log"}));
+  EXPECT_EQ(states.at("open").variables.at("timeout").asInt(), 10);
+
+  const auto& transitions = parser.getTransitions();
+  ASSERT_EQ(transitions.size(), 4);
+  EXPECT_EQ(transitions[1].transition_callback, "on_close");
+
+  const TransitionInfo* found = parser.findTransition("closed", "push");
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found, &transitions[0]);
+  EXPECT_EQ(parser.findTransition("broken", "push"), nullptr);
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fsmconfig/config_parser.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_config_cache.cpp
+ * @brief Tests for the on-disk cache of compiled configurations
+ */
+
+namespace {
+
+const char* const kConfig = R"(
+variables:
+  retries: 3
+  label: "door"
+  ratio: 0.25
+  enabled: true
+
+initial_state: closed
+
+states:
+  open:
+    on_exit: on_leave
+    variables:
+      timeout: 10
+    actions:
+      - log
+  closed:
+    on_enter: on_closed
+    actions:
+      - lock
+      - log
+
+transitions:
+  - from: closed
+    to: open
+    event: push
+    guard: can_open
+    actions:
+      - log
+  - from: open
+    to: closed
+    event: pull
+    on_transition: on_close
+  - from: open
+    to: closed
+    after: 30s
+
+events:
+  push:
+    coalesce: true
+    key: source
+)";
+
+}  // namespace
+
+class ConfigCacheTest : public ::testing::Test {
+ protected:
+  std::filesystem::path directory;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+
+  void SetUp() override {
+    directory = std::filesystem::temp_directory_path() / "fsmconfig_config_cache_test";
+    std::filesystem::remove_all(directory);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  std::vector<std::filesystem::path> images() const {
+    std::vector<std::filesystem::path> result;
+    if (std::filesystem::exists(directory)) {
+      for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        result.push_back(entry.path());
+      }
+    }
+    return result;
+  }
+
+  ConfigParser makeParser() const {
+    ConfigParser parser;
+    parser.setCacheDirectory(directory.string());
+    return parser;
+  }
+};
+
+TEST_F(ConfigCacheTest, DisabledByDefault) {
+  ConfigParser parser;
+  parser.loadFromString(kConfig);
+
+  EXPECT_EQ(parser.getCacheDirectory(), "");
+  EXPECT_TRUE(images().empty());
+}
+
+TEST_F(ConfigCacheTest, MissWritesImage) {
+  ConfigParser parser = makeParser();
+  parser.loadFromString(kConfig);
+
+  ASSERT_EQ(images().size(), 1);
+  EXPECT_EQ(images().front().extension(), ".fsmc");
+  EXPECT_EQ(parser.getInitialState(), "closed");
+}
+
+TEST_F(ConfigCacheTest, HitMatchesParsedConfig) {
+  ConfigParser parsed;
+  parsed.loadFromString(kConfig);
+  makeParser().loadFromString(kConfig);
+
+  ConfigParser cached = makeParser();
+  cached.loadFromString(kConfig);
+
+  const CompiledConfig& expected = parsed.getCompiledConfig();
+  const CompiledConfig& actual = cached.getCompiledConfig();
+  ASSERT_EQ(actual.states().size(), expected.states().size());
+  for (StateId id = 0; id < expected.states().size(); ++id) {
+    EXPECT_EQ(actual.stateName(id), expected.stateName(id));
+  }
+  ASSERT_EQ(actual.eventCount(), expected.eventCount());
+  EXPECT_EQ(actual.eventName(0), "push");
+  EXPECT_EQ(actual.initialStateName(), "closed");
+
+  const auto& globals = cached.getGlobalVariables();
+  ASSERT_EQ(globals.size(), 4);
+  EXPECT_EQ(globals.at("retries").asInt(), 3);
+  EXPECT_EQ(globals.at("label").asString(), "door");
+  EXPECT_FLOAT_EQ(globals.at("ratio").asFloat(), 0.25F);
+  EXPECT_TRUE(globals.at("enabled").asBool());
+  EXPECT_EQ(cached.getState("closed").actions, parsed.getState("closed").actions);
+  EXPECT_EQ(cached.getState("closed").on_enter_callback, "on_closed");
+  EXPECT_EQ(cached.getState("open").on_exit_callback, "on_leave");
+  EXPECT_EQ(cached.getState("open").on_enter_callback, "");
+  EXPECT_EQ(cached.getState("open").variables.at("timeout").asInt(), 10);
+
+  const TransitionInfo* push = cached.findTransition("closed", "push");
+  ASSERT_NE(push, nullptr);
+  EXPECT_EQ(push->guard_callback, "can_open");
+  EXPECT_EQ(push->transition_callback, "");
+  EXPECT_EQ(push->actions, std::vector<std::string>{"log"});
+  EXPECT_EQ(cached.findTransition("open", "pull")->transition_callback, "on_close");
+  EXPECT_EQ(cached.findTransition("open", "pull")->after_ms, 0);
+  EXPECT_EQ(cached.findTransition("open", "after 30s")->after_ms, 30000);
+
+  const auto rules = cached.getCompiledConfig().coalescedEvents();
+  ASSERT_EQ(rules.size(), 1);
+  EXPECT_EQ(cached.getCompiledConfig().str(rules[0].event), "push");
+  EXPECT_EQ(cached.getCompiledConfig().str(rules[0].key), "source");
+}
+
+TEST_F(ConfigCacheTest, HitDoesNotRewriteImage) {
+  makeParser().loadFromString(kConfig);
+  ASSERT_EQ(images().size(), 1);
+  const auto image = images().front();
+  const auto stamp = std::filesystem::last_write_time(image) - std::chrono::hours(1);
+  std::filesystem::last_write_time(image, stamp);
+
+  makeParser().loadFromString(kConfig);
+
+  EXPECT_EQ(std::filesystem::last_write_time(image), stamp);
+}
+
+TEST_F(ConfigCacheTest, ImageOfOtherSourceIsRejected) {
+  makeParser().loadFromString(kConfig);
+  ASSERT_EQ(images().size(), 1);
+  const auto image = images().front();
+  const auto other_image = directory / "other.fsmc";
+  ConfigParser other = makeParser();
+  other.loadFromString("states:\n  other:\n");
+  for (const auto& path : images()) {
+    if (path != image) {
+      std::filesystem::rename(path, other_image);
+    }
+  }
+
+  // An image stored under the wrong key is detected by its recorded source
+  std::filesystem::copy_file(other_image, image, std::filesystem::copy_options::overwrite_existing);
+  ConfigParser parser = makeParser();
+  parser.loadFromString(kConfig);
+
+  EXPECT_TRUE(parser.hasState("closed"));
+  EXPECT_FALSE(parser.hasState("other"));
+}
+
+TEST_F(ConfigCacheTest, DamagedImageFallsBackToParsing) {
+  makeParser().loadFromString(kConfig);
+  ASSERT_EQ(images().size(), 1);
+  const auto image = images().front();
+  const auto size = std::filesystem::file_size(image);
+  std::filesystem::resize_file(image, size / 2);
+
+  ConfigParser parser = makeParser();
+  parser.loadFromString(kConfig);
+
+  EXPECT_TRUE(parser.hasState("open"));
+  EXPECT_EQ(std::filesystem::file_size(image), size);
+}
+
+TEST_F(ConfigCacheTest, ChangedContentGetsNewImage) {
+  makeParser().loadFromString(kConfig);
+  makeParser().loadFromString(std::string(kConfig) + "\n# comment\n");
+
+  EXPECT_EQ(images().size(), 2);
+}
+
+TEST_F(ConfigCacheTest, LoadFromFileUsesCache) {
+  std::filesystem::create_directories(directory);
+  const auto path = directory / "machine.yaml";
+  {
+    std::ofstream file(path);
+    file << kConfig;
+  }
+
+  makeParser().loadFromFile(path.string());
+  ConfigParser parser = makeParser();
+  parser.loadFromFile(path.string());
+
+  EXPECT_EQ(images().size(), 2);  // the YAML file and one image
+  EXPECT_EQ(parser.getInitialState(), "closed");
+  EXPECT_THROW(parser.loadFromFile((directory / "missing.yaml").string()), ConfigException);
+}
+
+TEST_F(ConfigCacheTest, InvalidConfigIsNotCached) {
+  ConfigParser parser = makeParser();
+
+  EXPECT_THROW(parser.loadFromString("states:\n  a:\ntransitions:\n  - from: a\n    to: b\n    event: go\n"),
+               ConfigException);
+  EXPECT_TRUE(images().empty());
+}
@@ -7,8 +7,14 @@
 #include <fsmconfig/types.hpp>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#endif
+
 using namespace fsmconfig;
 
 /**
@@ -324,6 +330,163 @@ transitions:
   EXPECT_THROW(parser->loadFromFile(test_config_path), ConfigException);
 }
 
+TEST_F(ConfigParserTest, ValidationReportsAllErrors) {
+  const std::string invalid_yaml = R"(
+states:
+  state1:
+  state2:
+
+transitions:
+  - from: state1
+    to: state2
+    event: event1
+  - from: state1
+    to: state3
+    event: event2
+  - from: state4
+    to: state1
+    event: event1
+  - from: state1
+    to: state1
+    event: event1
+)";
+
+  try {
+    parser->loadFromString(invalid_yaml);
+    FAIL() << "Expected ConfigException";
+  } catch (const ConfigException& e) {
+    const std::string message = e.what();
+    EXPECT_NE(message.find("3 configuration errors"), std::string::npos);
+    EXPECT_NE(message.find("target state: 'state3'"), std::string::npos);
+    EXPECT_NE(message.find("source state: 'state4'"), std::string::npos);
+    EXPECT_NE(message.find("Duplicate transition from state 'state1' with event 'event1'"), std::string::npos);
+  }
+  EXPECT_TRUE(parser->getStates().empty());
+}
+
+TEST_F(ConfigParserTest, FieldsInAnyOrder) {
+  const std::string yaml_content = R"(
+transitions:
+  - actions: [log]
+    event: go
+    guard: ready
+    to: b
+    from: a
+initial_state: b
+states:
+  a:
+    actions: [enter_a]
+    on_enter: on_a
+  b:
+variables: {count: 2}
+)";
+
+  parser->loadFromString(yaml_content);
+
+  EXPECT_EQ(parser->getInitialState(), "b");
+  EXPECT_EQ(parser->getState("a").on_enter_callback, "on_a");
+  EXPECT_EQ(parser->getGlobalVariables().at("count").asInt(), 2);
+  const TransitionInfo* go = parser->findTransition("a", "go");
+  ASSERT_NE(go, nullptr);
+  EXPECT_EQ(go->guard_callback, "ready");
+  EXPECT_EQ(go->actions, std::vector<std::string>{"log"});
+}
+
+TEST_F(ConfigParserTest, DuplicateFieldsUseFirstOccurrence) {
+  const std::string yaml_content = R"(
+states:
+  a:
+    on_enter: first
+    on_enter: second
+    actions: [one]
+    actions: [two]
+  b:
+states:
+  ignored:
+transitions:
+  - from: a
+    to: b
+    event: go
+    guard: first
+    guard: second
+)";
+
+  parser->loadFromString(yaml_content);
+
+  EXPECT_FALSE(parser->hasState("ignored"));
+  EXPECT_EQ(parser->getState("a").on_enter_callback, "first");
+  EXPECT_EQ(parser->getState("a").actions, std::vector<std::string>{"one"});
+  EXPECT_EQ(parser->findTransition("a", "go")->guard_callback, "first");
+}
+
+TEST_F(ConfigParserTest, AnchorsAndAliases) {
+  const std::string yaml_content = R"(
+common_actions: &common
+  - log
+  - notify
+
+states:
+  a:
+    actions: *common
+  b:
+    actions: *common
+
+transitions:
+  - from: a
+    to: b
+    event: go
+    actions: *common
+)";
+
+  parser->loadFromString(yaml_content);
+
+  const std::vector<std::string> expected{"log", "notify"};
+  EXPECT_EQ(parser->getState("a").actions, expected);
+  EXPECT_EQ(parser->getState("b").actions, expected);
+  EXPECT_EQ(parser->findTransition("a", "go")->actions, expected);
+}
+
+TEST_F(ConfigParserTest, LoadFromBuffer) {
+  // The view covers only the first document; the trailing bytes are not YAML
+  const std::string storage = "states:\n  a:\n  b:\ninitial_state: b\n\x01garbage";
+  const std::string_view yaml_content(storage.data(), storage.find('\x01'));
+
+  parser->loadFromBuffer(yaml_content);
+
+  EXPECT_TRUE(parser->hasState("a"));
+  EXPECT_EQ(parser->getInitialState(), "b");
+}
+
+TEST_F(ConfigParserTest, LoadEmptyFile) {
+  writeTestConfig("");
+
+  parser->loadFromFile(test_config_path);
+
+  EXPECT_TRUE(parser->getStates().empty());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(ConfigParserTest, LoadFromPipe) {
+  const auto fifo_path = std::filesystem::temp_directory_path() / "fsmconfig_parser_test.fifo";
+  std::filesystem::remove(fifo_path);
+  ASSERT_EQ(::mkfifo(fifo_path.c_str(), 0600), 0);
+
+  std::thread writer([&fifo_path] {
+    std::ofstream fifo(fifo_path);
+    fifo << "states:\n";
+    for (int i = 0; i < 5000; ++i) {
+      fifo << "  state" << i << ":\n";
+    }
+  });
+  parser->loadFromFile(fifo_path.string());
+  writer.join();
+  std::filesystem::remove(fifo_path);
+
+  EXPECT_EQ(parser->getStates().size(), 5000);
+  EXPECT_TRUE(parser->hasState("state4999"));
+}
+#endif
+
 TEST_F(ConfigParserTest, EmptyConfig) {
 const   std::string yaml_content = R"(
 )";
@@ -673,6 +836,97 @@ transitions:
   EXPECT_EQ(transitions[0].actions.size(), 4);
 }
 
+TEST_F(ConfigParserTest, ParseTimedTransitions) {
+  const std::string yaml_content = R"(
+states:
+  idle:
+  busy:
+
+transitions:
+  - from: idle
+    to: busy
+    event: start
+    after: 2m
+  - from: busy
+    to: idle
+    after: 1500ms
+)";
+
+  parser->loadFromString(yaml_content);
+
+  const TransitionInfo* start = parser->findTransition("idle", "start");
+  ASSERT_NE(start, nullptr);
+  EXPECT_EQ(start->after_ms, 120000);
+
+  // Without 'event' the transition is named after its timeout
+  const TransitionInfo* timeout = parser->findTransition("busy", "after 1500ms");
+  ASSERT_NE(timeout, nullptr);
+  EXPECT_EQ(timeout->to_state, "idle");
+  EXPECT_EQ(timeout->after_ms, 1500);
+}
+
+TEST_F(ConfigParserTest, InvalidTimeoutThrowsException) {
+  for (const char* const after : {"soon", "0s", "5", "-1s", "3 days", "99999999999999999999ms"}) {
+    const std::string yaml_content = std::string(R"(
+states:
+  idle:
+  busy:
+
+transitions:
+  - from: idle
+    to: busy
+    after: )") + after + "\n";
+
+    EXPECT_THROW(parser->loadFromString(yaml_content), ConfigException) << after;
+  }
+}
+
+TEST_F(ConfigParserTest, ParseEventCoalescing) {
+  // "yes" is only understood by the node tree, so both loaders are covered
+  for (const char* const enabled : {"true", "yes"}) {
+    const std::string yaml_content = std::string(R"(
+states:
+  idle:
+
+events:
+  heartbeat:
+    coalesce: )") + enabled + R"(
+  progress:
+    coalesce: true
+    key: job_id
+  reset:
+    coalesce: false
+  ping:
+)";
+
+    parser->loadFromString(yaml_content);
+
+    const CompiledConfig& config = parser->getCompiledConfig();
+    const auto rules = config.coalescedEvents();
+    ASSERT_EQ(rules.size(), 2) << enabled;
+    EXPECT_EQ(config.str(rules[0].event), "heartbeat");
+    EXPECT_EQ(rules[0].key, INVALID_ID);
+    EXPECT_EQ(config.str(rules[1].event), "progress");
+    EXPECT_EQ(config.str(rules[1].key), "job_id");
+  }
+}
+
+TEST_F(ConfigParserTest, InvalidEventOptionsThrowException) {
+  for (const char* const options : {"coalesce: maybe", "key: job_id", "coalesce: true\n    key: [a, b]"}) {
+    const std::string yaml_content = std::string(R"(
+states:
+  idle:
+
+events:
+  progress:
+    )") + options + "\n";
+
+    EXPECT_THROW(parser->loadFromString(yaml_content), ConfigException) << options;
+  }
+
+  EXPECT_THROW(parser->loadFromString("states:\n  idle:\nevents:\n  - progress\n"), ConfigException);
+}
+
 TEST_F(ConfigParserTest, ParseStateWithoutOptionalFields) {
 const   std::string yaml_content = R"(
 states:
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fsmconfig/config_watcher.hpp>
+#include <fsmconfig/machine_definition.hpp>
+#include <fsmconfig/state_machine.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_config_watcher.cpp
+ * @brief Tests for ConfigWatcher
+ */
+
+namespace {
+
+const char* const kTwoStates = R"(
+states:
+  idle:
+  running:
+
+transitions:
+  - from: idle
+    to: running
+    event: start
+)";
+
+const char* const kThreeStates = R"(
+states:
+  idle:
+  running:
+  done:
+
+transitions:
+  - from: idle
+    to: running
+    event: start
+  - from: running
+    to: done
+    event: finish
+)";
+
+/// Poll condition until it holds or timeout expires
+bool waitUntil(const std::function<bool()>& condition,
+               std::chrono::milliseconds timeout = std::chrono::milliseconds(3000)) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (condition()) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return condition();
+}
+
+}  // namespace
+
+class ConfigWatcherTest : public ::testing::Test {
+ protected:
+  std::filesystem::path config_path;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+  ConfigWatcherOptions options;       // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+
+  void SetUp() override {
+    config_path = std::filesystem::temp_directory_path() / "fsmconfig_config_watcher_test.yaml";
+    writeConfig(kTwoStates);
+    options.debounce = std::chrono::milliseconds(20);
+    options.poll_interval = std::chrono::milliseconds(10);
+  }
+
+  void TearDown() override { std::remove(config_path.string().c_str()); }
+
+  void writeConfig(const std::string& content) const {
+    std::ofstream file(config_path);
+    file << content;
+  }
+};
+
+TEST_F(ConfigWatcherTest, ReloadsAfterChange) {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<const MachineDefinition>> loaded;
+  ConfigWatcher watcher(
+      config_path.string(),
+      [&](std::shared_ptr<const MachineDefinition> definition) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        loaded.push_back(std::move(definition));
+      },
+      options);
+  watcher.start();
+  EXPECT_TRUE(watcher.isRunning());
+
+  writeConfig(kThreeStates);
+
+  ASSERT_TRUE(waitUntil([&] { return watcher.getReloadCount() == 1; }));
+  watcher.stop();
+  EXPECT_FALSE(watcher.isRunning());
+  ASSERT_EQ(loaded.size(), 1);
+  EXPECT_TRUE(loaded.front()->hasState("done"));
+}
+
+TEST_F(ConfigWatcherTest, DebouncesWriteBursts) {
+  options.debounce = std::chrono::milliseconds(200);
+  std::atomic<int> calls{0};
+  ConfigWatcher watcher(
+      config_path.string(), [&](const std::shared_ptr<const MachineDefinition>& /*definition*/) { ++calls; }, options);
+  watcher.start();
+
+  for (int i = 0; i < 5; ++i) {
+    writeConfig(i % 2 == 0 ? kThreeStates : kTwoStates);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  ASSERT_TRUE(waitUntil([&] { return calls.load() > 0; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(calls.load(), 1);
+}
+
+TEST_F(ConfigWatcherTest, RejectedReloadIsReported) {
+  std::atomic<int> calls{0};
+  std::mutex mutex;
+  std::string reported;
+  ConfigWatcher watcher(
+      config_path.string(), [&](const std::shared_ptr<const MachineDefinition>& /*definition*/) { ++calls; }, options);
+  watcher.setErrorHandler([&](const std::string& error) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    reported = error;
+  });
+  watcher.start();
+
+  writeConfig("states: [");
+
+  ASSERT_TRUE(waitUntil([&] { return watcher.getRejectedCount() == 1; }));
+  watcher.stop();
+  EXPECT_EQ(calls.load(), 0);
+  EXPECT_NE(reported.find("Config reload rejected"), std::string::npos);
+}
+
+TEST_F(ConfigWatcherTest, StateMachineAdoptsReloadAtNextEvent) {
+  StateMachine fsm(config_path.string());
+  fsm.start();
+  fsm.triggerEvent("start");
+
+  ConfigWatcher watcher(config_path.string(), fsm, options);
+  watcher.start();
+  writeConfig(kThreeStates);
+  ASSERT_TRUE(waitUntil([&] { return watcher.getReloadCount() == 1; }));
+  watcher.stop();
+
+  fsm.triggerEvent("finish");
+  EXPECT_EQ(fsm.getCurrentState(), "done");
+}
+
+TEST_F(ConfigWatcherTest, StartTwiceThrows) {
+  ConfigWatcher watcher(config_path.string(), [](const std::shared_ptr<const MachineDefinition>& /*definition*/) {},
+                        options);
+  watcher.start();
+
+  EXPECT_THROW(watcher.start(), ConfigException);
+  watcher.stop();
+  watcher.stop();  // Stopping a stopped watcher is a no-op
+}
+
+TEST_F(ConfigWatcherTest, MissingDirectoryThrows) {
+  ConfigWatcher watcher("/nonexistent-fsmconfig-dir/config.yaml",
+                        [](const std::shared_ptr<const MachineDefinition>& /*definition*/) {}, options);
+
+#ifdef __linux__
+  EXPECT_THROW(watcher.start(), ConfigException);
+#else
+  EXPECT_NO_THROW(watcher.start());
+#endif
+}
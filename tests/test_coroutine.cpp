@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fsmconfig/coroutine.hpp>
+#include <fsmconfig/state_machine.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_coroutine.cpp
+ * @brief Tests for the coroutine awaitables of StateMachine
+ */
+
+namespace {
+
+const char* const kConnectionConfig = R"(
+initial_state: idle
+
+states:
+  idle:
+  connecting:
+  connected:
+  error:
+
+transitions:
+  - from: idle
+    to: connecting
+    event: connect
+  - from: connecting
+    to: connected
+    event: ok
+  - from: connecting
+    to: error
+    event: fail
+  - from: connected
+    to: idle
+    event: disconnect
+  - from: idle
+    to: connected
+    event: toggle
+  - from: connected
+    to: idle
+    event: toggle
+)";
+
+/**
+ * @brief Minimal eagerly started, detached coroutine
+ */
+struct Flow {
+  struct promise_type {
+    Flow get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+Flow waitForState(StateMachine& machine, std::vector<std::string> states, std::string& result) {
+  result = co_await machine.untilState(std::move(states));
+}
+
+}  // namespace
+
+TEST(CoroutineTest, UntilStateResumesAfterTransition) {
+  StateMachine machine(kConnectionConfig, true);
+  machine.start();
+
+  std::string entered;
+  waitForState(machine, {"connected"}, entered);
+  EXPECT_TRUE(entered.empty());
+
+  machine.triggerEvent("connect");
+  EXPECT_TRUE(entered.empty());
+  machine.triggerEvent("ok");
+  EXPECT_EQ(entered, "connected");
+}
+
+TEST(CoroutineTest, UntilStateCompletesImmediatelyInState) {
+  StateMachine machine(kConnectionConfig, true);
+  machine.start();
+
+  std::string entered;
+  waitForState(machine, {"idle"}, entered);
+  EXPECT_EQ(entered, "idle");
+}
+
+TEST(CoroutineTest, UntilAnyOfSeveralStates) {
+  StateMachine machine(kConnectionConfig, true);
+
+  // Waiting before start() completes on the initial state
+  std::string initial;
+  waitForState(machine, {"idle"}, initial);
+  EXPECT_TRUE(initial.empty());
+  machine.start();
+  EXPECT_EQ(initial, "idle");
+
+  std::string outcome;
+  waitForState(machine, {"connected", "error"}, outcome);
+  machine.triggerEvent("connect");
+  machine.triggerEvent("fail");
+  EXPECT_EQ(outcome, "error");
+}
+
+TEST(CoroutineTest, PostEventYieldsStateAndChains) {
+  StateMachine machine(kConnectionConfig, true);
+  machine.start();
+
+  std::vector<std::string> steps;
+  auto flow = [&]() -> Flow {
+    std::vector<std::string> outcomes{"connected", "error"};
+    steps.push_back(co_await machine.postEvent("connect"));
+    steps.push_back(co_await machine.untilState(std::move(outcomes)));
+    steps.push_back(co_await machine.postEvent("disconnect"));
+  };
+  flow();
+  ASSERT_EQ(steps.size(), 1U);
+  EXPECT_EQ(steps[0], "connecting");
+
+  machine.triggerEvent("ok");
+  EXPECT_EQ(steps, (std::vector<std::string>{"connecting", "connected", "idle"}));
+}
+
+TEST(CoroutineTest, PostEventPropagatesErrors) {
+  StateMachine machine(kConnectionConfig, true);
+
+  bool caught = false;
+  auto flow = [&]() -> Flow {
+    try {
+      co_await machine.postEvent("connect");
+    } catch (const StateException&) {
+      caught = true;
+    }
+  };
+  flow();
+  EXPECT_TRUE(caught);
+}
+
+TEST(CoroutineTest, StrandModeResumesFlowsAcrossThreads) {
+  StateMachine machine(kConnectionConfig, true);
+  machine.setStrandMode(true);
+  machine.start();
+
+  constexpr int kWaiters = 1000;
+  std::atomic<int> resumed{0};
+  auto waiter = [&]() -> Flow {
+    co_await machine.untilState("connected");
+    resumed.fetch_add(1);
+  };
+  for (int i = 0; i < kWaiters; ++i) {
+    waiter();
+  }
+  EXPECT_EQ(resumed.load(), 0);
+
+  constexpr int kThreads = 4;
+  constexpr int kPostsPerThread = 500;
+  std::atomic<int> completed{0};
+  auto poster = [&]() -> Flow {
+    co_await machine.postEvent("toggle");
+    completed.fetch_add(1);
+  };
+  {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&poster] {
+        for (int i = 0; i < kPostsPerThread; ++i) {
+          poster();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  EXPECT_EQ(completed.load(), kThreads * kPostsPerThread);
+  EXPECT_EQ(resumed.load(), kWaiters);
+  EXPECT_EQ(machine.getCurrentState(), "idle");
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fsmconfig/definition_cache.hpp>
+#include <fsmconfig/machine_definition.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_definition_cache.cpp
+ * @brief Tests for DefinitionCache
+ */
+
+class DefinitionCacheTest : public ::testing::Test {
+ protected:
+  std::filesystem::path directory;  // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes)
+
+  void SetUp() override {
+    directory = std::filesystem::temp_directory_path() / "fsmconfig_definition_cache_test";
+    std::filesystem::create_directories(directory);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory); }
+
+  std::string writeConfig(const std::string& name, const std::string& content) const {
+    const auto path = directory / name;
+    std::ofstream file(path);
+    file << content;
+    return path.string();
+  }
+
+  static std::string machineConfig(const std::string& state) {
+    return "states:\n  " + state + ":\n  done:\n" + "transitions:\n  - from: " + state +
+           "\n    to: done\n    event: finish\n";
+  }
+};
+
+TEST_F(DefinitionCacheTest, LoadsFilesInOrder) {
+  std::vector<std::string> paths;
+  for (int i = 0; i < 16; ++i) {
+    paths.push_back(writeConfig("machine" + std::to_string(i) + ".yaml", machineConfig("state" + std::to_string(i))));
+  }
+
+  DefinitionCache cache;
+  auto definitions = cache.loadAll(paths, 4);
+
+  ASSERT_EQ(definitions.size(), paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    ASSERT_NE(definitions[i], nullptr);
+    EXPECT_EQ(definitions[i]->getInitialState(), "state" + std::to_string(i));
+    EXPECT_EQ(cache.get(paths[i]), definitions[i]);
+  }
+  EXPECT_EQ(cache.size(), paths.size());
+}
+
+TEST_F(DefinitionCacheTest, IdenticalContentIsShared) {
+  const auto first = writeConfig("a.yaml", machineConfig("idle"));
+  const auto second = writeConfig("b.yaml", machineConfig("idle"));
+  const auto other = writeConfig("c.yaml", machineConfig("busy"));
+
+  DefinitionCache cache;
+  auto definitions = cache.loadAll({first, second, other, first}, 2);
+
+  EXPECT_EQ(definitions[0], definitions[1]);
+  EXPECT_EQ(definitions[0], definitions[3]);
+  EXPECT_NE(definitions[0], definitions[2]);
+  EXPECT_EQ(cache.size(), 2);
+
+  // Later loads of the same content reuse the cached definition
+  const auto copy = writeConfig("d.yaml", machineConfig("idle"));
+  EXPECT_EQ(cache.load(copy), definitions[0]);
+  EXPECT_EQ(cache.size(), 2);
+}
+
+TEST_F(DefinitionCacheTest, FailuresAreReportedTogether) {
+  const auto good = writeConfig("good.yaml", machineConfig("idle"));
+  const auto broken = writeConfig("broken.yaml", "states: [");
+  const auto missing = (directory / "missing.yaml").string();
+
+  DefinitionCache cache;
+  try {
+    static_cast<void>(cache.loadAll({good, broken, missing}, 3));
+    FAIL() << "Expected ConfigException";
+  } catch (const ConfigException& e) {
+    const std::string message = e.what();
+    EXPECT_NE(message.find("2 configuration file(s)"), std::string::npos);
+    EXPECT_NE(message.find(broken), std::string::npos);
+    EXPECT_NE(message.find(missing), std::string::npos);
+  }
+
+  EXPECT_NE(cache.get(good), nullptr);
+  EXPECT_EQ(cache.get(broken), nullptr);
+}
+
+TEST_F(DefinitionCacheTest, ClearDropsDefinitions) {
+  const auto path = writeConfig("a.yaml", machineConfig("idle"));
+  DefinitionCache cache;
+  auto definition = cache.load(path);
+
+  cache.clear();
+
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.get(path), nullptr);
+  EXPECT_TRUE(definition->hasState("idle"));
+  EXPECT_NE(cache.load(path), definition);
+}
+
+TEST_F(DefinitionCacheTest, EmptyInput) {
+  DefinitionCache cache;
+
+  EXPECT_TRUE(cache.loadAll({}).empty());
+}
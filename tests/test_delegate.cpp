@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <fsmconfig/callback_registry.hpp>
+#include <fsmconfig/delegate.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_delegate.cpp
+ * @brief Tests for Delegate
+ */
+
+namespace {
+
+class Counter {
+ public:
+  void increment() { ++value; }
+  [[nodiscard]] bool isPositive() const { return value > 0; }
+  int add(int amount) { return value += amount; }
+
+  int value = 0;
+};
+
+int twice(int value) { return value * 2; }
+
+}  // namespace
+
+TEST(DelegateTest, EmptyByDefault) {
+  const Delegate<void()> empty;
+  const Delegate<void()> null = nullptr;
+  const Delegate<void()> from_empty_function = std::function<void()>();
+  void (*null_pointer)() = nullptr;
+  const Delegate<void()> from_null_pointer = null_pointer;
+
+  EXPECT_FALSE(empty);
+  EXPECT_FALSE(null);
+  EXPECT_FALSE(from_empty_function);
+  EXPECT_FALSE(from_null_pointer);
+  EXPECT_FALSE(empty.isInline());
+}
+
+TEST(DelegateTest, FunctionPointer) {
+  const Delegate<int(int)> delegate = &twice;
+
+  ASSERT_TRUE(delegate);
+  EXPECT_TRUE(delegate.isInline());
+  EXPECT_EQ(delegate(21), 42);
+}
+
+TEST(DelegateTest, MemberFunctionIsStoredInline) {
+  Counter counter;
+  const Delegate<void()> increment(&Counter::increment, &counter);
+  const Delegate<bool()> positive(&Counter::isPositive, static_cast<const Counter*>(&counter));
+
+  EXPECT_TRUE(increment.isInline());
+  EXPECT_TRUE(positive.isInline());
+  EXPECT_FALSE(positive());
+  increment();
+  increment();
+  EXPECT_EQ(counter.value, 2);
+  EXPECT_TRUE(positive());
+}
+
+TEST(DelegateTest, BindResolvesMethodStatically) {
+  Counter counter;
+  const auto add = Delegate<int(int)>::bind<&Counter::add>(&counter);
+
+  EXPECT_TRUE(add.isInline());
+  EXPECT_EQ(add(5), 5);
+  EXPECT_EQ(add(2), 7);
+}
+
+TEST(DelegateTest, SmallLambdaIsStoredInline) {
+  int calls = 0;
+  const Delegate<void()> delegate = [&calls]() { ++calls; };
+
+  EXPECT_TRUE(delegate.isInline());
+  delegate();
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(DelegateTest, LargeOrOwningCallableIsStoredOnHeap) {
+  const std::string suffix = "!";
+  const Delegate<std::string(const std::string&)> owning = [suffix](const std::string& text) { return text + suffix; };
+  const Delegate<void()> function = std::function<void()>([] {});
+
+  EXPECT_FALSE(owning.isInline());
+  EXPECT_EQ(owning("hi"), "hi!");
+  EXPECT_TRUE(function);
+  EXPECT_FALSE(function.isInline());
+}
+
+TEST(DelegateTest, MoveOnlyCallable) {
+  auto value = std::make_unique<int>(7);
+  Delegate<int()> delegate = [value = std::move(value)]() { return *value; };
+
+  EXPECT_EQ(delegate(), 7);
+
+  Delegate<int()> moved = std::move(delegate);
+  EXPECT_FALSE(delegate);  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(moved(), 7);
+}
+
+TEST(DelegateTest, HeapCallableIsDestroyedOnce) {
+  auto tracker = std::make_shared<int>(0);
+  {
+    Delegate<void()> first = [tracker]() {};
+    EXPECT_EQ(tracker.use_count(), 2);
+
+    Delegate<void()> second = std::move(first);
+    EXPECT_EQ(tracker.use_count(), 2);
+
+    second = nullptr;
+    EXPECT_EQ(tracker.use_count(), 1);
+
+    second = [tracker]() {};
+    EXPECT_EQ(tracker.use_count(), 2);
+  }
+  EXPECT_EQ(tracker.use_count(), 1);
+}
+
+TEST(DelegateTest, RegistryAcceptsDelegates) {
+  CallbackRegistry registry;
+  Counter counter;
+
+  registry.registerAction("increment", ActionCallback(&Counter::increment, &counter));
+  registry.registerGuard("a", "b", "go", [&counter]() { return counter.value > 0; });
+
+  EXPECT_FALSE(registry.callGuard("a", "b", "go"));
+  registry.callAction("increment");
+  EXPECT_EQ(counter.value, 1);
+  EXPECT_TRUE(registry.callGuard("a", "b", "go"));
+}
@@ -4,9 +4,14 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
+#include "fsmconfig/config_parser.hpp"
 #include "fsmconfig/event_dispatcher.hpp"
 #include "fsmconfig/types.hpp"
 
@@ -438,3 +443,253 @@ TEST(EventDispatcherTest, IsRunningDuringProcessing) {
 
     dispatcher.stop();
 }
+
+/// Tests that strict draining serves the most urgent lane first
+TEST(EventDispatcherTest, StrictPriorityOrder) {
+    EventDispatcher dispatcher;
+    std::vector<std::string> order;
+    dispatcher.setEventHandler([&](const std::string& name, const TransitionEvent&) { order.push_back(name); });
+
+    const TransitionEvent event;
+    dispatcher.dispatchEvent("telemetry", event, EventPriority::LOW);
+    dispatcher.dispatchEvent("update", event);
+    dispatcher.dispatchEvent("connection_lost", event, EventPriority::CRITICAL);
+    dispatcher.dispatchEvent("retry", event, EventPriority::HIGH);
+    dispatcher.dispatchEvent("disconnect", event, EventPriority::CRITICAL);
+
+    EXPECT_EQ(dispatcher.getDrainPolicy(), DrainPolicy::STRICT);
+    EXPECT_EQ(dispatcher.getEventQueueSize(), 5);
+    EXPECT_EQ(dispatcher.getEventQueueSize(EventPriority::CRITICAL), 2);
+    EXPECT_EQ(dispatcher.getEventQueueSize(EventPriority::NORMAL), 1);
+    EXPECT_TRUE(dispatcher.hasPendingEvents(EventPriority::LOW));
+
+    dispatcher.processEvents();
+
+    EXPECT_EQ(order, (std::vector<std::string>{"connection_lost", "disconnect", "retry", "update", "telemetry"}));
+    EXPECT_FALSE(dispatcher.hasPendingEvents(EventPriority::LOW));
+}
+
+/// Tests that weighted draining interleaves lanes by weight
+TEST(EventDispatcherTest, WeightedPriorityOrder) {
+    EventDispatcher dispatcher;
+    dispatcher.setDrainPolicy(DrainPolicy::WEIGHTED);
+    dispatcher.setLaneWeights({2, 1, 1, 1});
+    EXPECT_EQ(dispatcher.getLaneWeights(), (LaneWeights{2, 1, 1, 1}));
+
+    std::string order;
+    dispatcher.setEventHandler([&](const std::string& name, const TransitionEvent&) { order += name; });
+
+    const TransitionEvent event;
+    for (int i = 0; i < 4; ++i) {
+        dispatcher.dispatchEvent("L", event, EventPriority::LOW);
+        dispatcher.dispatchEvent("C", event, EventPriority::CRITICAL);
+    }
+    dispatcher.processEvents();
+
+    // Low-priority events are not starved while critical ones keep arriving
+    EXPECT_EQ(order, "CCLCCLLL");
+    EXPECT_THROW(dispatcher.setLaneWeights({1, 0, 1, 1}), StateException);
+}
+
+/// Tests lock-free dispatch from many threads into all lanes
+TEST(EventDispatcherTest, ConcurrentDispatchToAllLanes) {
+    EventDispatcher dispatcher;
+    std::vector<std::vector<int>> received(EVENT_PRIORITY_COUNT);
+    dispatcher.setEventHandler([&](const std::string& name, const TransitionEvent& event) {
+        received[static_cast<size_t>(std::stoi(name))].push_back(static_cast<int>(event.data.at("seq").asInt()));
+    });
+
+    constexpr int kPerLane = 1000;
+    {
+        std::vector<std::thread> producers;
+        for (size_t lane = 0; lane < EVENT_PRIORITY_COUNT; ++lane) {
+            producers.emplace_back([&dispatcher, lane] {
+                for (int i = 0; i < kPerLane; ++i) {
+                    TransitionEvent event;
+                    event.data.emplace("seq", VariableValue(i));
+                    dispatcher.dispatchEvent(std::to_string(lane), event, static_cast<EventPriority>(lane));
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+    }
+
+    dispatcher.processEvents();
+    for (const auto& lane : received) {
+        ASSERT_EQ(lane.size(), static_cast<size_t>(kPerLane));
+        EXPECT_TRUE(std::is_sorted(lane.begin(), lane.end()));
+    }
+}
+
+/// Tests that a full queue rejects new events and counts them
+TEST(EventDispatcherTest, CapacityRejectsWhenFull) {
+    EventDispatcher dispatcher;
+    dispatcher.setCapacity(2);
+    EXPECT_EQ(dispatcher.getCapacity(), 2);
+    EXPECT_EQ(dispatcher.getOverflowPolicy(), OverflowPolicy::REJECT);
+
+    const TransitionEvent event;
+    EXPECT_EQ(dispatcher.dispatchEvent("a", event), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("b", event), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("c", event), DispatchResult::REJECTED);
+    EXPECT_EQ(dispatcher.getEventQueueSize(), 2);
+
+    dispatcher.processOneEvent();
+    EXPECT_EQ(dispatcher.dispatchEvent("d", event), DispatchResult::ENQUEUED);
+
+    const DispatchStats stats = dispatcher.getDispatchStats();
+    EXPECT_EQ(stats.enqueued, 3);
+    EXPECT_EQ(stats.rejected, 1);
+
+    dispatcher.resetDispatchStats();
+    EXPECT_EQ(dispatcher.getDispatchStats().enqueued, 0);
+}
+
+/// Tests that dropping the oldest event never sheds a more urgent one
+TEST(EventDispatcherTest, CapacityDropsOldest) {
+    EventDispatcher dispatcher;
+    dispatcher.setCapacity(2);
+    dispatcher.setOverflowPolicy(OverflowPolicy::DROP_OLDEST);
+    std::vector<std::string> order;
+    dispatcher.setEventHandler([&](const std::string& name, const TransitionEvent&) { order.push_back(name); });
+
+    const TransitionEvent event;
+    dispatcher.dispatchEvent("telemetry", event, EventPriority::LOW);
+    dispatcher.dispatchEvent("update1", event);
+    EXPECT_EQ(dispatcher.dispatchEvent("update2", event), DispatchResult::DROPPED_OLDEST);
+    EXPECT_EQ(dispatcher.dispatchEvent("telemetry", event, EventPriority::LOW), DispatchResult::REJECTED);
+    EXPECT_EQ(dispatcher.dispatchEvent("alarm", event, EventPriority::CRITICAL), DispatchResult::DROPPED_OLDEST);
+
+    dispatcher.processEvents();
+    EXPECT_EQ(order, (std::vector<std::string>{"alarm", "update2"}));
+
+    const DispatchStats stats = dispatcher.getDispatchStats();
+    EXPECT_EQ(stats.enqueued, 4);
+    EXPECT_EQ(stats.dropped, 2);
+    EXPECT_EQ(stats.rejected, 1);
+}
+
+/// Tests that a full queue merges events into pending ones with the same name
+TEST(EventDispatcherTest, CapacityCoalescesDuplicates) {
+    EventDispatcher dispatcher;
+    dispatcher.setCapacity(2);
+    dispatcher.setOverflowPolicy(OverflowPolicy::COALESCE);
+    std::vector<std::pair<std::string, int>> received;
+    dispatcher.setEventHandler([&](const std::string& name, const TransitionEvent& event) {
+        received.emplace_back(name, event.data.count("value") != 0U ? event.data.at("value").asInt() : 0);
+    });
+
+    for (int value = 1; value <= 3; ++value) {
+        TransitionEvent progress;
+        progress.data.emplace("value", VariableValue(value));
+        dispatcher.dispatchEvent("progress", progress);
+        if (value == 1) {
+            dispatcher.dispatchEvent("heartbeat", TransitionEvent{});
+        }
+    }
+    EXPECT_EQ(dispatcher.dispatchEvent("other", TransitionEvent{}), DispatchResult::REJECTED);
+    EXPECT_EQ(dispatcher.getEventQueueSize(), 2);
+
+    dispatcher.processEvents();
+    EXPECT_EQ(received, (std::vector<std::pair<std::string, int>>{{"progress", 3}, {"heartbeat", 0}}));
+
+    // Consumed events can no longer be merged into
+    EXPECT_EQ(dispatcher.dispatchEvent("progress", TransitionEvent{}), DispatchResult::ENQUEUED);
+
+    const DispatchStats stats = dispatcher.getDispatchStats();
+    EXPECT_EQ(stats.enqueued, 3);
+    EXPECT_EQ(stats.coalesced, 2);
+    EXPECT_EQ(stats.rejected, 1);
+}
+
+/// Tests that blocking producers wait for space up to the timeout
+TEST(EventDispatcherTest, CapacityBlocksProducer) {
+    EventDispatcher dispatcher;
+    dispatcher.setCapacity(1);
+    dispatcher.setOverflowPolicy(OverflowPolicy::BLOCK);
+    dispatcher.setBlockTimeout(std::chrono::milliseconds(10));
+    EXPECT_EQ(dispatcher.getBlockTimeout(), std::chrono::milliseconds(10));
+
+    const TransitionEvent event;
+    EXPECT_EQ(dispatcher.dispatchEvent("first", event), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("second", event), DispatchResult::TIMED_OUT);
+
+    dispatcher.setBlockTimeout(std::chrono::seconds(10));
+    std::thread consumer([&dispatcher] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        dispatcher.processOneEvent();
+    });
+    EXPECT_EQ(dispatcher.dispatchEvent("third", event), DispatchResult::ENQUEUED);
+    consumer.join();
+
+    EXPECT_EQ(dispatcher.getEventQueueSize(), 1);
+    EXPECT_EQ(dispatcher.getDispatchStats().timed_out, 1);
+}
+
+/// Tests that coalesced events keep one pending instance per name and key
+TEST(EventDispatcherTest, CoalescesPendingEventsByKey) {
+    EventDispatcher dispatcher;
+    dispatcher.setCoalescing("heartbeat");
+    dispatcher.setCoalescing("progress", "job");
+    EXPECT_TRUE(dispatcher.isCoalescing("progress"));
+    EXPECT_FALSE(dispatcher.isCoalescing("update"));
+
+    std::vector<std::string> received;
+    dispatcher.setEventHandler([&](const std::string& name, const TransitionEvent& event) {
+        const auto value = event.data.find("value");
+        received.push_back(name + (value != event.data.end() ? "=" + value->second.toString() : ""));
+    });
+
+    const auto makeEvent = [](int job, int value) {
+        TransitionEvent event;
+        event.data.emplace("job", VariableValue(job));
+        event.data.emplace("value", VariableValue(value));
+        return event;
+    };
+    EXPECT_EQ(dispatcher.dispatchEvent("heartbeat", makeEvent(0, 1)), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("progress", makeEvent(1, 10)), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("heartbeat", makeEvent(0, 2)), DispatchResult::COALESCED);
+    EXPECT_EQ(dispatcher.dispatchEvent("progress", makeEvent(2, 20)), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("update", makeEvent(0, 0)), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("progress", makeEvent(1, 11)), DispatchResult::COALESCED);
+    EXPECT_EQ(dispatcher.getEventQueueSize(), 4);
+    EXPECT_EQ(dispatcher.getDispatchStats().coalesced, 2);
+
+    dispatcher.processEvents();
+    EXPECT_EQ(received, (std::vector<std::string>{"heartbeat=2", "progress=11", "progress=20", "update=0"}));
+
+    // Processed instances are not merged into; without a rule nothing is
+    dispatcher.clearCoalescing("heartbeat");
+    EXPECT_EQ(dispatcher.dispatchEvent("progress", makeEvent(1, 12)), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("heartbeat", makeEvent(0, 3)), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("heartbeat", makeEvent(0, 4)), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.getEventQueueSize(), 3);
+}
+
+/// Tests that coalescing rules are taken from a configuration
+TEST(EventDispatcherTest, LoadsCoalescingFromConfig) {
+    ConfigParser parser;
+    parser.loadFromString(R"(
+states:
+  idle:
+events:
+  heartbeat:
+    coalesce: true
+  progress:
+    coalesce: true
+    key: job
+)");
+
+    EventDispatcher dispatcher;
+    dispatcher.loadCoalescing(parser.getCompiledConfig());
+    EXPECT_TRUE(dispatcher.isCoalescing("heartbeat"));
+    EXPECT_TRUE(dispatcher.isCoalescing("progress"));
+
+    // A full queue still accepts updates of pending coalesced events
+    dispatcher.setCapacity(1);
+    EXPECT_EQ(dispatcher.dispatchEvent("heartbeat", TransitionEvent{}), DispatchResult::ENQUEUED);
+    EXPECT_EQ(dispatcher.dispatchEvent("heartbeat", TransitionEvent{}), DispatchResult::COALESCED);
+    EXPECT_EQ(dispatcher.dispatchEvent("progress", TransitionEvent{}), DispatchResult::REJECTED);
+}
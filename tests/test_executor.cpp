@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fsmconfig/executor.hpp>
+#include <fsmconfig/state_machine.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_executor.cpp
+ * @brief Tests for Executor
+ */
+
+namespace {
+
+const char* const kToggleConfig = R"(
+states:
+  off:
+    actions:
+      - count
+  on:
+    actions:
+      - count
+
+transitions:
+  - from: off
+    to: on
+    event: toggle
+  - from: on
+    to: off
+    event: toggle
+)";
+
+/**
+ * @brief Machine counting its actions and detecting concurrent entry
+ */
+class CountingMachine {
+ public:
+  CountingMachine() : machine(kToggleConfig, true) {
+    machine.registerAction("count", &CountingMachine::onCount, this);
+    machine.start();
+  }
+
+  void onCount() {
+    if (inside.exchange(true)) {
+      overlapped = true;
+    }
+    ++count;
+    inside = false;
+  }
+
+  StateMachine machine;                 // NOLINT(misc-non-private-member-variables-in-classes) - Test helper class
+  int count = 0;                        // NOLINT(misc-non-private-member-variables-in-classes) - Test helper class
+  std::atomic<bool> inside{false};      // NOLINT(misc-non-private-member-variables-in-classes) - Test helper class
+  std::atomic<bool> overlapped{false};  // NOLINT(misc-non-private-member-variables-in-classes) - Test helper class
+};
+
+}  // namespace
+
+TEST(ExecutorTest, ThreadCount) {
+  const Executor executor(3);
+  EXPECT_EQ(executor.getThreadCount(), 3);
+
+  const Executor automatic;
+  EXPECT_GE(automatic.getThreadCount(), 1);
+}
+
+TEST(ExecutorTest, EventsOfOneMachineAreProcessedInOrder) {
+  CountingMachine target;
+  Executor executor(4);
+  auto mailbox = executor.attach(target.machine);
+
+  for (int i = 0; i < 1001; ++i) {
+    executor.post(mailbox, "toggle");
+  }
+  executor.waitIdle();
+
+  EXPECT_EQ(target.count, 1002);
+  EXPECT_EQ(target.machine.getCurrentState(), "on");
+  EXPECT_EQ(executor.getProcessedCount(), 1001);
+  EXPECT_FALSE(target.overlapped);
+}
+
+TEST(ExecutorTest, ManyMachinesFromManyProducers) {
+  constexpr size_t kMachines = 64;
+  constexpr size_t kProducers = 4;
+  constexpr size_t kEventsPerProducer = 500;
+
+  std::vector<std::unique_ptr<CountingMachine>> targets;
+  for (size_t i = 0; i < kMachines; ++i) {
+    targets.push_back(std::make_unique<CountingMachine>());
+  }
+
+  Executor executor(4);
+  std::vector<std::shared_ptr<Executor::Mailbox>> mailboxes;
+  for (auto& target : targets) {
+    mailboxes.push_back(executor.attach(target->machine));
+  }
+
+  {
+    std::vector<std::jthread> producers;
+    for (size_t p = 0; p < kProducers; ++p) {
+      producers.emplace_back([&executor, &mailboxes] {
+        for (size_t i = 0; i < kEventsPerProducer; ++i) {
+          for (auto& mailbox : mailboxes) {
+            executor.post(mailbox, "toggle");
+          }
+        }
+      });
+    }
+  }
+  executor.waitIdle();
+
+  for (auto& target : targets) {
+    EXPECT_EQ(target->count, static_cast<int>(kProducers * kEventsPerProducer) + 1);
+    EXPECT_FALSE(target->overlapped);
+    EXPECT_EQ(target->machine.getCurrentState(), "off");
+  }
+  EXPECT_EQ(executor.getProcessedCount(), kMachines * kProducers * kEventsPerProducer);
+}
+
+TEST(ExecutorTest, CallbacksCanPostToOtherMachines) {
+  CountingMachine first;
+  CountingMachine second;
+  Executor executor(2);
+  auto first_mailbox = executor.attach(first.machine);
+  auto second_mailbox = executor.attach(second.machine);
+
+  // Every toggle of the first machine is forwarded to the second one
+  struct Forwarder {
+    Executor* executor;
+    std::shared_ptr<Executor::Mailbox> target;
+    void forward() { executor->post(target, "toggle"); }
+  };
+  Forwarder forwarder{&executor, second_mailbox};
+  first.machine.registerStateCallback("on", "on_enter", &Forwarder::forward, &forwarder);
+  first.machine.registerStateCallback("off", "on_enter", &Forwarder::forward, &forwarder);
+
+  for (int i = 0; i < 100; ++i) {
+    executor.post(first_mailbox, "toggle");
+  }
+  executor.waitIdle();
+
+  EXPECT_EQ(first.count, 101);
+  EXPECT_EQ(second.count, 101);
+}
+
+TEST(ExecutorTest, ErrorsReachErrorHandler) {
+  StateMachine stopped(kToggleConfig, true);
+  Executor executor(2);
+
+  std::mutex mutex;
+  std::vector<std::string> errors;
+  executor.setErrorHandler([&](const std::string& error) {
+    const std::scoped_lock lock(mutex);
+    errors.push_back(error);
+  });
+
+  auto mailbox = executor.attach(stopped);
+  executor.post(mailbox, "toggle");
+  executor.post(mailbox, "toggle");
+  executor.waitIdle();
+
+  ASSERT_EQ(errors.size(), 2);
+  EXPECT_EQ(errors.front(), "StateMachine is not started");
+}
+
+TEST(ExecutorTest, DestructorProcessesPostedEvents) {
+  CountingMachine target;
+  {
+    Executor executor(2);
+    auto mailbox = executor.attach(target.machine);
+    for (int i = 0; i < 10; ++i) {
+      executor.post(mailbox, "toggle");
+    }
+  }
+
+  EXPECT_EQ(target.count, 11);
+}
+
+TEST(ExecutorTest, NullMailboxIsRejected) {
+  Executor executor(1);
+  EXPECT_THROW(executor.post(nullptr, "toggle"), StateException);
+}
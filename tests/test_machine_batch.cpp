@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fsmconfig/machine_batch.hpp>
+#include <fsmconfig/machine_definition.hpp>
+#include <fsmconfig/state_machine.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_machine_batch.cpp
+ * @brief Tests for MachineBatch
+ */
+
+namespace {
+
+const char* const kLightConfig = R"(
+initial_state: red
+
+states:
+  red:
+  green:
+  yellow:
+  off:
+
+transitions:
+  - from: red
+    to: green
+    event: tick
+  - from: green
+    to: yellow
+    event: tick
+  - from: yellow
+    to: red
+    event: tick
+  - from: off
+    to: off
+    event: tick
+  - from: green
+    to: red
+    event: emergency
+  - from: yellow
+    to: red
+    event: emergency
+  - from: red
+    to: green
+    event: walk
+    guard: can_walk
+  - from: off
+    to: red
+    event: walk
+)";
+
+std::shared_ptr<const MachineDefinition> lightDefinition() { return MachineDefinition::fromString(kLightConfig); }
+
+/**
+ * @brief Record of callback invocations
+ */
+struct Recorder {
+  std::vector<std::string> calls;
+  std::vector<std::vector<uint32_t>> instances;
+
+  BatchStateCallback record(const std::string& name) {
+    return [this, name](std::span<const uint32_t> changed) {
+      calls.push_back(name);
+      instances.emplace_back(changed.begin(), changed.end());
+    };
+  }
+};
+
+}  // namespace
+
+TEST(MachineBatchTest, StartsInInitialState) {
+  MachineBatch batch(lightDefinition(), 5);
+
+  EXPECT_EQ(batch.size(), 5);
+  ASSERT_EQ(batch.states().size(), 5);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch.getState(i), "red");
+  }
+  EXPECT_TRUE(batch.getChangedInstances().empty());
+}
+
+TEST(MachineBatchTest, TriggerEventMovesEveryInstanceByTable) {
+  // 37 instances: whole 8-wide blocks and a scalar tail
+  MachineBatch batch(lightDefinition(), 37);
+  const char* const pattern[] = {"red", "green", "yellow", "off"};
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch.setState(i, pattern[i % 4]);
+  }
+
+  // off -> off is a self-transition and does not count as a change
+  EXPECT_EQ(batch.triggerEvent("tick"), 28);
+  const char* const expected[] = {"green", "yellow", "red", "off"};
+  std::vector<uint32_t> changed;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch.getState(i), expected[i % 4]) << "instance " << i;
+    if (i % 4 != 3) {
+      changed.push_back(static_cast<uint32_t>(i));
+    }
+  }
+  const auto reported = batch.getChangedInstances();
+  EXPECT_EQ(std::vector<uint32_t>(reported.begin(), reported.end()), changed);
+
+  // Unknown events change nothing
+  EXPECT_EQ(batch.triggerEvent("unknown"), 0);
+  EXPECT_TRUE(batch.getChangedInstances().empty());
+}
+
+TEST(MachineBatchTest, MatchesStateMachine) {
+  const auto definition = lightDefinition();
+  MachineBatch batch(definition, 1000);
+  StateMachine machine(definition);
+  machine.start();
+
+  const char* const events[] = {"tick", "tick", "emergency", "tick", "emergency", "tick", "tick"};
+  for (const char* event : events) {
+    batch.triggerEvent(event);
+    machine.triggerEvent(event);
+    for (size_t i = 0; i < batch.size(); ++i) {
+      ASSERT_EQ(batch.getState(i), machine.getCurrentState()) << "after " << event << ", instance " << i;
+    }
+  }
+}
+
+TEST(MachineBatchTest, CallbacksReceiveOnlyChangedInstances) {
+  MachineBatch batch(lightDefinition(), 10);
+  for (size_t i = 0; i < batch.size(); i += 2) {
+    batch.setState(i, "green");
+  }
+
+  Recorder recorder;
+  batch.registerStateCallback("green", "on_exit", recorder.record("exit green"));
+  batch.registerStateCallback("red", "on_exit", recorder.record("exit red"));
+  batch.registerStateCallback("red", "on_enter", recorder.record("enter red"));
+  batch.registerStateCallback("yellow", "on_enter", recorder.record("enter yellow"));
+
+  // Only the green (even) instances move
+  EXPECT_EQ(batch.triggerEvent("emergency"), 5);
+  ASSERT_EQ(recorder.calls, (std::vector<std::string>{"exit green", "enter red"}));
+  EXPECT_EQ(recorder.instances[0], (std::vector<uint32_t>{0, 2, 4, 6, 8}));
+  EXPECT_EQ(recorder.instances[1], (std::vector<uint32_t>{0, 2, 4, 6, 8}));
+
+  // Exits of all left states run before the enters
+  recorder.calls.clear();
+  recorder.instances.clear();
+  batch.setState(3, "green");
+  EXPECT_EQ(batch.triggerEvent("tick"), 10);
+  ASSERT_EQ(recorder.calls, (std::vector<std::string>{"exit red", "exit green", "enter yellow"}));
+  EXPECT_EQ(recorder.instances[0], (std::vector<uint32_t>{0, 1, 2, 4, 5, 6, 7, 8, 9}));
+  EXPECT_EQ(recorder.instances[1], (std::vector<uint32_t>{3}));
+  EXPECT_EQ(recorder.instances[2], (std::vector<uint32_t>{3}));
+
+  // No instance changes, no callback runs
+  recorder.calls.clear();
+  EXPECT_EQ(batch.triggerEvent("walk"), 0);
+  EXPECT_TRUE(recorder.calls.empty());
+}
+
+TEST(MachineBatchTest, GuardsAreEvaluatedPerInstance) {
+  MachineBatch batch(lightDefinition(), 6);
+  batch.setState(5, "off");
+
+  // Unregistered guard denies the transition; unguarded transitions of the same event still apply
+  EXPECT_EQ(batch.triggerEvent("walk"), 1);
+  EXPECT_EQ(batch.getState(0), "red");
+  EXPECT_EQ(batch.getState(5), "red");
+
+  std::vector<uint32_t> asked;
+  batch.registerGuard("red", "green", "walk", [&asked](uint32_t instance) {
+    asked.push_back(instance);
+    return instance % 2 == 1;
+  });
+  EXPECT_EQ(batch.triggerEvent("walk"), 3);
+  EXPECT_EQ(asked, (std::vector<uint32_t>{0, 1, 2, 3, 4, 5}));
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_EQ(batch.getState(i), i % 2 == 1 ? "green" : "red") << "instance " << i;
+  }
+}
+
+TEST(MachineBatchTest, InvalidArgumentsThrowException) {
+  EXPECT_THROW(MachineBatch(nullptr, 1), StateException);
+
+  MachineBatch batch(lightDefinition(), 2);
+  EXPECT_THROW(static_cast<void>(batch.getState(2)), StateException);
+  EXPECT_THROW(batch.setState(2, "red"), StateException);
+  EXPECT_THROW(batch.setState(0, "blue"), StateException);
+  EXPECT_THROW(batch.registerStateCallback("blue", "on_enter", nullptr), StateException);
+  EXPECT_THROW(batch.registerStateCallback("red", "on_leave", nullptr), StateException);
+  EXPECT_THROW(batch.registerGuard("red", "yellow", "walk", nullptr), StateException);
+
+  // Callbacks must not step their own batch
+  bool rejected = false;
+  batch.registerStateCallback("green", "on_enter", [&](std::span<const uint32_t>) {
+    try {
+      batch.triggerEvent("tick");
+    } catch (const StateException&) {
+      rejected = true;
+    }
+  });
+  EXPECT_EQ(batch.triggerEvent("tick"), 2);
+  EXPECT_TRUE(rejected);
+  EXPECT_EQ(batch.getState(0), "green");
+}
+
+TEST(MachineBatchTest, SnapshotRestoresStatesAndCount) {
+  const auto definition = lightDefinition();
+  MachineBatch original(definition, 100);
+  original.triggerEvent("tick");
+  original.setState(7, "off");
+  const std::string snapshot = original.snapshot();
+
+  MachineBatch restored(definition, 3);
+  Recorder recorder;
+  restored.registerStateCallback("green", "on_enter", recorder.record("enter green"));
+  restored.restore(snapshot);
+
+  EXPECT_TRUE(recorder.calls.empty());
+  ASSERT_EQ(restored.size(), 100);
+  EXPECT_TRUE(std::equal(original.states().begin(), original.states().end(), restored.states().begin()));
+  EXPECT_EQ(restored.getState(7), "off");
+
+  // Restored instances keep stepping
+  EXPECT_EQ(restored.triggerEvent("tick"), 99);
+  EXPECT_EQ(restored.getState(0), "yellow");
+}
+
+TEST(MachineBatchTest, RestoreRejectsInvalidSnapshots) {
+  MachineBatch batch(lightDefinition(), 4);
+  MachineBatch other(MachineDefinition::fromString("states:\n  red:\n  green:\n"), 4);
+
+  EXPECT_THROW(batch.restore(other.snapshot()), StateException);
+  const std::string snapshot = batch.snapshot();
+  EXPECT_THROW(batch.restore(snapshot.substr(0, snapshot.size() - 1)), StateException);
+  EXPECT_THROW(batch.restore(snapshot + "x"), StateException);
+  EXPECT_THROW(batch.restore("not a snapshot"), StateException);
+
+  // StateId of the last instance out of range
+  std::string corrupted = snapshot;
+  corrupted[corrupted.size() - 4] = 42;
+  EXPECT_THROW(batch.restore(corrupted), StateException);
+  EXPECT_EQ(batch.size(), 4);
+  EXPECT_EQ(batch.getState(3), "red");
+}
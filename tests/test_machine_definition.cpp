@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fsmconfig/config_parser.hpp>
+#include <fsmconfig/machine_definition.hpp>
+#include <fsmconfig/state_machine.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_machine_definition.cpp
+ * @brief Tests for MachineDefinition and StateMachine configuration reload
+ */
+
+namespace {
+
+const char* const kBaseConfig = R"(
+variables:
+  counter: 1
+
+states:
+  idle:
+    on_enter: on_idle_enter
+  running:
+
+transitions:
+  - from: idle
+    to: running
+    event: start
+  - from: running
+    to: idle
+    event: stop
+)";
+
+const char* const kExtendedConfig = R"(
+variables:
+  counter: 100
+  limit: 5
+
+states:
+  idle:
+    on_enter: on_idle_enter
+  running:
+  paused:
+
+transitions:
+  - from: idle
+    to: running
+    event: start
+  - from: running
+    to: idle
+    event: stop
+  - from: running
+    to: paused
+    event: pause
+  - from: paused
+    to: idle
+    event: stop
+)";
+
+class Recorder {
+ public:
+  int idle_enters = 0;  // NOLINT(misc-non-private-member-variables-in-classes)
+
+  void onIdleEnter() { ++idle_enters; }
+};
+
+}  // namespace
+
+TEST(MachineDefinitionTest, FromStringExposesStates) {
+  auto definition = MachineDefinition::fromString(kBaseConfig);
+
+  EXPECT_TRUE(definition->hasState("idle"));
+  EXPECT_FALSE(definition->hasState("paused"));
+  EXPECT_EQ(definition->getStateNames(), (std::vector<std::string>{"idle", "running"}));
+  EXPECT_EQ(definition->getInitialState(), "idle");
+  EXPECT_EQ(definition->getConfig().getTransitions().size(), 2);
+}
+
+TEST(MachineDefinitionTest, InvalidContentThrows) {
+  EXPECT_THROW(static_cast<void>(MachineDefinition::fromString("states: [")), ConfigException);
+  EXPECT_THROW(static_cast<void>(MachineDefinition::fromFile("/nonexistent/fsmconfig.yaml")), ConfigException);
+}
+
+TEST(MachineDefinitionTest, DefinitionIsSharedBetweenMachines) {
+  auto definition = MachineDefinition::fromString(kBaseConfig);
+  StateMachine first(definition);
+  StateMachine second(definition);
+
+  first.start();
+  second.start();
+  first.triggerEvent("start");
+
+  EXPECT_EQ(first.getCurrentState(), "running");
+  EXPECT_EQ(second.getCurrentState(), "idle");
+  EXPECT_EQ(first.getDefinition(), second.getDefinition());
+}
+
+TEST(MachineDefinitionTest, NullDefinitionThrows) {
+  EXPECT_THROW(StateMachine(std::shared_ptr<const MachineDefinition>()), ConfigException);
+
+  StateMachine fsm(kBaseConfig, true);
+  EXPECT_THROW(fsm.swapDefinition(nullptr), ConfigException);
+}
+
+TEST(MachineDefinitionTest, LayoutHashFollowsStates) {
+  const auto base = MachineDefinition::fromString(kBaseConfig);
+  EXPECT_EQ(base->getLayoutHash(), MachineDefinition::fromString(kBaseConfig)->getLayoutHash());
+
+  // Transitions and variables do not affect the state numbering
+  const auto rewired = MachineDefinition::fromString(R"(
+states:
+  idle:
+  running:
+
+transitions:
+  - from: running
+    to: running
+    event: tick
+)");
+  EXPECT_EQ(base->getLayoutHash(), rewired->getLayoutHash());
+  EXPECT_NE(base->getLayoutHash(), MachineDefinition::fromString(kExtendedConfig)->getLayoutHash());
+  EXPECT_NE(base->getLayoutHash(), MachineDefinition::fromString("states:\n  running:\n  idle:\n")->getLayoutHash());
+}
+
+TEST(StateMachineReloadTest, ReloadKeepsStateAndCallbacks) {
+  StateMachine fsm(kBaseConfig, true);
+  Recorder recorder;
+  fsm.registerStateCallback("idle", "on_enter", &Recorder::onIdleEnter, &recorder);
+  fsm.start();
+  fsm.triggerEvent("start");
+
+  fsm.reloadFromString(kExtendedConfig);
+
+  EXPECT_EQ(fsm.getCurrentState(), "running");
+  EXPECT_TRUE(fsm.hasState("paused"));
+  fsm.triggerEvent("pause");
+  EXPECT_EQ(fsm.getCurrentState(), "paused");
+  fsm.triggerEvent("stop");
+  EXPECT_EQ(fsm.getCurrentState(), "idle");
+  EXPECT_EQ(recorder.idle_enters, 2);
+}
+
+TEST(StateMachineReloadTest, ReloadPreservesVariablesAndSeedsNewOnes) {
+  StateMachine fsm(kBaseConfig, true);
+  fsm.setVariable("counter", VariableValue(42));
+
+  fsm.reloadFromString(kExtendedConfig);
+
+  EXPECT_EQ(fsm.getVariable("counter").asInt(), 42);
+  EXPECT_EQ(fsm.getVariable("limit").asInt(), 5);
+}
+
+TEST(StateMachineReloadTest, ReloadWithoutCurrentStateIsRejected) {
+  StateMachine fsm(kExtendedConfig, true);
+  std::string reported;
+  fsm.setErrorHandler([&reported](const std::string& error) { reported = error; });
+  fsm.start();
+  fsm.triggerEvent("start");
+  fsm.triggerEvent("pause");
+  auto previous = fsm.getDefinition();
+
+  EXPECT_THROW(fsm.reloadFromString(kBaseConfig), StateException);
+
+  EXPECT_FALSE(reported.empty());
+  EXPECT_EQ(fsm.getDefinition(), previous);
+  EXPECT_EQ(fsm.getCurrentState(), "paused");
+}
+
+TEST(StateMachineReloadTest, InvalidReloadKeepsOldDefinition) {
+  StateMachine fsm(kBaseConfig, true);
+  fsm.start();
+  auto previous = fsm.getDefinition();
+
+  EXPECT_THROW(fsm.reloadFromString("states: ["), ConfigException);
+  EXPECT_THROW(fsm.reload("/nonexistent/fsmconfig.yaml"), ConfigException);
+
+  EXPECT_EQ(fsm.getDefinition(), previous);
+  fsm.triggerEvent("start");
+  EXPECT_EQ(fsm.getCurrentState(), "running");
+}
+
+TEST(StateMachineReloadTest, StoppedMachineAcceptsAnyDefinition) {
+  StateMachine fsm(kExtendedConfig, true);
+
+  fsm.reloadFromString(kBaseConfig);
+  fsm.start();
+
+  EXPECT_EQ(fsm.getCurrentState(), "idle");
+  EXPECT_FALSE(fsm.hasState("paused"));
+}
+
+TEST(StateMachineReloadTest, ScheduledDefinitionIsAdoptedAtNextEvent) {
+  StateMachine fsm(kBaseConfig, true);
+  fsm.start();
+  fsm.triggerEvent("start");
+
+  fsm.scheduleDefinition(MachineDefinition::fromString(kExtendedConfig));
+  EXPECT_FALSE(fsm.hasState("paused"));
+
+  fsm.triggerEvent("pause");
+  EXPECT_EQ(fsm.getCurrentState(), "paused");
+  EXPECT_EQ(fsm.getVariable("limit").asInt(), 5);
+}
+
+TEST(StateMachineReloadTest, ScheduledDefinitionWithoutCurrentStateIsDropped) {
+  StateMachine fsm(kExtendedConfig, true);
+  std::string reported;
+  fsm.setErrorHandler([&reported](const std::string& error) { reported = error; });
+  fsm.start();
+  fsm.triggerEvent("start");
+  fsm.triggerEvent("pause");
+  auto previous = fsm.getDefinition();
+
+  fsm.scheduleDefinition(MachineDefinition::fromString(kBaseConfig));
+  EXPECT_NO_THROW(fsm.triggerEvent("stop"));
+
+  EXPECT_FALSE(reported.empty());
+  EXPECT_EQ(fsm.getDefinition(), previous);
+  EXPECT_EQ(fsm.getCurrentState(), "idle");
+  EXPECT_THROW(fsm.scheduleDefinition(nullptr), ConfigException);
+}
+
+TEST(MachineDefinitionTest, FindStateReturnsView) {
+  auto definition = MachineDefinition::fromString(kBaseConfig);
+
+  auto idle = definition->findState("idle");
+  ASSERT_TRUE(idle.has_value());
+  EXPECT_EQ(idle->getName(), "idle");
+  EXPECT_EQ(idle->getOnEnterCallback(), "on_idle_enter");
+  EXPECT_EQ(&idle->getConfig(), &definition->getCompiledConfig());
+  EXPECT_FALSE(definition->findState("paused").has_value());
+}
@@ -1,9 +1,10 @@
 /**
  * @file test_state.cpp
- * @brief Tests for State class
+ * @brief Tests for State and StateView classes
  */
 
 #include <gtest/gtest.h>
+#include "fsmconfig/config_parser.hpp"
 #include "fsmconfig/state.hpp"
 #include "fsmconfig/types.hpp"
 
@@ -452,3 +453,60 @@ TEST(StateTest, GetActionsReturnsConstReference) {
     // Should return the same reference
     EXPECT_EQ(&actions1, &actions2);
 }
+
+/// Tests StateView reads the compiled state record
+TEST(StateViewTest, ReadsCompiledRecord) {
+    ConfigParser parser;
+    parser.loadFromString(R"(
+states:
+  idle:
+    on_enter: on_idle_enter
+    variables:
+      timeout: 30
+      label: "waiting"
+    actions:
+      - reset
+      - log
+  busy:
+)");
+    const CompiledConfig& config = parser.getCompiledConfig();
+
+    const StateView idle(config, config.findState("idle"));
+    EXPECT_EQ(idle.getName(), "idle");
+    EXPECT_EQ(idle.getOnEnterCallback(), "on_idle_enter");
+    EXPECT_EQ(idle.getOnExitCallback(), "");
+    ASSERT_EQ(idle.getActions().size(), 2);
+    EXPECT_EQ(config.str(idle.getActions()[0]), "reset");
+    EXPECT_TRUE(idle.hasVariable("timeout"));
+    EXPECT_FALSE(idle.hasVariable("missing"));
+    EXPECT_EQ(idle.getVariable("timeout").asInt(), 30);
+    EXPECT_EQ(idle.getVariable("label").asString(), "waiting");
+    EXPECT_THROW(static_cast<void>(idle.getVariable("missing")), StateException);
+
+    const StateView busy(config, config.findState("busy"));
+    EXPECT_TRUE(busy.getActions().empty());
+    EXPECT_TRUE(busy.getVariables().empty());
+}
+
+/// Tests toStateInfo copies the compiled record into an owning StateInfo
+TEST(StateViewTest, ToStateInfoCopiesRecord) {
+    ConfigParser parser;
+    parser.loadFromString(R"(
+states:
+  idle:
+    on_exit: on_idle_exit
+    variables:
+      retries: 2
+    actions:
+      - log
+)");
+    const CompiledConfig& config = parser.getCompiledConfig();
+
+    const StateInfo info = StateView(config, 0).toStateInfo();
+    const State state(info);
+
+    EXPECT_EQ(state.getName(), "idle");
+    EXPECT_EQ(state.getOnExitCallback(), "on_idle_exit");
+    EXPECT_EQ(state.getActions(), (std::vector<std::string>{"log"}));
+    EXPECT_EQ(state.getVariable("retries").asInt(), 2);
+}
@@ -1,13 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <map>
+#include <stdexcept>
 #include <memory>
+#include <span>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <vector>
 
+#include <fsmconfig/machine_definition.hpp>
 #include <fsmconfig/state_machine.hpp>
 #include <fsmconfig/types.hpp>
 
@@ -178,6 +184,38 @@ states:
   EXPECT_TRUE(callbacks.exit_called);
 }
 
+TEST_F(StateMachineTest, StopCallsUndeclaredExitCallback) {
+  const std::string yaml_content = R"(
+states:
+  state1:
+)";
+
+  writeTestConfig(yaml_content);
+  fsm = std::make_unique<StateMachine>(test_config_path);
+
+  class TestCallbacks {
+   public:
+    int exits{};  // NOLINT(cppcoreguidelines-use-default-member-init) - Test helper class
+    TestCallbacks() = default;
+    void onExit() { ++exits; }
+  };
+
+  TestCallbacks callbacks;
+  fsm->registerStateCallback("state1", "on_exit", &TestCallbacks::onExit, &callbacks);
+  std::vector<std::string> errors;
+  fsm->setErrorHandler([&errors](const std::string& error) { errors.push_back(error); });
+  fsm->start();
+  fsm->reloadFromString("states:\n  state1:\n    actions:\n      - missing_action\n");
+
+  fsm->stop();
+  EXPECT_EQ(callbacks.exits, 1);
+
+  // stop() runs no actions, so unbound ones are left to be reported by the next start()
+  EXPECT_TRUE(errors.empty());
+  fsm->start();
+  EXPECT_EQ(errors, (std::vector<std::string>{"Action 'missing_action' is not registered"}));
+}
+
 TEST_F(StateMachineTest, ResetReturnsToInitialState) {
   const std::string yaml_content = R"(
 states:
@@ -517,6 +555,566 @@ transitions:
   EXPECT_TRUE(action.called);
 }
 
+TEST_F(StateMachineTest, ActionListsFollowRegistrationChanges) {
+  const std::string yaml_content = R"(
+states:
+  state1:
+    actions:
+      - log
+  state2:
+    actions:
+      - log
+      - count
+
+transitions:
+  - from: state1
+    to: state2
+    event: forward
+    actions:
+      - count
+  - from: state2
+    to: state1
+    event: back
+)";
+
+  writeTestConfig(yaml_content);
+  fsm = std::make_unique<StateMachine>(test_config_path);
+
+  class Counter {
+   public:
+    int logs{};    // NOLINT(cppcoreguidelines-use-default-member-init) - Test helper class
+    int counts{};  // NOLINT(cppcoreguidelines-use-default-member-init) - Test helper class
+    Counter() = default;
+    void onLog() { ++logs; }
+    void onCount() { ++counts; }
+  };
+
+  Counter counter;
+  fsm->registerAction("log", &Counter::onLog, &counter);
+  fsm->start();
+  fsm->triggerEvent("forward");
+  EXPECT_EQ(counter.logs, 2);
+  EXPECT_EQ(counter.counts, 0);
+
+  // Actions registered while running are picked up at the next event
+  fsm->registerAction("count", &Counter::onCount, &counter);
+  fsm->triggerEvent("back");
+  fsm->triggerEvent("forward");
+  EXPECT_EQ(counter.logs, 4);
+  EXPECT_EQ(counter.counts, 2);
+}
+
+TEST_F(StateMachineTest, UnboundActionsAreReportedOnce) {
+  const std::string yaml_content = R"(
+states:
+  state1:
+    actions:
+      - missing
+  state2:
+
+transitions:
+  - from: state1
+    to: state2
+    event: forward
+    actions:
+      - missing
+  - from: state2
+    to: state1
+    event: back
+)";
+
+  writeTestConfig(yaml_content);
+  fsm = std::make_unique<StateMachine>(test_config_path);
+
+  std::vector<std::string> errors;
+  fsm->setErrorHandler([&errors](const std::string& error) { errors.push_back(error); });
+  fsm->start();
+  fsm->triggerEvent("forward");
+  fsm->triggerEvent("back");
+
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors.front(), "Action 'missing' is not registered");
+}
+
+namespace {
+
+const char* const kBindConfig = R"(
+states:
+  closed:
+    on_exit: leave_closed
+    actions:
+      - log
+  open:
+    on_enter: enter_open
+
+transitions:
+  - from: closed
+    to: open
+    event: push
+    guard: can_open
+    on_transition: opening
+  - from: open
+    to: closed
+    event: pull
+)";
+
+class BindTarget {
+ public:
+  int calls{};  // NOLINT(cppcoreguidelines-use-default-member-init) - Test helper class
+  BindTarget() = default;
+  void onCall() { ++calls; }
+  void onTransition(const TransitionEvent& /*event*/) { ++calls; }
+  bool allow() { return ++calls > 0; }
+};
+
+void registerAll(StateMachine& machine, BindTarget& target) {
+  machine.registerStateCallback("closed", "on_exit", &BindTarget::onCall, &target);
+  machine.registerStateCallback("open", "on_enter", &BindTarget::onCall, &target);
+  machine.registerGuard("closed", "open", "push", &BindTarget::allow, &target);
+  machine.registerTransitionCallback("closed", "open", &BindTarget::onTransition, &target);
+  machine.registerAction("log", &BindTarget::onCall, &target);
+}
+
+}  // namespace
+
+TEST_F(StateMachineTest, BindReportsEveryUnboundCallback) {
+  fsm = std::make_unique<StateMachine>(kBindConfig, true);
+  BindTarget target;
+  fsm->registerAction("log", &BindTarget::onCall, &target);
+
+  try {
+    fsm->bind();
+    FAIL() << "Expected StateException";
+  } catch (const StateException& e) {
+    const std::string message = e.what();
+    EXPECT_NE(message.find("4 unbound callbacks"), std::string::npos) << message;
+    EXPECT_NE(message.find("on_exit callback 'leave_closed' of state 'closed'"), std::string::npos) << message;
+    EXPECT_NE(message.find("on_enter callback 'enter_open' of state 'open'"), std::string::npos) << message;
+    EXPECT_NE(message.find("Guard 'can_open' of transition 'closed' -> 'open' on 'push'"), std::string::npos)
+        << message;
+    EXPECT_NE(message.find("on_transition callback 'opening'"), std::string::npos) << message;
+  }
+
+  registerAll(*fsm, target);
+  EXPECT_NO_THROW(fsm->bind());
+  EXPECT_FALSE(fsm->isSealed());
+}
+
+TEST_F(StateMachineTest, SealedMachineRunsBoundCallbacks) {
+  fsm = std::make_unique<StateMachine>(kBindConfig, true);
+  BindTarget target;
+  registerAll(*fsm, target);
+  fsm->seal();
+  EXPECT_TRUE(fsm->isSealed());
+
+  fsm->start();
+  EXPECT_EQ(target.calls, 1);  // log
+  fsm->triggerEvent("push");
+  EXPECT_EQ(fsm->getCurrentState(), "open");
+  EXPECT_EQ(target.calls, 5);  // guard, on_exit, on_transition, on_enter
+}
+
+TEST_F(StateMachineTest, FailedSealLeavesMachineUnsealed) {
+  fsm = std::make_unique<StateMachine>(kBindConfig, true);
+
+  EXPECT_THROW(fsm->seal(), StateException);
+  EXPECT_FALSE(fsm->isSealed());
+}
+
+TEST_F(StateMachineTest, SealedMachineRejectsRegistration) {
+  fsm = std::make_unique<StateMachine>(kBindConfig, true);
+  BindTarget target;
+  registerAll(*fsm, target);
+  fsm->seal();
+
+  EXPECT_THROW(fsm->registerAction("log", &BindTarget::onCall, &target), StateException);
+  EXPECT_THROW(fsm->registerStateCallback("open", "on_exit", &BindTarget::onCall, &target), StateException);
+}
+
+TEST_F(StateMachineTest, SealedMachineRejectsDefinitionWithUnboundCallbacks) {
+  fsm = std::make_unique<StateMachine>(kBindConfig, true);
+  BindTarget target;
+  registerAll(*fsm, target);
+  fsm->seal();
+  fsm->start();
+
+  EXPECT_THROW(fsm->reloadFromString(R"(
+states:
+  closed:
+    actions:
+      - unknown
+)"),
+               StateException);
+  EXPECT_NO_THROW(fsm->reloadFromString(R"(
+states:
+  closed:
+    actions:
+      - log
+)"));
+
+  std::vector<std::string> errors;
+  fsm->setErrorHandler([&errors](const std::string& error) { errors.push_back(error); });
+  fsm->scheduleDefinition(MachineDefinition::fromString(R"(
+states:
+  closed:
+    on_enter: unknown
+)"));
+  fsm->triggerEvent("push");
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors.front(), "on_enter callback 'unknown' of state 'closed' is not registered");
+}
+
+TEST_F(StateMachineTest, StrandModeSerializesConcurrentEvents) {
+  fsm = std::make_unique<StateMachine>(R"(
+states:
+  off:
+    actions:
+      - count
+  on:
+    actions:
+      - count
+
+transitions:
+  - from: off
+    to: on
+    event: toggle
+  - from: on
+    to: off
+    event: toggle
+)",
+                                       true);
+
+  class Counter {
+   public:
+    int count{};  // NOLINT(cppcoreguidelines-use-default-member-init) - Test helper class
+    std::atomic<bool> inside{false};
+    std::atomic<bool> overlapped{false};
+    Counter() = default;
+    void onCount() {
+      if (inside.exchange(true)) {
+        overlapped = true;
+      }
+      ++count;
+      inside = false;
+    }
+  };
+
+  Counter counter;
+  fsm->registerAction("count", &Counter::onCount, &counter);
+  fsm->setStrandMode(true);
+  EXPECT_TRUE(fsm->isStrandMode());
+  fsm->start();
+
+  constexpr int kThreads = 8;
+  constexpr int kEventsPerThread = 1000;
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([this] {
+        for (int i = 0; i < kEventsPerThread; ++i) {
+          fsm->triggerEvent("toggle");
+        }
+      });
+    }
+  }
+
+  // Every caller has returned, so the last one to own the strand has drained it
+  EXPECT_EQ(counter.count, kThreads * kEventsPerThread + 1);
+  EXPECT_FALSE(counter.overlapped);
+  EXPECT_EQ(fsm->getCurrentState(), "off");
+}
+
+TEST_F(StateMachineTest, StrandModeRunsReentrantEventsAfterCurrentOne) {
+  const std::string yaml_content = R"(
+states:
+  a:
+  b:
+    on_enter: enter_b
+    actions:
+      - b_action
+  c:
+    on_enter: enter_c
+
+transitions:
+  - from: a
+    to: b
+    event: go
+  - from: b
+    to: c
+    event: next
+)";
+
+  class Recorder {
+   public:
+    StateMachine* machine{};  // NOLINT(cppcoreguidelines-use-default-member-init) - Test helper class
+    std::vector<std::string> log;
+    Recorder() = default;
+    void onEnterB() {
+      log.emplace_back("enter b");
+      machine->triggerEvent("next");
+    }
+    void onBAction() { log.emplace_back("b action"); }
+    void onEnterC() { log.emplace_back("enter c"); }
+  };
+
+  const auto run = [&yaml_content](bool strand) {
+    StateMachine machine(yaml_content, true);
+    Recorder recorder;
+    recorder.machine = &machine;
+    machine.registerStateCallback("b", "on_enter", &Recorder::onEnterB, &recorder);
+    machine.registerStateCallback("c", "on_enter", &Recorder::onEnterC, &recorder);
+    machine.registerAction("b_action", &Recorder::onBAction, &recorder);
+    machine.setStrandMode(strand);
+    machine.start();
+    machine.triggerEvent("go");
+    EXPECT_EQ(machine.getCurrentState(), "c");
+    return recorder.log;
+  };
+
+  EXPECT_EQ(run(false), (std::vector<std::string>{"enter b", "enter c", "b action"}));
+  EXPECT_EQ(run(true), (std::vector<std::string>{"enter b", "b action", "enter c"}));
+}
+
+TEST_F(StateMachineTest, StrandModeReportsErrorsInsteadOfThrowing) {
+  fsm = std::make_unique<StateMachine>(kBindConfig, true);
+  fsm->setStrandMode(true);
+
+  std::vector<std::string> errors;
+  fsm->setErrorHandler([&errors](const std::string& error) { errors.push_back(error); });
+
+  EXPECT_NO_THROW(fsm->triggerEvent("push"));
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors.front(), "StateMachine is not started");
+}
+
+const char* const kBatchConfig = R"(
+initial_state: idle
+
+states:
+  idle:
+  running:
+  done:
+
+transitions:
+  - from: idle
+    to: running
+    event: go
+  - from: running
+    to: done
+    event: finish
+    guard: can_finish
+  - from: running
+    to: idle
+    event: abort
+    on_transition: on_abort
+  - from: done
+    to: idle
+    event: go
+)";
+
+class BatchTarget {
+ public:
+  bool allow_finish = false;      // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes) - Test helper
+  int entered = 0;                // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes) - Test helper
+  StateMachine* stop = nullptr;   // NOLINT(cppcoreguidelines-non-private-member-variables-in-classes) - Test helper
+  bool canFinish() { return allow_finish; }  // NOLINT(readability-make-member-function-const) - Callback signature
+  void onAbort(const TransitionEvent& /*event*/) { throw std::runtime_error("abort failed"); }
+  void onEnterRunning() {
+    ++entered;
+    if (stop != nullptr) {
+      stop->stop();
+    }
+  }
+};
+
+TEST_F(StateMachineTest, TriggerEventsReportsOutcomes) {
+  fsm = std::make_unique<StateMachine>(kBatchConfig, true);
+  BatchTarget target;
+  fsm->registerGuard("running", "done", "finish", &BatchTarget::canFinish, &target);
+
+  fsm->registerStateCallback("running", "on_enter", &BatchTarget::onEnterRunning, &target);
+  fsm->start();
+
+  const std::map<std::string, VariableValue> data{{"attempt", VariableValue(1)}};
+  const std::vector<EventRef> events = {{"go", &data}, {"unknown"}, {"finish"}, {"go"}};
+  std::vector<EventOutcome> outcomes(events.size());
+
+  EXPECT_EQ(fsm->triggerEvents(events, outcomes), 1);
+  EXPECT_EQ(outcomes, (std::vector<EventOutcome>{EventOutcome::TRANSITIONED, EventOutcome::IGNORED,
+                                                 EventOutcome::GUARD_REJECTED, EventOutcome::IGNORED}));
+  EXPECT_EQ(fsm->getCurrentState(), "running");
+
+  target.allow_finish = true;
+  EXPECT_EQ(fsm->triggerEvents(std::vector<EventRef>{{"finish"}, {"go"}, {"go"}}), 3);
+  EXPECT_EQ(fsm->getCurrentState(), "running");
+  EXPECT_EQ(target.entered, 2);
+}
+
+TEST_F(StateMachineTest, TriggerEventsContinuesAfterFailure) {
+  fsm = std::make_unique<StateMachine>(kBatchConfig, true);
+  BatchTarget target;
+  fsm->registerTransitionCallback("running", "idle", &BatchTarget::onAbort, &target);
+
+  std::vector<std::string> errors;
+  fsm->setErrorHandler([&errors](const std::string& error) { errors.push_back(error); });
+  fsm->start();
+
+  const std::vector<EventRef> events = {{"go"}, {"abort"}, {"go"}};
+  std::vector<EventOutcome> outcomes(events.size());
+  EXPECT_EQ(fsm->triggerEvents(events, outcomes), 1);
+  EXPECT_EQ(outcomes[1], EventOutcome::FAILED);
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors.front(), "abort failed");
+
+  // The failed transition threw before switching state
+  EXPECT_EQ(outcomes[2], EventOutcome::IGNORED);
+  EXPECT_EQ(fsm->getCurrentState(), "running");
+}
+
+TEST_F(StateMachineTest, TriggerEventsValidatesArguments) {
+  fsm = std::make_unique<StateMachine>(kBatchConfig, true);
+  const std::vector<EventRef> events = {{"go"}, {"go"}};
+  EXPECT_THROW(fsm->triggerEvents(events), StateException);
+
+  fsm->start();
+  std::vector<EventOutcome> outcomes(1);
+  EXPECT_THROW(fsm->triggerEvents(events, outcomes), StateException);
+  EXPECT_EQ(fsm->getCurrentState(), "idle");
+}
+
+TEST_F(StateMachineTest, TriggerEventsStopsWhenCallbackStopsMachine) {
+  fsm = std::make_unique<StateMachine>(kBatchConfig, true);
+  BatchTarget target;
+  target.stop = fsm.get();
+  fsm->registerStateCallback("running", "on_enter", &BatchTarget::onEnterRunning, &target);
+  fsm->start();
+
+  const std::vector<EventRef> events = {{"go"}, {"finish"}, {"abort"}};
+  std::vector<EventOutcome> outcomes(events.size());
+  EXPECT_EQ(fsm->triggerEvents(events, outcomes), 1);
+  EXPECT_EQ(outcomes, (std::vector<EventOutcome>{EventOutcome::TRANSITIONED, EventOutcome::FAILED,
+                                                 EventOutcome::FAILED}));
+}
+
+TEST_F(StateMachineTest, TriggerEventsInStrandMode) {
+  fsm = std::make_unique<StateMachine>(kBatchConfig, true);
+  fsm->setStrandMode(true);
+  fsm->start();
+
+  const std::vector<EventRef> events = {{"go"}, {"abort"}, {"go"}};
+  std::vector<EventOutcome> outcomes(events.size());
+  EXPECT_EQ(fsm->triggerEvents(events, outcomes), 3);
+  EXPECT_EQ(outcomes[2], EventOutcome::TRANSITIONED);
+  EXPECT_EQ(fsm->getCurrentState(), "running");
+}
+
+TEST_F(StateMachineTest, TriggerEventsInStrandModeOnStoppedMachine) {
+  fsm = std::make_unique<StateMachine>(kBatchConfig, true);
+  fsm->setStrandMode(true);
+  std::vector<std::string> errors;
+  fsm->setErrorHandler([&errors](const std::string& error) { errors.push_back(error); });
+  fsm->start();
+  fsm->stop();
+
+  const std::vector<EventRef> events = {{"go"}, {"abort"}};
+  std::vector<EventOutcome> outcomes(events.size(), EventOutcome::TRANSITIONED);
+  EXPECT_EQ(fsm->triggerEvents(events, outcomes), 0);
+  EXPECT_EQ(outcomes, (std::vector<EventOutcome>{EventOutcome::FAILED, EventOutcome::FAILED}));
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors.front(), "StateMachine is not started");
+}
+
+TEST_F(StateMachineTest, RestoreResumesSavedStateWithoutCallbacks) {
+  const auto definition = MachineDefinition::fromString(kBatchConfig);
+  StateMachine original(definition);
+  original.setVariable("mode", VariableValue(std::string("fast")));
+  original.start();
+  original.triggerEvent("go");
+  original.setVariable("retries", VariableValue(3));
+  const std::string snapshot = original.snapshot();
+
+  fsm = std::make_unique<StateMachine>(definition);
+  BatchTarget target;
+  fsm->registerStateCallback("running", "on_enter", &BatchTarget::onEnterRunning, &target);
+  fsm->restore(snapshot);
+
+  EXPECT_EQ(fsm->getCurrentState(), "running");
+  EXPECT_EQ(target.entered, 0);
+  EXPECT_EQ(fsm->getVariable("retries").asInt(), 3);
+  EXPECT_EQ(fsm->getVariable("mode").asString(), "fast");
+
+  // Restored as started: events flow and start() is rejected
+  EXPECT_THROW(fsm->start(), StateException);
+  fsm->triggerEvent("abort");
+  EXPECT_EQ(fsm->getCurrentState(), "idle");
+
+  // A snapshot of a machine that was never started restores to one that can start
+  const StateMachine fresh(definition);
+  fsm->restore(fresh.snapshot());
+  EXPECT_EQ(fsm->getCurrentState(), "");
+  EXPECT_FALSE(fsm->hasVariable("retries"));
+  fsm->start();
+  EXPECT_EQ(fsm->getCurrentState(), "idle");
+}
+
+TEST_F(StateMachineTest, RestoreRejectsInvalidSnapshots) {
+  fsm = std::make_unique<StateMachine>(kBatchConfig, true);
+  std::vector<std::string> errors;
+  fsm->setErrorHandler([&errors](const std::string& error) { errors.push_back(error); });
+  fsm->start();
+
+  StateMachine other(R"(
+states:
+  idle:
+  busy:
+)",
+                     true);
+  other.start();
+  const std::string foreign = other.snapshot();
+  EXPECT_THROW(fsm->restore(foreign), StateException);
+  EXPECT_THROW(fsm->restore(foreign.substr(0, foreign.size() - 1)), StateException);
+  EXPECT_THROW(fsm->restore("not a snapshot"), StateException);
+  EXPECT_EQ(errors.size(), 3);
+
+  const std::string own = fsm->snapshot();
+  EXPECT_THROW(fsm->restore(own + "x"), StateException);
+  EXPECT_EQ(fsm->getCurrentState(), "idle");
+}
+
+TEST_F(StateMachineTest, RestoreAllRestoresEveryMachineOrNone) {
+  const auto definition = MachineDefinition::fromString(kBatchConfig);
+  std::vector<std::unique_ptr<StateMachine>> machines;
+  for (int i = 0; i < 3; ++i) {
+    machines.push_back(std::make_unique<StateMachine>(definition));
+    machines.back()->start();
+    machines.back()->setVariable("index", VariableValue(i));
+  }
+  machines[1]->triggerEvent("go");
+  const std::string snapshot = StateMachine::snapshotAll(
+      std::vector<const StateMachine*>{machines[0].get(), machines[1].get(), machines[2].get()});
+
+  std::vector<std::unique_ptr<StateMachine>> restored;
+  std::vector<StateMachine*> targets;
+  for (int i = 0; i < 3; ++i) {
+    restored.push_back(std::make_unique<StateMachine>(definition));
+    targets.push_back(restored.back().get());
+  }
+  EXPECT_THROW(StateMachine::restoreAll(std::span<StateMachine* const>(targets).first(2), snapshot), StateException);
+
+  StateMachine::restoreAll(targets, snapshot);
+  EXPECT_EQ(restored[0]->getCurrentState(), "idle");
+  EXPECT_EQ(restored[1]->getCurrentState(), "running");
+  EXPECT_EQ(restored[2]->getVariable("index").asInt(), 2);
+  EXPECT_FALSE(restored[1]->hasVariable("index"));
+
+  // The second record belongs to other states: the first machine is not touched either
+  StateMachine other("states:\n  only:\n", true);
+  const std::string mixed =
+      StateMachine::snapshotAll(std::vector<const StateMachine*>{machines[1].get(), &other});
+  EXPECT_THROW(StateMachine::restoreAll(std::span<StateMachine* const>(targets).first(2), mixed), StateException);
+  EXPECT_EQ(restored[0]->getCurrentState(), "idle");
+}
+
 TEST_F(StateMachineTest, TransitionCallbackIsExecuted) {
   const std::string yaml_content = R"(
 states:
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fsmconfig/static_state_machine.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_static_state_machine.cpp
+ * @brief Tests for StaticStateMachine
+ */
+
+namespace {
+
+/// Turnstile definition: states, events and compile-time transition table
+struct TurnstileDef {
+  enum class State : std::uint8_t { locked, unlocked, broken };
+  enum class Event : std::uint8_t { coin, push, kick };
+
+  struct CoinValid {};
+  struct CountCoin {};
+  struct Alarm {};
+
+  static constexpr State initial_state = State::locked;
+  static constexpr std::array<std::string_view, 3> state_names = {"locked", "unlocked", "broken"};
+  static constexpr std::array<std::string_view, 3> event_names = {"coin", "push", "kick"};
+
+  using transitions =
+      StaticTransitionTable<StaticTransition<State::locked, Event::coin, State::unlocked, CoinValid, CountCoin>,
+                            StaticTransition<State::unlocked, Event::push, State::locked>,
+                            StaticTransition<State::locked, Event::kick, State::broken, void, Alarm>>;
+};
+
+/// Handler recording hook calls
+struct TurnstileHandler {
+  std::vector<std::string> calls;
+  bool accept = true;
+
+  bool guard(TurnstileDef::CoinValid /*tag*/) {
+    calls.emplace_back("guard");
+    return accept;
+  }
+  void action(TurnstileDef::CountCoin /*tag*/) { calls.emplace_back("count_coin"); }
+  void action(TurnstileDef::Alarm /*tag*/) { calls.emplace_back("alarm"); }
+  void onEnter(TurnstileDef::State state) { calls.push_back("enter:" + name(state)); }
+  void onExit(TurnstileDef::State state) { calls.push_back("exit:" + name(state)); }
+
+  static std::string name(TurnstileDef::State state) {
+    return std::string(TurnstileDef::state_names[static_cast<size_t>(state)]);
+  }
+};
+
+/// Handler without optional enter/exit hooks
+struct MinimalHandler {
+  bool guard(TurnstileDef::CoinValid /*tag*/) { return true; }
+  void action(TurnstileDef::CountCoin /*tag*/) {}
+  void action(TurnstileDef::Alarm /*tag*/) {}
+};
+
+class RecordingObserver : public StateObserver {
+ public:
+  std::vector<std::string> events;  // NOLINT(misc-non-private-member-variables-in-classes)
+
+  void onStateEnter(const std::string& state_name) override { events.push_back("enter:" + state_name); }
+  void onStateExit(const std::string& state_name) override { events.push_back("exit:" + state_name); }
+  void onTransition(const TransitionEvent& event) override {
+    events.push_back("transition:" + event.from_state + "->" + event.to_state + ":" + event.event_name);
+  }
+  void onError(const std::string& error_message) override { events.push_back("error:" + error_message); }
+};
+
+using Turnstile = StaticStateMachine<TurnstileDef, TurnstileHandler>;
+
+}  // namespace
+
+TEST(StaticStateMachineTest, StartEntersInitialState) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+
+  EXPECT_EQ(fsm.getCurrentStateName(), "");
+  fsm.start();
+
+  EXPECT_TRUE(fsm.isStarted());
+  EXPECT_EQ(fsm.getCurrentState(), TurnstileDef::State::locked);
+  EXPECT_EQ(fsm.getCurrentStateName(), "locked");
+  EXPECT_EQ(handler.calls, (std::vector<std::string>{"enter:locked"}));
+}
+
+TEST(StaticStateMachineTest, StartTwiceThrows) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+  fsm.start();
+
+  EXPECT_THROW(fsm.start(), StateException);
+}
+
+TEST(StaticStateMachineTest, TriggerBeforeStartThrows) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+  std::string reported;
+  fsm.setErrorHandler([&reported](const std::string& error) { reported = error; });
+
+  EXPECT_THROW(fsm.triggerEvent(TurnstileDef::Event::coin), StateException);
+  EXPECT_EQ(reported, "StateMachine is not started");
+}
+
+TEST(StaticStateMachineTest, TransitionRunsHooksInOrder) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+  fsm.start();
+  handler.calls.clear();
+
+  EXPECT_TRUE(fsm.triggerEvent(TurnstileDef::Event::coin));
+
+  EXPECT_EQ(fsm.getCurrentState(), TurnstileDef::State::unlocked);
+  EXPECT_EQ(handler.calls, (std::vector<std::string>{"guard", "exit:locked", "count_coin", "enter:unlocked"}));
+}
+
+TEST(StaticStateMachineTest, GuardRejectsTransition) {
+  TurnstileHandler handler;
+  handler.accept = false;
+  Turnstile fsm(handler);
+  fsm.start();
+
+  EXPECT_FALSE(fsm.triggerEvent(TurnstileDef::Event::coin));
+  EXPECT_EQ(fsm.getCurrentState(), TurnstileDef::State::locked);
+}
+
+TEST(StaticStateMachineTest, EventWithoutTransitionIsIgnored) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+  fsm.start();
+
+  EXPECT_FALSE(fsm.triggerEvent(TurnstileDef::Event::push));
+  EXPECT_EQ(fsm.getCurrentState(), TurnstileDef::State::locked);
+}
+
+TEST(StaticStateMachineTest, TriggerEventByName) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+  fsm.start();
+
+  EXPECT_TRUE(fsm.triggerEvent(std::string_view("kick")));
+  EXPECT_EQ(fsm.getCurrentStateName(), "broken");
+  EXPECT_FALSE(fsm.triggerEvent(std::string_view("unknown")));
+}
+
+TEST(StaticStateMachineTest, OptionalHooksMayBeOmitted) {
+  MinimalHandler handler;
+  StaticStateMachine<TurnstileDef, MinimalHandler> fsm(handler);
+  fsm.start();
+
+  EXPECT_TRUE(fsm.triggerEvent(TurnstileDef::Event::coin));
+  EXPECT_TRUE(fsm.triggerEvent(TurnstileDef::Event::push));
+  EXPECT_EQ(fsm.getCurrentState(), TurnstileDef::State::locked);
+}
+
+TEST(StaticStateMachineTest, ObserversReceiveStateNames) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+  auto observer = std::make_shared<RecordingObserver>();
+  fsm.registerStateObserver(observer);
+  fsm.registerStateObserver(observer);  // Duplicate registration is ignored
+
+  fsm.start();
+  fsm.triggerEvent(TurnstileDef::Event::coin);
+
+  EXPECT_EQ(observer->events, (std::vector<std::string>{"enter:locked", "exit:locked", "enter:unlocked",
+                                                        "transition:locked->unlocked:coin"}));
+
+  fsm.unregisterStateObserver(observer);
+  fsm.triggerEvent(TurnstileDef::Event::push);
+  EXPECT_EQ(observer->events.size(), 4);
+}
+
+TEST(StaticStateMachineTest, VariablesFollowStateMachineScoping) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+
+  fsm.setVariable("coins", VariableValue(0));
+  fsm.start();
+  fsm.setVariable("local", VariableValue(true));
+
+  EXPECT_EQ(fsm.getVariable("coins").asInt(), 0);
+  EXPECT_TRUE(fsm.getVariable("local").asBool());
+
+  fsm.triggerEvent(TurnstileDef::Event::coin);
+
+  EXPECT_TRUE(fsm.hasVariable("coins"));
+  EXPECT_FALSE(fsm.hasVariable("local"));
+  EXPECT_THROW(static_cast<void>(fsm.getVariable("local")), StateException);
+}
+
+TEST(StaticStateMachineTest, StopAndReset) {
+  TurnstileHandler handler;
+  Turnstile fsm(handler);
+  fsm.start();
+  fsm.triggerEvent(TurnstileDef::Event::coin);
+  handler.calls.clear();
+
+  fsm.reset();
+
+  EXPECT_FALSE(fsm.isStarted());
+  EXPECT_EQ(fsm.getCurrentStateName(), "");
+  EXPECT_EQ(handler.calls, (std::vector<std::string>{"exit:unlocked"}));
+  EXPECT_THROW(fsm.stop(), StateException);
+}
+
+TEST(StaticStateMachineTest, NamesAreConstexpr) {
+  static_assert(Turnstile::stateName(TurnstileDef::State::broken) == "broken");
+  static_assert(Turnstile::eventName(TurnstileDef::Event::push) == "push");
+  static_assert(TurnstileDef::transitions::size == 3);
+  SUCCEED();
+}
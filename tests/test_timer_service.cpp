@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fsmconfig/state_machine.hpp>
+#include <fsmconfig/timer_service.hpp>
+#include <fsmconfig/types.hpp>
+
+using namespace fsmconfig;
+using std::chrono::milliseconds;
+
+/**
+ * @file test_timer_service.cpp
+ * @brief Tests for TimerService and timeout ('after') transitions
+ */
+
+namespace {
+
+const char* const kTimeoutConfig = R"(
+initial_state: idle
+
+states:
+  idle:
+  busy:
+  expired:
+
+transitions:
+  - from: idle
+    to: expired
+    after: 100ms
+  - from: idle
+    to: busy
+    event: go
+  - from: busy
+    to: idle
+    event: back
+  - from: busy
+    to: expired
+    event: give_up
+    after: 1s
+)";
+
+/**
+ * @brief Observer waiting for a state entered on another thread
+ */
+class StateWaiter : public StateObserver {
+ public:
+  void onStateEnter(const std::string& state_name) override {
+    const std::scoped_lock lock(mutex_);
+    state_ = state_name;
+    changed_.notify_all();
+  }
+  void onStateExit(const std::string& /*state_name*/) override {}
+  void onTransition(const TransitionEvent& /*event*/) override {}
+  void onError(const std::string& /*error_message*/) override {}
+
+  bool waitFor(const std::string& state_name) {
+    std::unique_lock lock(mutex_);
+    return changed_.wait_for(lock, std::chrono::seconds(5), [&] { return state_ == state_name; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::string state_;
+};
+
+}  // namespace
+
+TEST(TimerServiceTest, FiresAfterDelay) {
+  TimerService timers;
+  int fired = 0;
+  timers.schedule(milliseconds(5), [&fired] { ++fired; });
+  EXPECT_EQ(timers.getPendingCount(), 1);
+
+  EXPECT_EQ(timers.advance(milliseconds(4)), 0);
+  EXPECT_EQ(fired, 0);
+  EXPECT_EQ(timers.advance(milliseconds(1)), 1);
+  EXPECT_EQ(fired, 1);
+  EXPECT_EQ(timers.getPendingCount(), 0);
+}
+
+TEST(TimerServiceTest, DelaysRoundUpToWholeTicks) {
+  TimerService timers(milliseconds(10));
+  EXPECT_EQ(timers.getTick(), milliseconds(10));
+
+  int fired = 0;
+  timers.schedule(milliseconds(15), [&fired] { ++fired; });
+  timers.advance(milliseconds(10));
+  EXPECT_EQ(fired, 0);
+
+  // Remainders below one tick are carried over
+  timers.advance(milliseconds(5));
+  EXPECT_EQ(fired, 0);
+  timers.advance(milliseconds(5));
+  EXPECT_EQ(fired, 1);
+
+  EXPECT_THROW(TimerService(milliseconds(0)), StateException);
+}
+
+TEST(TimerServiceTest, CancelPreventsFiring) {
+  TimerService timers;
+  int fired = 0;
+  const TimerId id = timers.schedule(milliseconds(10), [&fired] { ++fired; });
+  const TimerId other = timers.schedule(milliseconds(10), [&fired] { fired += 10; });
+
+  EXPECT_TRUE(timers.cancel(id));
+  EXPECT_FALSE(timers.cancel(id));
+  EXPECT_FALSE(timers.cancel(INVALID_TIMER));
+  timers.advance(milliseconds(10));
+
+  EXPECT_EQ(fired, 10);
+  EXPECT_FALSE(timers.cancel(other));
+}
+
+TEST(TimerServiceTest, TimersFireInDeadlineOrderAcrossLevels) {
+  TimerService timers;
+  std::vector<int64_t> order;
+  const std::vector<int64_t> delays = {70'000'000, 3, 300, 255, 256, 20'000, 1'000'000, 16'384, 3, 5'000'000'000};
+  for (const int64_t delay : delays) {
+    timers.schedule(milliseconds(delay), [&order, delay] { order.push_back(delay); });
+  }
+
+  timers.advance(milliseconds(5'000'000'000 - 1));
+  EXPECT_EQ(order.size(), delays.size() - 1);
+  timers.advance(milliseconds(1));
+
+  auto expected = delays;
+  std::stable_sort(expected.begin(), expected.end());
+  EXPECT_EQ(order, expected);
+}
+
+TEST(TimerServiceTest, CallbacksCanScheduleAndCancel) {
+  TimerService timers;
+  std::vector<std::string> fired;
+  TimerId victim = INVALID_TIMER;
+
+  timers.schedule(milliseconds(1), [&] {
+    fired.emplace_back("first");
+    timers.schedule(milliseconds(1), [&fired] { fired.emplace_back("rescheduled"); });
+    EXPECT_TRUE(timers.cancel(victim));
+  });
+  victim = timers.schedule(milliseconds(2), [&fired] { fired.emplace_back("victim"); });
+
+  EXPECT_EQ(timers.advance(milliseconds(5)), 2);
+  EXPECT_EQ(fired, (std::vector<std::string>{"first", "rescheduled"}));
+}
+
+TEST(TimerServiceTest, BackgroundThreadFiresTimers) {
+  TimerService timers;
+  timers.start();
+  EXPECT_TRUE(timers.isRunning());
+  EXPECT_THROW(timers.advance(milliseconds(1)), StateException);
+
+  std::mutex mutex;
+  std::condition_variable done;
+  int fired = 0;
+  for (int delay : {5, 1, 20}) {
+    timers.schedule(milliseconds(delay), [&] {
+      const std::scoped_lock lock(mutex);
+      ++fired;
+      done.notify_all();
+    });
+  }
+
+  std::unique_lock lock(mutex);
+  EXPECT_TRUE(done.wait_for(lock, std::chrono::seconds(5), [&fired] { return fired == 3; }));
+  lock.unlock();
+
+  timers.stop();
+  EXPECT_FALSE(timers.isRunning());
+}
+
+TEST(TimeoutTransitionTest, TimeoutFiresTransition) {
+  TimerService timers;
+  StateMachine machine(kTimeoutConfig, true);
+  machine.setTimerService(&timers);
+  machine.start();
+  EXPECT_EQ(timers.getPendingCount(), 1);
+
+  timers.advance(milliseconds(99));
+  EXPECT_EQ(machine.getCurrentState(), "idle");
+  timers.advance(milliseconds(1));
+  EXPECT_EQ(machine.getCurrentState(), "expired");
+  EXPECT_EQ(timers.getPendingCount(), 0);
+}
+
+TEST(TimeoutTransitionTest, LeavingStateCancelsTimeout) {
+  TimerService timers;
+  StateMachine machine(kTimeoutConfig, true);
+  machine.setTimerService(&timers);
+  machine.start();
+
+  timers.advance(milliseconds(50));
+  machine.triggerEvent("go");
+  timers.advance(milliseconds(100));
+  EXPECT_EQ(machine.getCurrentState(), "busy");
+
+  // Re-entering the state restarts its timeout
+  machine.triggerEvent("back");
+  timers.advance(milliseconds(99));
+  EXPECT_EQ(machine.getCurrentState(), "idle");
+  timers.advance(milliseconds(1));
+  EXPECT_EQ(machine.getCurrentState(), "expired");
+}
+
+TEST(TimeoutTransitionTest, NamedTimeoutCanAlsoBeTriggered) {
+  TimerService timers;
+  StateMachine machine(kTimeoutConfig, true);
+  machine.setTimerService(&timers);
+  machine.start();
+  machine.triggerEvent("go");
+
+  machine.triggerEvent("give_up");
+  EXPECT_EQ(machine.getCurrentState(), "expired");
+  EXPECT_EQ(timers.getPendingCount(), 0);
+
+  machine.reset();
+  machine.start();
+  machine.triggerEvent("go");
+  timers.advance(milliseconds(1000));
+  EXPECT_EQ(machine.getCurrentState(), "expired");
+}
+
+TEST(TimeoutTransitionTest, StopAndDestructionCancelTimeouts) {
+  TimerService timers;
+  {
+    StateMachine machine(kTimeoutConfig, true);
+    machine.setTimerService(&timers);
+    machine.start();
+    machine.stop();
+    EXPECT_EQ(timers.getPendingCount(), 0);
+
+    machine.start();
+    EXPECT_EQ(timers.getPendingCount(), 1);
+  }
+  EXPECT_EQ(timers.getPendingCount(), 0);
+  EXPECT_EQ(timers.advance(milliseconds(100)), 0);
+}
+
+TEST(TimeoutTransitionTest, MovedMachineKeepsItsTimeouts) {
+  TimerService timers;
+  StateMachine original(kTimeoutConfig, true);
+  original.setTimerService(&timers);
+  original.start();
+
+  StateMachine moved(std::move(original));
+  timers.advance(milliseconds(100));
+  EXPECT_EQ(moved.getCurrentState(), "expired");
+}
+
+TEST(TimeoutTransitionTest, BackgroundThreadWithStrandMode) {
+  TimerService timers;
+  StateMachine machine(kTimeoutConfig, true);
+  machine.setStrandMode(true);
+  machine.setTimerService(&timers);
+
+  auto waiter = std::make_shared<StateWaiter>();
+  machine.registerStateObserver(waiter);
+
+  timers.start();
+  machine.start();
+  EXPECT_TRUE(waiter->waitFor("expired"));
+  timers.stop();
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <fsmconfig/state_machine.hpp>
+#include <fsmconfig/tracer.hpp>
+
+using namespace fsmconfig;
+
+/**
+ * @file test_tracer.cpp
+ * @brief Tests for Tracer
+ */
+
+class TracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Tracer::clear();
+    Tracer::enable();
+  }
+
+  void TearDown() override {
+    Tracer::disable();
+    Tracer::clear();
+  }
+};
+
+TEST_F(TracerTest, RecordsBeginAndEnd) {
+  {
+    const TraceSpan span("test.span");
+  }
+
+  EXPECT_EQ(Tracer::getRecordCount(), 2);
+
+  const std::string json = Tracer::toChromeTrace();
+  EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"test.span\""), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"B\""), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"E\""), std::string::npos);
+}
+
+TEST_F(TracerTest, DisabledRecordsNothing) {
+  Tracer::disable();
+  {
+    const TraceSpan span("test.disabled");
+  }
+
+  EXPECT_FALSE(Tracer::isEnabled());
+  EXPECT_EQ(Tracer::getRecordCount(), 0);
+  EXPECT_EQ(Tracer::toChromeTrace().find("test.disabled"), std::string::npos);
+}
+
+TEST_F(TracerTest, ClearDiscardsRecords) {
+  Tracer::beginSpan("test.clear");
+  Tracer::endSpan("test.clear");
+  ASSERT_EQ(Tracer::getRecordCount(), 2);
+
+  Tracer::clear();
+
+  EXPECT_EQ(Tracer::getRecordCount(), 0);
+}
+
+TEST_F(TracerTest, ToggleDuringSpanKeepsSpansBalanced) {
+  std::thread worker([] {
+    {
+      // Begun while enabled: ended even though recording stops meanwhile
+      const TraceSpan span("test.disabled_inside");
+      Tracer::disable();
+    }
+    {
+      // Begun while disabled: no unmatched END once recording resumes
+      const TraceSpan span("test.enabled_inside");
+      Tracer::enable();
+    }
+  });
+  worker.join();
+
+  EXPECT_EQ(Tracer::getRecordCount(), 2);
+  EXPECT_EQ(Tracer::getDroppedCount(), 0);
+  EXPECT_EQ(Tracer::toChromeTrace().find("test.enabled_inside"), std::string::npos);
+}
+
+TEST_F(TracerTest, ClearDropsOpenSpans) {
+  Tracer::setBufferCapacity(4);
+  std::thread worker([] {
+    {
+      const TraceSpan span("test.open");
+      Tracer::clear();
+    }
+    // The reserved slot is released: a nested pair fits again
+    const TraceSpan outer("test.outer");
+    const TraceSpan inner("test.inner");
+  });
+  worker.join();
+  Tracer::setBufferCapacity(Tracer::DEFAULT_BUFFER_CAPACITY);
+
+  EXPECT_EQ(Tracer::getRecordCount(), 4);
+  EXPECT_EQ(Tracer::getDroppedCount(), 1);
+  EXPECT_EQ(Tracer::toChromeTrace().find("test.open"), std::string::npos);
+}
+
+TEST_F(TracerTest, SeparateThreadsUseSeparateBuffers) {
+  std::thread worker([] { const TraceSpan span("test.worker"); });
+  worker.join();
+  {
+    const TraceSpan span("test.main");
+  }
+
+  // Records of exited threads are kept
+  const std::string json = Tracer::toChromeTrace();
+  EXPECT_NE(json.find("test.worker"), std::string::npos);
+  EXPECT_NE(json.find("test.main"), std::string::npos);
+  EXPECT_EQ(Tracer::getRecordCount(), 4);
+}
+
+TEST_F(TracerTest, FullBufferDropsRecords) {
+  Tracer::setBufferCapacity(3);
+  std::thread worker([] {
+    for (int i = 0; i < 5; ++i) {
+      const TraceSpan span("test.overflow");
+    }
+  });
+  worker.join();
+  Tracer::setBufferCapacity(Tracer::DEFAULT_BUFFER_CAPACITY);
+
+  // Only the first span fits with its END; the others are dropped whole
+  EXPECT_EQ(Tracer::getRecordCount(), 2);
+  EXPECT_EQ(Tracer::getDroppedCount(), 8);
+}
+
+TEST_F(TracerTest, FullBufferKeepsSpansBalanced) {
+  Tracer::setBufferCapacity(4);
+  std::thread worker([] {
+    const TraceSpan outer("test.outer");
+    for (int i = 0; i < 3; ++i) {
+      const TraceSpan inner("test.inner");
+    }
+  });
+  worker.join();
+  Tracer::setBufferCapacity(Tracer::DEFAULT_BUFFER_CAPACITY);
+
+  // The slot reserved for the outer END is never taken by inner spans
+  EXPECT_EQ(Tracer::getRecordCount(), 4);
+  EXPECT_EQ(Tracer::getDroppedCount(), 4);
+  const std::string json = Tracer::toChromeTrace();
+  size_t begins = 0;
+  size_t ends = 0;
+  for (size_t pos = json.find("\"ph\":\"B\""); pos != std::string::npos; pos = json.find("\"ph\":\"B\"", pos + 1)) {
+    ++begins;
+  }
+  for (size_t pos = json.find("\"ph\":\"E\""); pos != std::string::npos; pos = json.find("\"ph\":\"E\"", pos + 1)) {
+    ++ends;
+  }
+  EXPECT_EQ(begins, 2);
+  EXPECT_EQ(ends, 2);
+}
+
+TEST_F(TracerTest, FailedBufferAllocationDropsRecords) {
+  // A buffer this large cannot be allocated; recording must count the loss instead of terminating
+  Tracer::setBufferCapacity(std::numeric_limits<size_t>::max() / 2);
+  std::thread worker([] { const TraceSpan span("test.unallocated"); });
+  worker.join();
+  Tracer::setBufferCapacity(Tracer::DEFAULT_BUFFER_CAPACITY);
+
+  EXPECT_EQ(Tracer::getRecordCount(), 0);
+  EXPECT_EQ(Tracer::getDroppedCount(), 2);
+}
+
+TEST_F(TracerTest, EscapesSpanNames) {
+  {
+    const TraceSpan span("quote\"back\\slash");
+  }
+
+  const std::string json = Tracer::toChromeTrace();
+  EXPECT_NE(json.find(R"("quote\"back\\slash")"), std::string::npos);
+}
+
+TEST_F(TracerTest, WriteToStream) {
+  {
+    const TraceSpan span("test.stream");
+  }
+
+  std::ostringstream out;
+  Tracer::writeChromeTrace(out);
+
+  EXPECT_EQ(out.str(), Tracer::toChromeTrace());
+  EXPECT_EQ(out.str().back(), '}');
+}
+
+#if defined(FSMCONFIG_ENABLE_TRACING)
+TEST_F(TracerTest, StateMachineTransitionPhases) {
+  const std::string yaml_content = R"(
+states:
+  idle:
+    on_exit: leave_idle
+  running:
+    actions:
+      - work
+transitions:
+  - from: idle
+    to: running
+    event: go
+)";
+
+  StateMachine fsm(yaml_content, true);
+  fsm.start();
+  Tracer::clear();
+
+  fsm.triggerEvent("go");
+
+  const std::string json = Tracer::toChromeTrace();
+  EXPECT_NE(json.find("fsm.transition"), std::string::npos);
+  EXPECT_NE(json.find("fsm.on_exit"), std::string::npos);
+  EXPECT_NE(json.find("fsm.state_actions"), std::string::npos);
+  EXPECT_NE(json.find("fsm.observers.transition"), std::string::npos);
+}
+#endif
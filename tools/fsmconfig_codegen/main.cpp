@@ -0,0 +1,72 @@
+#include <fsmconfig/codegen.hpp>
+#include <fsmconfig/config_parser.hpp>
+#include <fsmconfig/types.hpp>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace fsmconfig;
+
+/**
+ * @file main.cpp
+ * @brief Command line front end of the static state machine generator
+ *
+ * Usage: fsmconfig_codegen <config.yaml> <output.hpp> [--namespace <name>]
+ */
+
+namespace {
+
+void printUsage() {
+  std::cerr << "Usage: fsmconfig_codegen <config.yaml> <output.hpp> [--namespace <name>]\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::vector<std::string> args(argv + 1, argv + argc);
+
+  std::vector<std::string> positional;
+  CodegenOptions options;
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (args[i] == "--namespace" && i + 1 < args.size()) {
+      options.namespace_name = args[++i];
+    } else if (args[i] == "--help" || args[i] == "-h") {
+      printUsage();
+      return 0;
+    } else {
+      positional.push_back(args[i]);
+    }
+  }
+
+  if (positional.size() != 2) {
+    printUsage();
+    return 2;
+  }
+
+  const std::string& config_path = positional[0];
+  const std::string& output_path = positional[1];
+  options.source_name = config_path.substr(config_path.find_last_of("/\\") + 1);
+
+  try {
+    ConfigParser parser;
+    parser.loadFromFile(config_path);
+    const std::string header = generateStaticMachine(parser, options);
+
+    std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+      std::cerr << "fsmconfig_codegen: cannot open '" << output_path << "' for writing\n";
+      return 1;
+    }
+    output << header;
+    if (!output) {
+      std::cerr << "fsmconfig_codegen: failed to write '" << output_path << "'\n";
+      return 1;
+    }
+  } catch (const ConfigException& e) {
+    std::cerr << "fsmconfig_codegen: " << config_path << ": " << e.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}